@@ -0,0 +1,218 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+// Benchmark of the wire format of the shared clauses. The input is a stream
+// of clauses in the dimacs format, e.g. learnt clauses recorded during a
+// run; a comment "c lbd <INT>" gives the LBD of the next clause, the LBD is
+// the size otherwise. The stream is cut in batches, each batch is encoded
+// and decoded in a loop.
+
+#include "clauses/ClauseCodec.h"
+#include "clauses/ClauseManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+// Read the clauses of a dimacs stream
+static bool readClauses(const char * filename,
+                        vector<ClauseExchange *> & clauses)
+{
+   FILE * in = fopen(filename, "r");
+
+   if (in == NULL)
+      return false;
+
+   char line[1 << 16];
+   int lbd = 0;
+
+   vector<int> lits;
+
+   while (fgets(line, sizeof(line), in) != NULL) {
+      if (line[0] == 'c') {
+         sscanf(line, "c lbd %d", &lbd);
+         continue;
+      }
+
+      if (line[0] == 'p')
+         continue;
+
+      char * p = line;
+      char * end;
+
+      for (long lit = strtol(p, &end, 10); p != end;
+           lit = strtol(p, &end, 10)) {
+         p = end;
+
+         if (lit != 0) {
+            lits.push_back(lit);
+            continue;
+         }
+
+         ClauseExchange * cls = ClauseManager::allocClause(lits.size());
+
+         cls->lbd  = lbd > 0 ? lbd : lits.size();
+         cls->from = 0;
+         memcpy(cls->lits, lits.data(), sizeof(int) * lits.size());
+
+         clauses.push_back(cls);
+
+         lits.clear();
+         lbd = 0;
+      }
+   }
+
+   fclose(in);
+
+   return true;
+}
+
+// Return true if two batches hold the same clauses
+static bool sameClauses(const vector<ClauseExchange *> & a,
+                        const vector<ClauseExchange *> & b)
+{
+   if (a.size() != b.size())
+      return false;
+
+   vector<vector<int> > sa, sb;
+
+   for (size_t i = 0; i < a.size(); i++) {
+      sa.push_back(vector<int>(a[i]->lits, a[i]->lits + a[i]->size));
+      sa.back().push_back(a[i]->lbd);
+      sort(sa.back().begin(), sa.back().end() - 1);
+
+      sb.push_back(vector<int>(b[i]->lits, b[i]->lits + b[i]->size));
+      sb.back().push_back(b[i]->lbd);
+      sort(sb.back().begin(), sb.back().end() - 1);
+   }
+
+   sort(sa.begin(), sa.end());
+   sort(sb.begin(), sb.end());
+
+   return sa == sb;
+}
+
+int main(int argc, char ** argv)
+{
+   if (argc < 2) {
+      printf("USAGE: %s clauses.cnf [batch size, default 1000] "
+             "[dictionary size, default 0]\n", argv[0]);
+      return 0;
+   }
+
+   size_t batchSize = argc > 2 ? atoi(argv[2]) : 1000;
+   int dictSize     = argc > 3 ? atoi(argv[3]) : 0;
+
+   vector<ClauseExchange *> clauses;
+
+   if (readClauses(argv[1], clauses) == false || clauses.empty() ||
+       batchSize == 0) {
+      printf("Cannot read clauses from %s\n", argv[1]);
+      return 1;
+   }
+
+   vector<vector<ClauseExchange *> > batches;
+
+   for (size_t i = 0; i < clauses.size(); i += batchSize) {
+      batches.push_back(vector<ClauseExchange *>(clauses.begin() + i,
+                        clauses.begin() + min(i + batchSize, clauses.size())));
+   }
+
+   size_t lits = 0;
+   for (size_t i = 0; i < clauses.size(); i++) {
+      lits += clauses[i]->size;
+   }
+
+   // In memory, and as the size, LBD and literals of each clause in ints
+   size_t memBytes = clauses.size() * sizeof(ClauseExchange) + 4 * lits;
+   size_t intBytes = 4 * (2 * clauses.size() + lits);
+
+   ClauseCodec codec(dictSize);
+
+   vector<uint8_t> buffer;
+   vector<ClauseExchange *> decoded;
+
+   size_t encBytes = 0;
+   bool ok         = true;
+
+   for (size_t b = 0; b < batches.size(); b++) {
+      buffer.clear();
+      codec.encode(batches[b], buffer);
+      encBytes += buffer.size();
+
+      decoded.clear();
+      ok = ok && codec.decode(buffer.data(), buffer.size(), decoded) ==
+                 buffer.size() && sameClauses(batches[b], decoded);
+
+      for (size_t i = 0; i < decoded.size(); i++) {
+         ClauseManager::releaseClause(decoded[i]);
+      }
+   }
+
+   // Repeat the whole stream for at least one second
+   typedef chrono::steady_clock Clock;
+
+   double encTime = 0, decTime = 0;
+   int rounds     = 0;
+
+   while (encTime + decTime < 1 || rounds == 0) {
+      for (size_t b = 0; b < batches.size(); b++) {
+         Clock::time_point t0 = Clock::now();
+
+         buffer.clear();
+         codec.encode(batches[b], buffer);
+
+         Clock::time_point t1 = Clock::now();
+
+         decoded.clear();
+         codec.decode(buffer.data(), buffer.size(), decoded);
+
+         Clock::time_point t2 = Clock::now();
+
+         for (size_t i = 0; i < decoded.size(); i++) {
+            ClauseManager::releaseClause(decoded[i]);
+         }
+
+         encTime += chrono::duration<double>(t1 - t0).count();
+         decTime += chrono::duration<double>(t2 - t1).count();
+      }
+
+      rounds++;
+   }
+
+   double n = clauses.size();
+
+   printf("clauses %zu, literals %.2f per clause, batches of %zu, "
+          "dictionary %d\n", clauses.size(), lits / n, batchSize, dictSize);
+   printf("bytes per clause: memory %.2f, ints %.2f, encoded %.2f (%.1fx)\n",
+          memBytes / n, intBytes / n, encBytes / n, intBytes /
+          (double)encBytes);
+   printf("encode %.3f GB/s, decode %.3f GB/s of ints, %.1f M clauses/s\n",
+          intBytes * rounds / encTime / 1e9, intBytes * rounds / decTime / 1e9,
+          n * rounds / encTime / 1e6);
+   printf("round trip %s\n", ok ? "ok" : "FAILED");
+
+   return ok ? 0 : 1;
+}
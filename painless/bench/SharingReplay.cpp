@@ -0,0 +1,309 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+// Replay of a sharing trace recorded with -shr-trace. The batches of the
+// producers are given back to a sharing strategy at each recorded round,
+// without the solvers: it measures the throughput of the strategy, the
+// quality of the clauses it delivers and the memory it holds. The strategy
+// and the topology of the sharers are options, so are the parameters read
+// by the strategies, e.g. -shr-lit.
+
+#include "clauses/ClauseManager.h"
+#include "sharing/HordeSatSharing.h"
+#include "sharing/SharingTrace.h"
+#include "utils/Parameters.h"
+
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <stdio.h>
+#include <sys/resource.h>
+#include <vector>
+
+using namespace std;
+
+// Solver standing for a producer of the trace, it is also a consumer
+class TraceSolver : public SolverInterface
+{
+public:
+   TraceSolver(int id) : SolverInterface(id, REMOTE)
+   {
+      received  = 0;
+      lbdSum    = 0;
+      sizeSum   = 0;
+      glues     = 0;
+      increases = 0;
+      decreases = 0;
+   }
+
+   ~TraceSolver()
+   {
+      for (size_t i = 0; i < pending.size(); i++) {
+         ClauseManager::releaseClause(pending[i]);
+      }
+   }
+
+   // Clauses of the batches recorded since the last round
+   void addBatch(const vector<ClauseExchange *> & clauses)
+   {
+      pending.insert(pending.end(), clauses.begin(), clauses.end());
+   }
+
+   void getLearnedClauses(vector<ClauseExchange *> & clauses)
+   {
+      clauses.insert(clauses.end(), pending.begin(), pending.end());
+      pending.clear();
+   }
+
+   void addLearnedClauses(const vector<ClauseExchange *> & clauses)
+   {
+      for (size_t i = 0; i < clauses.size(); i++) {
+         addLearnedClause(clauses[i]);
+      }
+   }
+
+   void addLearnedClause(ClauseExchange * clause)
+   {
+      received++;
+      lbdSum  += clause->lbd;
+      sizeSum += clause->size;
+      glues   += clause->lbd <= 2;
+
+      ClauseManager::releaseClause(clause);
+   }
+
+   void increaseClauseProduction() { increases++; }
+   void decreaseClauseProduction() { decreases++; }
+
+   bool loadFormula(const char * filename) { return false; }
+   int getVariablesCount() { return 0; }
+   int getDivisionVariable() { return 0; }
+   void setPhase(const int var, const bool phase) {}
+   void bumpVariableActivity(const int var, const int times) {}
+   void setSolverInterrupt() {}
+   void unsetSolverInterrupt() {}
+   SatResult solve(const vector<int> & cube) { return UNKNOWN; }
+   void addClause(ClauseExchange * clause) {}
+   void addClauses(const vector<ClauseExchange *> & clauses) {}
+   void addInitialClauses(const vector<ClauseExchange *> & clauses) {}
+   SolvingStatistics getStatistics() { return SolvingStatistics(); }
+   vector<int> getModel() { return vector<int>(); }
+   void diversify(int id) {}
+   vector<int> getFinalAnalysis() { return vector<int>(); }
+   vector<int> getSatAssumptions() { return vector<int>(); }
+
+   vector<ClauseExchange *> pending;
+
+   unsigned long received, lbdSum, sizeSum, glues;
+
+   unsigned long increases, decreases;
+};
+
+// Baseline strategy giving every clause to every other consumer
+class AllSharing : public SharingStrategy
+{
+public:
+   void doSharing(int idSharer, const vector<SolverInterface *> & from,
+                  const vector<SolverInterface *> & to)
+   {
+      for (size_t i = 0; i < from.size(); i++) {
+         tmp.clear();
+         from[i]->getLearnedClauses(tmp);
+
+         stats.receivedClauses += tmp.size();
+         stats.sharedClauses   += tmp.size();
+
+         for (size_t j = 0; j < to.size(); j++) {
+            if (to[j]->id != from[i]->id) {
+               for (size_t k = 0; k < tmp.size(); k++) {
+                  ClauseManager::increaseClause(tmp[k]);
+               }
+               to[j]->addLearnedClauses(tmp);
+            }
+         }
+
+         for (size_t k = 0; k < tmp.size(); k++) {
+            ClauseManager::releaseClause(tmp[k]);
+         }
+      }
+   }
+
+   SharingStatistics getStatistics() { return stats; }
+
+   SharingStatistics stats;
+
+   vector<ClauseExchange *> tmp;
+};
+
+// Strategy under test
+static SharingStrategy * createStrategy(int strat)
+{
+   switch (strat) {
+   case 0:
+      return new AllSharing();
+   default:
+      return new HordeSatSharing();
+   }
+}
+
+int main(int argc, char ** argv)
+{
+   Parameters::init(argc, argv);
+
+   if (Parameters::getFilename() == NULL) {
+      printf("USAGE: %s [options] trace\n", argv[0]);
+      printf("\t-strat=<INT>\t strategy: 0 share everything, 1 HordeSat, "
+             "default is 1\n");
+      printf("\t-topo=<INT>\t sharers: 0 as recorded, 1 a single sharer, "
+             "default is 0\n");
+      printf("\t-shr-lit=<INT>\t literals per producer and round of "
+             "HordeSat, default is 1500\n");
+      return 0;
+   }
+
+   int strat = Parameters::getIntParam("strat", 1);
+   int topo  = Parameters::getIntParam("topo", 0);
+
+   SharingTrace trace;
+
+   if (trace.open(Parameters::getFilename(), false) == false) {
+      printf("Cannot read the trace %s\n", Parameters::getFilename());
+      return 1;
+   }
+
+   map<int, TraceSolver *> solvers;
+   map<int, vector<SolverInterface *> > producers;
+   map<int, SharingStrategy *> strategies;
+   vector<SolverInterface *> consumers;
+
+   unsigned long produced = 0, lbdSum = 0, sizeSum = 0, glues = 0;
+   unsigned long recSelected = 0, recLiterals = 0, recRequests = 0;
+   unsigned long rounds = 0, lastTime = 0;
+
+   typedef chrono::steady_clock Clock;
+
+   double sharingTime = 0;
+   int firstSharer    = -1;
+
+   TraceRecord record;
+
+   while (trace.read(record)) {
+      lastTime = record.time;
+
+      if (record.type == TRACE_BATCH) {
+         TraceSolver *& solver = solvers[record.producer];
+
+         if (solver == NULL) {
+            solver = new TraceSolver(record.producer);
+            consumers.push_back(solver);
+         }
+
+         // The producers of a sharer, or of the single one
+         vector<SolverInterface *> & from =
+            producers[topo == 1 ? 0 : record.sharer];
+
+         if (find(from.begin(), from.end(), solver) == from.end()) {
+            from.push_back(solver);
+         }
+
+         for (size_t i = 0; i < record.clauses.size(); i++) {
+            lbdSum  += record.clauses[i]->lbd;
+            sizeSum += record.clauses[i]->size;
+            glues   += record.clauses[i]->lbd <= 2;
+         }
+
+         produced += record.clauses.size();
+         solver->addBatch(record.clauses);
+      } else if (record.type == TRACE_SELECTION) {
+         recSelected += record.selected;
+         recLiterals += record.literals;
+         recRequests += record.request != 0;
+      } else if (record.type == TRACE_ROUND) {
+         if (firstSharer < 0)
+            firstSharer = record.sharer;
+
+         // The single sharer runs at the rounds of the first one
+         if (topo == 1 && record.sharer != firstSharer)
+            continue;
+
+         int id = topo == 1 ? 0 : record.sharer;
+
+         SharingStrategy *& strategy = strategies[id];
+
+         if (strategy == NULL) {
+            strategy = createStrategy(strat);
+         }
+
+         Clock::time_point t0 = Clock::now();
+
+         strategy->doSharing(id, producers[id], consumers);
+
+         sharingTime += chrono::duration<double>(Clock::now() - t0).count();
+         rounds++;
+      }
+   }
+
+   unsigned long selected = 0, received = 0, rLbdSum = 0, rSizeSum = 0;
+   unsigned long rGlues = 0, requests = 0;
+
+   for (auto it = strategies.begin(); it != strategies.end(); it++) {
+      selected += it->second->getStatistics().sharedClauses;
+   }
+
+   for (auto it = solvers.begin(); it != solvers.end(); it++) {
+      TraceSolver * solver = it->second;
+
+      received += solver->received;
+      rLbdSum  += solver->lbdSum;
+      rSizeSum += solver->sizeSum;
+      rGlues   += solver->glues;
+      requests += solver->increases + solver->decreases;
+   }
+
+   struct rusage usage;
+   getrusage(RUSAGE_SELF, &usage);
+
+   printf("trace: %.1f s, %lu rounds, %lu producers, %lu clauses, "
+          "avg lbd %.2f, avg size %.2f, glues %.1f%%\n", lastTime / 1e6,
+          rounds, solvers.size(), produced,
+          produced ? (double)lbdSum / produced : 0,
+          produced ? (double)sizeSum / produced : 0,
+          produced ? 100.0 * glues / produced : 0);
+   printf("recorded: selected %lu clauses, %lu literals, %lu production "
+          "requests\n", recSelected, recLiterals, recRequests);
+   printf("replayed: selected %lu clauses, delivered %lu, avg lbd %.2f, "
+          "avg size %.2f, glues %.1f%%, %lu production requests\n", selected,
+          received, received ? (double)rLbdSum / received : 0,
+          received ? (double)rSizeSum / received : 0,
+          received ? 100.0 * rGlues / received : 0, requests);
+   printf("throughput: %.2f Mcls/s in the strategy (%.3f s), peak memory "
+          "%.1f MB\n", sharingTime > 0 ? produced / sharingTime / 1e6 : 0,
+          sharingTime, usage.ru_maxrss / 1024.0);
+
+   for (auto it = strategies.begin(); it != strategies.end(); it++) {
+      delete it->second;
+   }
+
+   for (auto it = solvers.begin(); it != solvers.end(); it++) {
+      delete it->second;
+   }
+
+   return 0;
+}
@@ -96,6 +96,7 @@ Solver::Solver() :
     //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0), conflicts_VSIDS(0)
   , dec_vars(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
+  , learnts_lbd(0), learnts_units(0)
 
   , ok                 (true)
   , cla_inc            (1)
@@ -124,7 +125,12 @@ Solver::Solver() :
   , conflict_budget    (-1)
   , propagation_budget (-1)
   , asynch_interrupt   (false)
-{}
+{
+   cbkRestart = NULL;
+
+   importedBySource.growTo(256, 0);
+   usedBySource.growTo(256, 0);
+}
 
 Solver::Solver(const Solver &s) :
     // Parameters (user settable):
@@ -159,6 +165,7 @@ Solver::Solver(const Solver &s) :
     , propagations(s.propagations), conflicts(s.conflicts), conflicts_VSIDS (s.conflicts_VSIDS)
   , dec_vars(s.dec_vars), clauses_literals(s.clauses_literals)
   , learnts_literals(s.learnts_literals), max_literals(s.max_literals), tot_literals(s.tot_literals)
+  , learnts_lbd(s.learnts_lbd), learnts_units(s.learnts_units)
 
   , ok(true)
   , cla_inc(s.cla_inc)
@@ -192,6 +199,8 @@ Solver::Solver(const Solver &s) :
    // Copy clauses.
    s.ca.copyTo(ca);
    ca.extra_clause_field = s.ca.extra_clause_field;
+   s.importedBySource.copyTo(importedBySource);
+   s.usedBySource.copyTo(usedBySource);
   
    // Copy all search vectors
    s.watches.copyTo(watches);
@@ -207,6 +216,7 @@ Solver::Solver(const Solver &s) :
    s.add_tmp.memCopyTo(add_tmp);
    s.add_oc.memCopyTo(add_oc);
    s.polarity.memCopyTo(polarity);
+   s.best_trail.memCopyTo(best_trail);
    s.decision.memCopyTo(decision);
    s.trail.memCopyTo(trail);
    s.trail_lim.memCopyTo(trail_lim);
@@ -230,6 +240,8 @@ Solver::Solver(const Solver &s) :
 #ifdef ANTI_EXPLORATION
    s.canceled.memCopyTo(canceled);
 #endif
+
+   cbkRestart = NULL;
 }
 
 Solver::~Solver()
@@ -352,9 +364,9 @@ bool Solver::importClauses() {
 
     if (cbkImportClause == NULL)
         return true;
-    int lbd, k, l;
+    int lbd, source, k, l;
     bool alreadySat;
-    while (cbkImportClause(issuer, &lbd, importedClause)) {
+    while (source = 0, cbkImportClause(issuer, &lbd, &source, importedClause)) {
         alreadySat = false;
         // Simplify clause before add
         for (k = l = 0; k < importedClause.size(); k++) {
@@ -378,8 +390,12 @@ bool Solver::importClauses() {
             uncheckedEnqueue(importedClause[0]);
         } else {
             CRef cr = ca.alloc(importedClause, true);
-            lbd = importedClause.size();
+            // The LBD of the producer, at most the size of the simplified clause
+            if (lbd <= 0 || lbd > importedClause.size())
+                lbd = importedClause.size();
             ca[cr].set_lbd(lbd);
+            ca[cr].source(source);
+            importedBySource[source]++;
             if (lbd <= core_lbd_cut) {
                 learnts_core.push(cr);
                 ca[cr].mark(CORE);
@@ -558,6 +574,11 @@ void Solver::analyze(CRef confl, vec<Lit>& out_learnt, int& out_btlevel, int& ou
             Lit tmp = c[0];
             c[0] = c[1], c[1] = tmp; }
 
+        // First use of an imported clause.
+        if (c.source() != 0 && !c.used()){
+            c.used(true);
+            usedBySource[c.source()]++; }
+
         // Update LBD if improved.
         if (c.learnt() && c.mark() != CORE){
             int lbd = computeLBD(c);
@@ -777,6 +798,41 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict)
 
     seen[var(p)] = 1;
 
+    analyzeFinalSeen(out_conflict);
+
+    seen[var(p)] = 0;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  analyzeFinal : (confl : CRef)  ->  [void]
+|
+|  Description:
+|    Specialized analysis procedure to express the conflicting clause 'confl' in terms of the
+|    decisions. Calculates the (possibly empty) set of decisions that led to the conflict and
+|    stores the negation of them in 'out_conflict'.
+|________________________________________________________________________________________________@*/
+void Solver::analyzeFinal(CRef confl, vec<Lit>& out_conflict)
+{
+    out_conflict.clear();
+
+    if (decisionLevel() == 0)
+        return;
+
+    Clause& c = ca[confl];
+    for (int i = 0; i < c.size(); i++)
+        if (level(var(c[i])) > 0)
+            seen[var(c[i])] = 1;
+
+    analyzeFinalSeen(out_conflict);
+}
+
+
+// Walk the trail from the literals marked in 'seen' back to the decisions, the negation of the
+// decisions are added to 'out_conflict'. The marks are cleared.
+void Solver::analyzeFinalSeen(vec<Lit>& out_conflict)
+{
     for (int i = trail.size()-1; i >= trail_lim[0]; i--){
         Var x = var(trail[i]);
         if (seen[x]){
@@ -792,8 +848,6 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict)
             seen[x] = 0;
         }
     }
-
-    seen[var(p)] = 0;
 }
 
 
@@ -1149,6 +1203,9 @@ lbool Solver::search(int& nof_conflicts)
     bool        cached = false;
     starts++;
 
+    if (cbkRestart != NULL)
+        cbkRestart(issuer);
+
     for (;;){
         if (decisionLevel() == 0) { // We import clauses
             if (!importUnitClauses()) return l_False;
@@ -1168,10 +1225,14 @@ lbool Solver::search(int& nof_conflicts)
             if (conflicts == 100000 && learnts_core.size() < 100) core_lbd_cut = 5;
             if (decisionLevel() == 0) return l_False;
 
+            if (trail.size() > best_trail.size())
+                trail.copyTo(best_trail);
+
             learnt_clause.clear();
             analyze(confl, learnt_clause, backtrack_level, lbd);
+            bool promoted = false;
             if (cbkExportClause != NULL)
-                cbkExportClause(issuer, lbd, learnt_clause);
+                promoted = cbkExportClause(issuer, lbd, learnt_clause);
 
             cancelUntil(backtrack_level);
 
@@ -1180,6 +1241,7 @@ lbool Solver::search(int& nof_conflicts)
                     varBumpActivity(var(learnt_clause[i]), 1. / lbd);
 
             lbd--;
+            learnts_lbd += lbd;
             if (VSIDS){
                 cached = false;
                 conflicts_VSIDS++;
@@ -1187,11 +1249,12 @@ lbool Solver::search(int& nof_conflicts)
                 global_lbd_sum += (lbd > 50 ? 50 : lbd); }
 
             if (learnt_clause.size() == 1){
+                learnts_units++;
                 uncheckedEnqueue(learnt_clause[0]);
             }else{
                 CRef cr = ca.alloc(learnt_clause, true);
                 ca[cr].set_lbd(lbd);
-                if (lbd <= core_lbd_cut){
+                if (lbd <= core_lbd_cut || promoted){
                     learnts_core.push(cr);
                     ca[cr].mark(CORE);
                 }else if (lbd <= 6){
@@ -1238,7 +1301,7 @@ lbool Solver::search(int& nof_conflicts)
                 restart = lbd_queue.full() && (lbd_queue.avg() * 0.8 > global_lbd_sum / conflicts_VSIDS);
                 cached = true;
             }
-            if (restart /*|| !withinBudget()*/){
+            if (restart || !withinBudget()){
                 lbd_queue.clear();
                 cached = false;
                 // Reached bound on number of conflicts:
@@ -1317,6 +1380,99 @@ void Solver::getAssumptions(vec<Lit>& lits) {
     }
 }
 
+// Vivification of a clause by unit propagation: the negation of the literals of 'lits' are
+// propagated one by one from level 0, stopping at the first conflict or implied literal.
+// Return true if a clause has been deduced, 'out_clause' is then the subset of 'lits'
+// implied by the formula (empty if the formula is unsatisfiable). Return false otherwise.
+bool Solver::vivifyClause(const vec<Lit>& lits, vec<Lit>& out_clause) {
+    out_clause.clear();
+
+    if (!ok)
+        return true;
+
+    cancelUntil(0);
+
+    if (!importUnitClauses() || propagate() != CRef_Undef) {
+        ok = false;
+        return true;
+    }
+
+    for (int i = 0; i < lits.size(); i++) {
+        Lit p = lits[i];
+
+        if (value(p) == l_True) {
+            // 'p' is implied by the negation of the previous literals
+            analyzeFinal(p, out_clause);
+            cancelUntil(0);
+            return true;
+        } else if (value(p) == l_False) {
+            // Redundant literal, its negation is already implied
+            continue;
+        }
+
+        newDecisionLevel();
+        uncheckedEnqueue(~p);
+
+        CRef confl = propagate();
+        if (confl != CRef_Undef) {
+            analyzeFinal(confl, out_clause);
+            cancelUntil(0);
+            return true;
+        }
+    }
+
+    cancelUntil(0);
+    return false;
+}
+
+void Solver::bumpVariable(Var v, double times) {
+    varBumpActivity(v, times);
+
+    // Move the CHB activity towards 1 as a reward would
+    double mult = times * step_size;
+    if (mult > 1) mult = 1;
+
+    activity_CHB[v] += mult * (1 - activity_CHB[v]);
+    if (order_heap_CHB.inHeap(v)) order_heap_CHB.decrease(v);
+}
+
+struct ActivityGt {
+    const vec<double>& activity;
+    bool operator () (Var x, Var y) const { return activity[x] > activity[y]; }
+    ActivityGt(const vec<double>& act) : activity(act) { }
+};
+
+void Solver::getActiveVariables(int k, vec<Var>& vars) {
+    const vec<double>& activity = VSIDS ? activity_VSIDS : activity_CHB;
+
+    vars.clear();
+    for (Var v = 0; v < nVars(); v++)
+        if (decision[v] && value(v) == l_Undef)
+            vars.push(v);
+
+    sort(vars, ActivityGt(activity));
+
+    if (k > vars.size()) k = vars.size();
+    vars.shrink(vars.size() - k);
+}
+
+void Solver::getPhases(bool best, vec<Lit>& lits) {
+    lits.clear();
+
+    if (best) {
+        best_trail.copyTo(lits);
+        return;
+    }
+
+    for (Var v = 0; v < nVars(); v++)
+        lits.push(mkLit(v, polarity[v]));
+}
+
+void Solver::setPhases(const vec<Lit>& lits) {
+    for (int i = 0; i < lits.size(); i++)
+        polarity[var(lits[i])] = sign(lits[i]);
+}
+
 void Solver::setStrengthening(bool b) {
     strengthening = b;
 }
@@ -1399,7 +1555,7 @@ lbool Solver::solve_()
         int weighted = phase_allotment;
         fflush(stdout);
 
-        while (status == l_Undef && weighted > 0 /*&& withinBudget()*/)
+        while (status == l_Undef && weighted > 0 && withinBudget())
             if (VSIDS)
                 status = search(weighted);
             else{
@@ -1409,7 +1565,7 @@ lbool Solver::solve_()
                 status = search(nof_conflicts);
             }
 
-        if (status != l_Undef /*|| !withinBudget()*/)
+        if (status != l_Undef || !withinBudget())
             break; // Should break here for correctness in incremental SAT solving.
 
         //VSIDS = !VSIDS;
@@ -108,14 +108,23 @@ public:
     void *   issuer;                                            // used as the callback parameter
 
     Lit  (* cbkImportUnit)  (void *);
-    bool (* cbkImportClause)(void *, int *, vec<Lit> &);
-    void (* cbkExportClause)(void *, int, vec<Lit> &);	        // callback for clause learning
+    bool (* cbkImportClause)(void *, int *, int *, vec<Lit> &); // gives the lbd and the source tag of the clause
+    bool (* cbkExportClause)(void *, int, vec<Lit> &);	        // callback for clause learning, true to put the clause in the core tier
+    void (* cbkRestart)     (void *);                           // callback called at each restart, at level 0
+
+    vec<uint64_t> importedBySource;                             // Number of imported clauses per source tag (8 bits in the header).
+    vec<uint64_t> usedBySource;                                 // Number of them used at least once in a conflict analysis.
 
 
     // Solving:
     //
     bool    shrinkAssumptions();
     void    getAssumptions(vec<Lit>& lits);
+    bool    vivifyClause (const vec<Lit>& lits, vec<Lit>& out_clause); // Propagate the negation of a clause, see definition.
+    void    bumpVariable (Var v, double times);          // Bump VSIDS and CHB activities of a variable from outside the search.
+    void    getActiveVariables(int k, vec<Var>& vars);   // The 'k' most active variables of the current heuristic, the most active first.
+    void    getPhases    (bool best, vec<Lit>& lits);    // Saved phases, or the longest trail if 'best', as literals.
+    void    setPhases    (const vec<Lit>& lits);         // Set the saved phases from a list of literals.
     bool    simplify     (bool do_stamping = false); // Removes already satisfied clauses.
     bool    solve        (const vec<Lit>& assumps); // Search for a model that respects a given set of assumptions.
     lbool   solveLimited (const vec<Lit>& assumps); // Search for a model that respects a given set of assumptions (With resource constraints).
@@ -204,6 +213,7 @@ public:
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts, conflicts_VSIDS;
     uint64_t dec_vars, clauses_literals, learnts_literals, max_literals, tot_literals;
+    uint64_t learnts_lbd, learnts_units;   // Sum of the LBD of the learnt clauses, number of learnt units.
 
     vec<uint32_t> picked;
     vec<uint32_t> conflicted;
@@ -262,6 +272,7 @@ protected:
                         watches;          // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
     vec<lbool>          assigns;          // The current assignments.
     vec<char>           polarity;         // The preferred polarity of each variable.
+    vec<Lit>            best_trail;       // Longest trail reached at a conflict.
     vec<char>           decision;         // Declares if a variable is eligible for selection in the decision heuristic.
     vec<Lit>            trail;            // Assignment stack; stores all assigments made in the order they were made.
     vec<int>            trail_lim;        // Separator indices for different decision levels in 'trail'.
@@ -317,6 +328,8 @@ protected:
     void     cancelUntil      (int level);                                             // Backtrack until a certain level.
     void     analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel, int& out_lbd);    // (bt = backtrack)
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict);                         // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
+    void     analyzeFinal     (CRef confl, vec<Lit>& out_conflict);                    // Express a conflict in terms of the decisions.
+    void     analyzeFinalSeen (vec<Lit>& out_conflict);                                // (helper method for 'analyzeFinal()')
     bool     litRedundant     (Lit p, uint32_t abstract_levels);                       // (helper method for 'analyze()')
     lbool    search           (int& nof_conflicts);                                    // Search for a given number of conflicts.
     lbool    solve_           ();                                                      // Main solve method (assumptions given in 'assumptions').
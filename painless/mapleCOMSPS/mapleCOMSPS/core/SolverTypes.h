@@ -128,8 +128,10 @@ class Clause {
         unsigned learnt    : 1;
         unsigned has_extra : 1;
         unsigned reloced   : 1;
-        unsigned lbd       : 26;
+        unsigned lbd       : 17;
         unsigned removable : 1;
+        unsigned used      : 1;
+        unsigned source    : 8;
         unsigned size      : 32; }                            header;
     union { Lit lit; float act; uint32_t abs; uint32_t touched; CRef rel; } data[0];
 
@@ -145,6 +147,8 @@ class Clause {
         header.size      = ps.size();
         header.lbd       = 0;
         header.removable = 1;
+        header.used      = 0;
+        header.source    = 0;
 
         for (int i = 0; i < ps.size(); i++) 
             data[i].lit = ps[i];
@@ -180,10 +184,16 @@ public:
     void         relocate    (CRef c)        { header.reloced = 1; data[0].rel = c; }
 
     int          lbd         ()      const   { return header.lbd; }
-    void         set_lbd     (int lbd)       { header.lbd = lbd; }
+    void         set_lbd     (int lbd)       { header.lbd = lbd < (1 << 17) ? lbd : (1 << 17) - 1; }
     bool         removable   ()      const   { return header.removable; }
     void         removable   (bool b)        { header.removable = b; }
 
+    // Source tag of an imported clause, 0 for the clauses of the solver, and whether it has been used in an analysis.
+    int          source      ()      const   { return header.source; }
+    void         source      (int s)         { header.source = s; }
+    bool         used        ()      const   { return header.used; }
+    void         used        (bool b)        { header.used = b; }
+
     // NOTE: somewhat unsafe to change the clause in-place! Must manually call 'calcAbstraction' afterwards for
     //       subsumption operations to behave correctly.
     Lit&         operator [] (int i)         { return data[i].lit; }
@@ -262,6 +272,8 @@ class ClauseAllocator : public RegionAllocator<uint32_t>
             to[cr].activity() = c.activity();
             to[cr].set_lbd(c.lbd());
             to[cr].removable(c.removable());
+            to[cr].source(c.source());
+            to[cr].used(c.used());
         }
         else if (to[cr].has_extra()) to[cr].calcAbstraction();
     }
@@ -69,6 +69,7 @@ static DoubleOption  opt_restart_inc       (_cat, "rinc",        "Restart interv
 static DoubleOption  opt_garbage_frac      (_cat, "gc-frac",     "The fraction of wasted memory allowed before a garbage collection is triggered",  0.20, DoubleRange(0, false, HUGE_VAL, false));
 static IntOption     opt_chrono            (_cat, "chrono",  "Controls if to perform chrono backtrack", 100, IntRange(-1, INT32_MAX));
 static IntOption     opt_conf_to_chrono    (_cat, "confl-to-chrono",  "Controls number of conflicts to perform chrono backtrack", 4000, IntRange(-1, INT32_MAX));
+static IntOption     opt_distance_confl    (_cat, "distance-confl",  "Number of conflicts searched with the distance heuristic", 50000, IntRange(0, INT32_MAX));
 
 static IntOption     opt_max_lbd_dup       ("DUP-LEARNTS", "lbd-limit",  "specifies the maximum lbd of learnts to be screened for duplicates.", 12, IntRange(0, INT32_MAX));
 static IntOption     opt_min_dupl_app      ("DUP-LEARNTS", "min-dup-app",  "specifies the minimum number of learnts to be included into db.", 3, IntRange(2, INT32_MAX));
@@ -120,11 +121,16 @@ Solver::Solver() :
   , learntsize_adjust_start_confl (100)
   , learntsize_adjust_inc         (1.5)
 
+  , chrono			   (opt_chrono)
+  , confl_to_chrono    (opt_conf_to_chrono)
+  , distance_confl     (opt_distance_confl)
+
   // Statistics: (formerly in 'SolverStats')
   //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0), conflicts_VSIDS(0)
   , dec_vars(0), clauses_literals(0), learnts_literals(0), max_literals(0), tot_literals(0)
   , chrono_backtrack(0), non_chrono_backtrack(0)
+  , learnts_lbd(0), learnts_units(0)
 
   , ok                 (true)
   , cla_inc            (1)
@@ -144,8 +150,6 @@ Solver::Solver() :
   , lbd_queue          (50)
   , next_T2_reduce     (10000)
   , next_L_reduce      (15000)
-  , confl_to_chrono    (opt_conf_to_chrono)
-  , chrono			   (opt_chrono)
   
   , counter            (0)
 
@@ -172,7 +176,182 @@ Solver::Solver() :
   , verso              (true)
   , LRB                (true)
 
-{}
+{
+    cbkImportUnit   = NULL;
+    cbkImportClause = NULL;
+    cbkExportClause = NULL;
+    cbkRestart      = NULL;
+
+    // The table of the duplicates grows with the learnt clauses, the copies
+    // that never search do not pay for it
+    ht_used = 0;
+
+    curr_restarts = 0;
+}
+
+
+Solver::Solver(const Solver &s) :
+
+    // Parameters (user settable), in the order of the declarations:
+    //
+    drup_file        (NULL)
+  , verbosity        (s.verbosity)
+  , step_size        (s.step_size)
+  , step_size_dec    (s.step_size_dec)
+  , min_step_size    (s.min_step_size)
+  , timer            (s.timer)
+  , var_decay        (s.var_decay)
+  , clause_decay     (s.clause_decay)
+  , random_var_freq  (s.random_var_freq)
+  , random_seed      (s.random_seed)
+  , VSIDS            (s.VSIDS)
+  , LRB              (s.LRB)
+  , ccmin_mode       (s.ccmin_mode)
+  , phase_saving     (s.phase_saving)
+  , rnd_pol          (s.rnd_pol)
+  , rnd_init_act     (s.rnd_init_act)
+  , garbage_frac     (s.garbage_frac)
+  , restart_first    (s.restart_first)
+  , restart_inc      (s.restart_inc)
+
+  // Parameters (the rest):
+  //
+  , learntsize_factor(s.learntsize_factor), learntsize_inc(s.learntsize_inc)
+
+  // Parameters (experimental):
+  //
+  , learntsize_adjust_start_confl (s.learntsize_adjust_start_confl)
+  , learntsize_adjust_inc         (s.learntsize_adjust_inc)
+
+  , chrono			   (s.chrono)
+  , confl_to_chrono    (s.confl_to_chrono)
+  , distance_confl     (s.distance_confl)
+  , verso              (s.verso)
+  , timeout            (s.timeout)
+
+  , VSIDS_props_limit(s.VSIDS_props_limit)
+  , min_number_of_learnts_copies(s.min_number_of_learnts_copies)
+  , dupl_db_init_size(s.dupl_db_init_size)
+  , max_lbd_dup(s.max_lbd_dup)
+
+  // Statistics: (formerly in 'SolverStats')
+  //
+  , solves(s.solves), starts(s.starts), decisions(s.decisions), rnd_decisions(s.rnd_decisions)
+  , propagations(s.propagations), conflicts(s.conflicts), conflicts_VSIDS(s.conflicts_VSIDS)
+  , dec_vars(s.dec_vars), clauses_literals(s.clauses_literals)
+  , learnts_literals(s.learnts_literals), max_literals(s.max_literals), tot_literals(s.tot_literals)
+  , chrono_backtrack(s.chrono_backtrack), non_chrono_backtrack(s.non_chrono_backtrack)
+  , learnts_lbd(s.learnts_lbd), learnts_units(s.learnts_units)
+
+  , ok                 (s.ok)
+  , cla_inc            (s.cla_inc)
+  , var_inc            (s.var_inc)
+  , watches_bin        (WatcherDeleted(ca))
+  , watches            (WatcherDeleted(ca))
+  , qhead              (s.qhead)
+  , simpDB_assigns     (s.simpDB_assigns)
+  , simpDB_props       (s.simpDB_props)
+  , order_heap_CHB     (VarOrderLt(activity_CHB, verso))
+  , order_heap_VSIDS   (VarOrderLt(activity_VSIDS, verso))
+  , order_heap_distance(VarOrderLt(activity_distance, verso))
+  , progress_estimate  (s.progress_estimate)
+  , remove_satisfied   (s.remove_satisfied)
+
+  , core_lbd_cut       (s.core_lbd_cut)
+  , global_lbd_sum     (s.global_lbd_sum)
+  , lbd_queue          (s.lbd_queue)
+  , next_T2_reduce     (s.next_T2_reduce)
+  , next_L_reduce      (s.next_L_reduce)
+  
+  , counter            (s.counter)
+
+  // Resource constraints:
+  //
+  , conflict_budget    (s.conflict_budget)
+  , propagation_budget (s.propagation_budget)
+  , asynch_interrupt   (s.asynch_interrupt)
+
+  // simplfiy
+  , nbSimplifyAll(s.nbSimplifyAll)
+  , s_propagations(s.s_propagations)
+
+  // simplifyAll adjust occasion
+  , curSimplify(s.curSimplify)
+  , nbconfbeforesimplify(s.nbconfbeforesimplify)
+  , incSimplify(s.incSimplify)
+
+  , var_iLevel_inc     (s.var_iLevel_inc)
+  , my_var_decay       (s.my_var_decay)
+  , DISTANCE           (s.DISTANCE)
+
+{
+   // Copy clauses.
+   s.ca.copyTo(ca);
+   ca.extra_clause_field = s.ca.extra_clause_field;
+
+   // Copy all search vectors
+   s.watches.copyTo(watches);
+   s.watches_bin.copyTo(watches_bin);
+   s.assigns.memCopyTo(assigns);
+   s.vardata.memCopyTo(vardata);
+   s.activity_CHB.memCopyTo(activity_CHB);
+   s.activity_VSIDS.memCopyTo(activity_VSIDS);
+   s.activity_distance.memCopyTo(activity_distance);
+   s.seen.memCopyTo(seen);
+   s.analyze_stack.memCopyTo(analyze_stack);
+   s.analyze_toclear.memCopyTo(analyze_toclear);
+   s.seen2.memCopyTo(seen2);
+   s.add_tmp.memCopyTo(add_tmp);
+   s.add_oc.memCopyTo(add_oc);
+   s.polarity.memCopyTo(polarity);
+   s.decision.memCopyTo(decision);
+   s.trail.memCopyTo(trail);
+   s.trail_lim.memCopyTo(trail_lim);
+   s.order_heap_CHB.copyTo(order_heap_CHB);
+   s.order_heap_VSIDS.copyTo(order_heap_VSIDS);
+   s.order_heap_distance.copyTo(order_heap_distance);
+   s.clauses.memCopyTo(clauses);
+   s.learnts_core.memCopyTo(learnts_core);
+   s.learnts_tier2.memCopyTo(learnts_tier2);
+   s.learnts_local.memCopyTo(learnts_local);
+   s.picked.memCopyTo(picked);
+   s.conflicted.memCopyTo(conflicted);
+   s.almost_conflicted.memCopyTo(almost_conflicted);
+#ifdef ANTI_EXPLORATION
+   s.canceled.memCopyTo(canceled);
+#endif
+   s.var_iLevel.memCopyTo(var_iLevel);
+   s.var_iLevel_tmp.memCopyTo(var_iLevel_tmp);
+   s.pathCs.memCopyTo(pathCs);
+
+   // Duplicate learnts database
+   ht                            = s.ht;
+   ht_used                       = s.ht_used;
+   duplicates_added_conflicts    = s.duplicates_added_conflicts;
+   duplicates_added_tier2        = s.duplicates_added_tier2;
+   duplicates_added_minimization = s.duplicates_added_minimization;
+   dupl_db_size                  = s.dupl_db_size;
+
+   max_learnts             = s.max_learnts;
+   learntsize_adjust_confl = s.learntsize_adjust_confl;
+   learntsize_adjust_cnt   = s.learntsize_adjust_cnt;
+   previousStarts          = s.previousStarts;
+   curr_restarts           = s.curr_restarts;
+   trailRecord             = s.trailRecord;
+
+   simplified_length_record = s.simplified_length_record;
+   original_length_record   = s.original_length_record;
+   nbcollectfirstuip        = s.nbcollectfirstuip;
+   nblearntclause           = s.nblearntclause;
+   nbDoubleConflicts        = s.nbDoubleConflicts;
+   nbTripleConflicts        = s.nbTripleConflicts;
+
+   cbkImportUnit   = s.cbkImportUnit;
+   cbkImportClause = s.cbkImportClause;
+   cbkExportClause = s.cbkExportClause;
+   cbkRestart      = s.cbkRestart;
+   issuer          = s.issuer;
+}
 
 
 Solver::~Solver()
@@ -705,44 +884,63 @@ bool Solver::simplifyLearnt_core()
 }
 
 
-int Solver::is_duplicate(std::vector<uint32_t>&c){
-   auto time_point_0 = std::chrono::high_resolution_clock::now();
+#define DUP_COUNT_BITS 16
+#define DUP_COUNT_MASK ((1ULL << DUP_COUNT_BITS) - 1)
+#define DUP_MIN_ENTRIES 1024
+
+int Solver::is_duplicate(const Lit* c, int sz){
     dupl_db_size++;
-    int res = 0;    
-    
-    int sz = c.size();
-    std::vector<uint32_t> tmp(c);    
-    sort(tmp.begin(),tmp.end());
-    
-    uint64_t hash = 0;    
-    
-    for (int i =0; i<sz; i++) {
-        hash ^= tmp[i] + 0x9e3779b9 + (hash << 6) + (hash>> 2);     
-    }    
-    
-    int32_t head = tmp[0];
-    auto it0 = ht.find(head);
-    if (it0 != ht.end()){
-        auto it1=ht[head].find(sz);
-        if (it1 != ht[head].end()){
-            auto it2 = ht[head][sz].find(hash);
-            if (it2 != ht[head][sz].end()){
-                it2->second++;
-                res = it2->second;            
-            }
-            else{
-                ht[head][sz][hash]=1;
-            }
+
+    // Sort the literals in a reused buffer, in place (selection sort for the
+    // small clauses)
+    ht_lits.clear();
+    for (int i = 0; i < sz; i++)
+        ht_lits.push(c[i].x);
+    sort(ht_lits);
+
+    uint64_t hash = sz;
+    for (int i = 0; i < sz; i++){
+        hash = (hash ^ ht_lits[i]) * 0x9e3779b97f4a7c15ULL;
+        hash ^= hash >> 32;
+    }
+    uint64_t fingerprint = hash & ~DUP_COUNT_MASK;
+
+    if (2 * (ht_used + 1) > ht.size())
+        resizeduplicates(ht.empty() ? DUP_MIN_ENTRIES : 2 * ht.size());
+
+    uint64_t mask = ht.size() - 1;
+    for (uint64_t i = (hash >> DUP_COUNT_BITS) & mask;; i = (i + 1) & mask){
+        uint64_t entry = ht[i];
+        if (entry == 0){
+            ht[i] = fingerprint | 1;
+            ht_used++;
+            return 0;
         }
-        else{            
-            ht[head][sz][hash]=1;
+        if ((entry & ~DUP_COUNT_MASK) == fingerprint){
+            // The count saturates, far above the copies that matter
+            if ((entry & DUP_COUNT_MASK) < DUP_COUNT_MASK)
+                ht[i] = ++entry;
+            return entry & DUP_COUNT_MASK;
         }
-    }else{        
-        ht[head][sz][hash]=1;
-    } 
-    auto time_point_1 = std::chrono::high_resolution_clock::now();
-    duptime += std::chrono::duration_cast<std::chrono::microseconds>(time_point_1-time_point_0);    
-    return res;
+    }
+}
+
+void Solver::resizeduplicates(uint64_t capacity){
+    uint64_t size = 1;
+    while (size < capacity) size *= 2;
+
+    ht_kept.clear();
+    for (size_t i = 0; i < ht.size(); i++)
+        if (ht[i] != 0) ht_kept.push(ht[i]);
+
+    ht.assign(size, 0);
+    uint64_t mask = size - 1;
+    for (int k = 0; k < ht_kept.size(); k++){
+        uint64_t i = (ht_kept[k] >> DUP_COUNT_BITS) & mask;
+        while (ht[i] != 0) i = (i + 1) & mask;
+        ht[i] = ht_kept[k];
+    }
+    ht_used = ht_kept.size();
 }
 
 bool Solver::simplifyLearnt_tier2()
@@ -858,10 +1056,7 @@ bool Solver::simplifyLearnt_tier2()
                      //duplicate learnts 
                     int id = 0;                    
                     
-                    std::vector<uint32_t> tmp;
-                    for (int i = 0; i < c.size(); i++)                           
-                        tmp.push_back(c[i].x);
-                    id = is_duplicate(tmp);
+                    id = is_duplicate(c, c.size());
                      
                                         
                     //duplicate learnts 
@@ -919,6 +1114,111 @@ bool Solver::simplifyAll()
 
     return true;
 }
+// Vivification of a clause by unit propagation: the negation of the literals of 'lits' are
+// propagated one by one from level 0, stopping at the first conflict or implied literal.
+// Return true if a clause has been deduced, 'out_clause' is then the subset of 'lits'
+// implied by the formula (empty if the formula is unsatisfiable). Return false otherwise.
+bool Solver::vivifyClause(const vec<Lit>& lits, vec<Lit>& out_clause)
+{
+    out_clause.clear();
+
+    if (!ok)
+        return true;
+
+    cancelUntil(0);
+
+    if (propagate() != CRef_Undef){
+        ok = false;
+        return true;
+    }
+
+    for (int i = 0; i < lits.size(); i++){
+        Lit p = lits[i];
+
+        if (value(p) == l_True){
+            // 'p' is implied by the negation of the previous literals
+            analyzeFinal(p, out_clause);
+            cancelUntil(0);
+            return true;
+        }else if (value(p) == l_False)
+            // Redundant literal, its negation is already implied
+            continue;
+
+        newDecisionLevel();
+        uncheckedEnqueue(~p, decisionLevel());
+
+        CRef confl = propagate();
+        if (confl != CRef_Undef){
+            analyzeFinal(confl, out_clause);
+            cancelUntil(0);
+            return true;
+        }
+    }
+
+    cancelUntil(0);
+    return false;
+}
+
+void Solver::getPhases(vec<Lit>& lits) {
+    lits.clear();
+
+    for (Var v = 0; v < nVars(); v++)
+        lits.push(mkLit(v, polarity[v]));
+}
+
+void Solver::setPhases(const vec<Lit>& lits) {
+    for (int i = 0; i < lits.size(); i++)
+        if (var(lits[i]) < nVars())
+            polarity[var(lits[i])] = sign(lits[i]);
+}
+
+// Copy of the formula for a solver working beside this one: the level 0 units and the
+// irredundant clauses, the learnts are left out.
+void Solver::copyIrredundant(Solver& to)
+{
+    while (to.nVars() < nVars())
+        to.newVar();
+
+    int units = decisionLevel() == 0 ? trail.size() : trail_lim[0];
+    for (int i = 0; i < units; i++)
+        to.addClause(trail[i]);
+
+    for (int i = 0; i < clauses.size(); i++){
+        if (removed(clauses[i])) continue;
+
+        const Clause& c = ca[clauses[i]];
+        add_tmp.clear();
+        for (int j = 0; j < c.size(); j++)
+            add_tmp.push(c[j]);
+        to.addClause(add_tmp);
+    }
+}
+
+// Snapshot of at most 'max' core and tier2 learnts, for a vivification outside the search.
+// The clauses are marked as simplified, so that 'simplifyAll()' leaves them out. The literals
+// of the clauses follow each other in 'lits'.
+void Solver::getLearntsToVivify(int max, vec<Lit>& lits, vec<int>& sizes, vec<int>& lbds)
+{
+    vec<CRef>* tiers[] = { &learnts_core, &learnts_tier2 };
+
+    for (int t = 0; t < 2; t++){
+        vec<CRef>& learnts = *tiers[t];
+
+        for (int i = 0; i < learnts.size() && sizes.size() < max; i++){
+            if (removed(learnts[i])) continue;
+
+            Clause& c = ca[learnts[i]];
+            if (c.simplified()) continue;
+
+            c.setSimplified(true);
+            for (int j = 0; j < c.size(); j++)
+                lits.push(c[j]);
+            sizes.push(c.size());
+            lbds.push(c.lbd());
+        }
+    }
+}
+
 //=================================================================================================
 // Minor methods:
 
@@ -1478,6 +1778,41 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict)
 
     seen[var(p)] = 1;
 
+    analyzeFinalSeen(out_conflict);
+
+    seen[var(p)] = 0;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  analyzeFinal : (confl : CRef)  ->  [void]
+|
+|  Description:
+|    Specialized analysis procedure to express the conflicting clause 'confl' in terms of the
+|    decisions. Calculates the (possibly empty) set of decisions that led to the conflict and
+|    stores the negation of them in 'out_conflict'.
+|________________________________________________________________________________________________@*/
+void Solver::analyzeFinal(CRef confl, vec<Lit>& out_conflict)
+{
+    out_conflict.clear();
+
+    if (decisionLevel() == 0)
+        return;
+
+    Clause& c = ca[confl];
+    for (int i = 0; i < c.size(); i++)
+        if (level(var(c[i])) > 0)
+            seen[var(c[i])] = 1;
+
+    analyzeFinalSeen(out_conflict);
+}
+
+
+// Walk the trail from the literals marked in 'seen' back to the decisions, the negation of the
+// decisions are added to 'out_conflict'. The marks are cleared.
+void Solver::analyzeFinalSeen(vec<Lit>& out_conflict)
+{
     for (int i = trail.size()-1; i >= trail_lim[0]; i--){
         Var x = var(trail[i]);
         if (seen[x]){
@@ -1493,8 +1828,6 @@ void Solver::analyzeFinal(Lit p, vec<Lit>& out_conflict)
             seen[x] = 0;
         }
     }
-
-    seen[var(p)] = 0;
 }
 
 
@@ -1948,13 +2281,12 @@ bool Solver::importClauses() {
         } else if (importedClause.size() == 1) {
             uncheckedEnqueue(importedClause[0]);
         } else {
-            lbd = importedClause.size();
+            // The LBD of the producer, at most the size of the simplified clause
+            if (lbd <= 0 || lbd > importedClause.size())
+                lbd = importedClause.size();
             int  id = 0;
             if (lbd <= max_lbd_dup){
-                std::vector<uint32_t> tmp;
-                for (int i = 0; i < importedClause.size(); i++)
-                    tmp.push_back(importedClause[i].x);
-                id = is_duplicate(tmp);
+                id = is_duplicate(importedClause, importedClause.size());
                 if (id == min_number_of_learnts_copies +1){
                     duplicates_added_conflicts++;
                 }
@@ -2004,6 +2336,9 @@ lbool Solver::search(int& nof_conflicts)
     bool        cached = false;
     starts++;
 
+    if (cbkRestart != NULL)
+        cbkRestart(issuer);
+
     // simplify
     //
     if (conflicts >= curSimplify * nbconfbeforesimplify){
@@ -2045,7 +2380,7 @@ lbool Solver::search(int& nof_conflicts)
 			}
 			
             learnt_clause.clear();
-            if(conflicts>50000) {
+            if(conflicts>distance_confl) {
                 DISTANCE=0;
                 VSIDS = !LRB;
             }
@@ -2054,8 +2389,9 @@ lbool Solver::search(int& nof_conflicts)
                 collectFirstUIP(confl);
 
             analyze(confl, learnt_clause, backtrack_level, lbd);
+            bool promoted = false;
             if (cbkExportClause != NULL)
-                cbkExportClause(issuer, lbd, learnt_clause);
+                promoted = cbkExportClause(issuer, lbd, learnt_clause);
 
             // check chrono backtrack condition
             if ((confl_to_chrono < 0 || confl_to_chrono <= conflicts) && chrono > -1 && (decisionLevel() - backtrack_level) >= chrono)
@@ -2070,6 +2406,7 @@ lbool Solver::search(int& nof_conflicts)
 			}
 
             lbd--;
+            learnts_lbd += lbd;
             if (VSIDS){
                 cached = false;
                 conflicts_VSIDS++;
@@ -2077,6 +2414,7 @@ lbool Solver::search(int& nof_conflicts)
                 global_lbd_sum += (lbd > 50 ? 50 : lbd); }
 
             if (learnt_clause.size() == 1){
+                learnts_units++;
                 uncheckedEnqueue(learnt_clause[0]);
             }else{
                 CRef cr = ca.alloc(learnt_clause, true);
@@ -2084,10 +2422,7 @@ lbool Solver::search(int& nof_conflicts)
                 //duplicate learnts 
                 int  id = 0;
                 if (lbd <= max_lbd_dup){                        
-                    std::vector<uint32_t> tmp;
-                    for (int i = 0; i < learnt_clause.size(); i++)
-                        tmp.push_back(learnt_clause[i].x);
-                    id = is_duplicate(tmp);             
+                    id = is_duplicate(learnt_clause, learnt_clause.size());
                     if (id == min_number_of_learnts_copies +1){
                         duplicates_added_conflicts++;                        
                     }                    
@@ -2097,7 +2432,7 @@ lbool Solver::search(int& nof_conflicts)
                 }
                 //duplicate learnts
 
-                if ((lbd <= core_lbd_cut) || (id == min_number_of_learnts_copies+1)){
+                if ((lbd <= core_lbd_cut) || (id == min_number_of_learnts_copies+1) || promoted){
                     learnts_core.push(cr);
                     ca[cr].mark(CORE);
                 }else if ((lbd <= 6)||(id == min_number_of_learnts_copies)){
@@ -2148,7 +2483,7 @@ lbool Solver::search(int& nof_conflicts)
                 restart = lbd_queue.full() && (lbd_queue.avg() * 0.8 > global_lbd_sum / conflicts_VSIDS);
                 cached = true;
             }
-            if (restart /*|| !withinBudget()*/){
+            if (restart || !withinBudget()){
                 lbd_queue.clear();
                 cached = false;
                 // Reached bound on number of conflicts:
@@ -2250,24 +2585,14 @@ static bool switch_mode = false;
 //static void SIGALRM_switch(int signum) { switch_mode = true; }
 
 uint32_t Solver::reduceduplicates(){
-    uint32_t removed_duplicates = 0;
-    std::vector<std::vector<uint64_t>> tmp;
-    //std::map<int32_t,std::map<uint32_t,std::unordered_map<uint64_t,uint32_t>>>  ht;
-    for (auto & outer_mp: ht){//variables
-        for (auto &inner_mp:outer_mp.second){//sizes
-            for (auto &in_in_mp: inner_mp.second){
-                if (in_in_mp.second >= 2){
-                //min_number_of_learnts_copies
-                    tmp.push_back({outer_mp.first,inner_mp.first,in_in_mp.first,in_in_mp.second});
-                }
-            }                    
-         }
-    }          
-    removed_duplicates = dupl_db_size-tmp.size();  
-    ht.clear();
-    for (auto i=0;i<tmp.size();i++){
-        ht[tmp[i][0]][tmp[i][1]][tmp[i][2]]=tmp[i][3];
+    // Forget the clauses seen once, the rebuild closes the holes
+    uint64_t kept = 0;
+    for (size_t i = 0; i < ht.size(); i++){
+        if ((ht[i] & DUP_COUNT_MASK) < 2) ht[i] = 0;
+        else kept++;
     }
+    uint32_t removed_duplicates = dupl_db_size - kept;
+    resizeduplicates(ht.size());
     return removed_duplicates;
 }
 
@@ -2298,7 +2623,7 @@ lbool Solver::solve_()
     if (starts == 0) {
         VSIDS = true;
         int init = 10000;
-        while (status == l_Undef && init > 0 /*&& withinBudget()*/)
+        while (status == l_Undef && init > 0 && withinBudget())
             status = search(init);
         VSIDS = false;
     }
@@ -2311,15 +2636,13 @@ lbool Solver::solve_()
     size_t dupl_db_size_limit = dupl_db_init_size;
 
     // Search:
-    static uint64_t curr_restarts = 0;
     uint64_t curr_props = 0;
     uint32_t removed_duplicates =0;
-    while (status == l_Undef && !timeout /*&& withinBudget()*/){
+    while (status == l_Undef && !timeout && withinBudget()){
         if (dupl_db_size >= dupl_db_size_limit){    
            /* printf("c Duplicate learnts added (Minimization) %i\n",duplicates_added_minimization);    
             printf("c Duplicate learnts added (conflicts) %i\n",duplicates_added_conflicts);    
             printf("c Duplicate learnts added (tier2) %i\n",duplicates_added_tier2);    
-            printf("c Duptime: %i\n",duptime.count());
             printf("c Number of conflicts: %i\n",conflicts);
             printf("c Core size: %i\n",learnts_core.size());*/
             
@@ -81,6 +81,7 @@ private:
         vec<T> q;
     public:
         MyQueue(int sz) : max_sz(sz), q_sz(0), ptr(0), sum(0) { assert(sz > 0); q.growTo(sz); }
+        MyQueue(const MyQueue& other) : max_sz(other.max_sz), q_sz(other.q_sz), ptr(other.ptr), sum(other.sum) { other.q.copyTo(q); }
         inline bool   full () const { return q_sz == max_sz; }
 #ifdef INT_QUEUE_AVG
         inline T      avg  () const { assert(full()); return sum / max_sz; }
@@ -102,6 +103,7 @@ public:
     // Constructor/Destructor:
     //
     Solver();
+    Solver(const Solver & s);
     virtual ~Solver();
 
     // Problem specification:
@@ -126,6 +128,8 @@ public:
     bool    solve        (Lit p, Lit q);            // Search for a model that respects two assumptions.
     bool    solve        (Lit p, Lit q, Lit r);     // Search for a model that respects three assumptions.
     bool    okay         () const;                  // FALSE means solver is in a conflicting state
+    void    getPhases    (vec<Lit>& lits);              // Saved phases, as literals.
+    void    setPhases    (const vec<Lit>& lits);        // Set the saved phases from a list of literals.
 
     void    toDimacs     (FILE* f, const vec<Lit>& assumps);            // Write CNF to file in DIMACS-format.
     void    toDimacs     (const char *file, const vec<Lit>& assumps);
@@ -205,6 +209,8 @@ public:
     vec<double>         activity_CHB,     // A heuristic measurement of the activity of a variable.
     activity_VSIDS,activity_distance;
     int 				chrono;
+    int 				confl_to_chrono;
+    uint64_t            distance_confl;   // Number of conflicts searched with the distance heuristic.
 
     vec<Lit> importedClause;
     void *   issuer;                                            // used as the callback parameter
@@ -214,7 +220,8 @@ public:
 
     Lit  (* cbkImportUnit)  (void *);
     bool (* cbkImportClause)(void *, int *, vec<Lit> &);
-    void (* cbkExportClause)(void *, int, vec<Lit> &);	        // callback for clause learning
+    bool (* cbkExportClause)(void *, int, vec<Lit> &);	        // callback for clause learning, true to put the clause in the core tier
+    void (* cbkRestart)     (void *);                           // callback called at each restart
 
     vec<char>           polarity;         // The preferred polarity of each variable.
     bool verso;
@@ -226,7 +233,6 @@ public:
     uint32_t       min_number_of_learnts_copies;    
     uint32_t       dupl_db_init_size;
     uint32_t       max_lbd_dup;
-    std::chrono::microseconds duptime;
     // duplicate learnts version
 
     // Statistics: (read-only member variable)
@@ -234,6 +240,7 @@ public:
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts, conflicts_VSIDS;
     uint64_t dec_vars, clauses_literals, learnts_literals, max_literals, tot_literals;
     uint64_t chrono_backtrack, non_chrono_backtrack;
+    uint64_t learnts_lbd, learnts_units;   // Sum of the LBD of the learnt clauses, number of learnt units.
 
 
     // duplicate learnts version
@@ -331,12 +338,17 @@ protected:
     ClauseAllocator     ca;
     
     // duplicate learnts version    
-    std::map<int32_t,std::map<uint32_t,std::unordered_map<uint64_t,uint32_t>>>  ht;
+    // Open addressing table of the learnt clauses: the high bits of an entry
+    // are the fingerprint of a clause, the low bits its number of copies
+    // (at least 1, so 0 marks an empty entry).
+    std::vector<uint64_t> ht;
+    uint64_t     ht_used;                             // Number of non empty entries of ht
+    vec<uint32_t> ht_lits;                            // Sorted literals of the clause looked up
+    vec<uint64_t> ht_kept;                            // Entries kept by resizeduplicates
     uint32_t     reduceduplicates         ();         // Reduce the duplicates DB
+    void         resizeduplicates         (uint64_t capacity); // Rebuild ht with a given power of two capacity
     // duplicate learnts version
 
-    int 				confl_to_chrono;
-
     // Temporaries (to reduce allocation overhead). Each variable is prefixed by the method in which it is
     // used, exept 'seen' wich is used in several places.
     //
@@ -370,6 +382,8 @@ protected:
     void     cancelUntil      (int level);                                             // Backtrack until a certain level.
     void     analyze          (CRef confl, vec<Lit>& out_learnt, int& out_btlevel, int& out_lbd);    // (bt = backtrack)
     void     analyzeFinal     (Lit p, vec<Lit>& out_conflict);                         // COULD THIS BE IMPLEMENTED BY THE ORDINARIY "analyze" BY SOME REASONABLE GENERALIZATION?
+    void     analyzeFinal     (CRef confl, vec<Lit>& out_conflict);                    // Express a conflict in terms of the decisions.
+    void     analyzeFinalSeen (vec<Lit>& out_conflict);                                // (helper method for 'analyzeFinal()')
     bool     litRedundant     (Lit p, uint32_t abstract_levels);                       // (helper method for 'analyze()')
     lbool    search           (int& nof_conflicts);                                    // Search for a given number of conflicts.
     lbool    solve_           ();                                                      // Main solve method (assumptions given in 'assumptions').
@@ -398,7 +412,7 @@ protected:
     void     relocAll         (ClauseAllocator& to);
 
 // duplicate learnts version
-    int     is_duplicate     (std::vector<uint32_t>&c); //returns TRUE if a clause is duplicate
+    int     is_duplicate     (const Lit* c, int sz); //returns the number of copies of a clause, 0 for the first one
 // duplicate learnts version
 
     // Misc:
@@ -494,6 +508,9 @@ public:
     void	cancelUntilTrailRecord();
     void	simpleUncheckEnqueue(Lit p, CRef from = CRef_Undef);
     CRef    simplePropagate();
+    bool    vivifyClause (const vec<Lit>& lits, vec<Lit>& out_clause); // Propagate the negation of a clause, see definition.
+    void    copyIrredundant(Solver& to);                 // Add the level 0 units and the irredundant clauses to another solver.
+    void    getLearntsToVivify(int max, vec<Lit>& lits, vec<int>& sizes, vec<int>& lbds); // Core and tier2 learnts not simplified yet, see definition.
     uint64_t nbSimplifyAll;
     uint64_t simplified_length_record, original_length_record;
     uint64_t s_propagations;
@@ -516,6 +533,7 @@ public:
     vec<int> pathCs;
     CRef propagateLits(vec<Lit>& lits);
     uint64_t previousStarts;
+    uint64_t curr_restarts;                      // Position in the luby sequence, kept between the solves.
     double var_iLevel_inc;
     vec<Lit> involved_lits;
     double    my_var_decay;
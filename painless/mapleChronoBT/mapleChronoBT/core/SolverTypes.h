@@ -336,6 +336,14 @@ public:
         dirty  .clear(free);
         dirties.clear(free);
     }
+
+    void copyTo(OccLists &copy) const {
+        copy.occs.growTo(occs.size());
+        for(int i = 0;i<occs.size();i++)
+            occs[i].memCopyTo(copy.occs[i]);
+        dirty.memCopyTo(copy.dirty);
+        dirties.memCopyTo(copy.dirties);
+    }
 };
 
 
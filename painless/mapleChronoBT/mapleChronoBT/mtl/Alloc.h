@@ -79,6 +79,14 @@ class RegionAllocator
         sz = cap = wasted_ = 0;
     }
 
+    void copyTo(RegionAllocator& to) const {
+        to.memory = (T*)xrealloc(to.memory, sizeof(T)*cap);
+        memcpy(to.memory,memory,sizeof(T)*cap);
+        to.sz = sz;
+        to.cap = cap;
+        to.wasted_ = wasted_;
+    }
+
 
 };
 
@@ -39,6 +39,11 @@ public:
     Queue() : buf(1), first(0), end(0) {}
 
     void clear (bool dealloc = false) { buf.clear(dealloc); buf.growTo(1); first = end = 0; }
+    void copyTo(Queue<T>& copy) const {
+        copy.first = first;
+        copy.end = end;
+        buf.memCopyTo(copy.buf);
+    }
     int  size  () const { return (end >= first) ? end - first : end - first + buf.size(); }
 
     const T& operator [] (int index) const  { assert(index >= 0); assert(index < size()); return buf[(first + index) % buf.size()]; }
@@ -77,6 +77,40 @@ SimpSolver::SimpSolver() :
 }
 
 
+SimpSolver::SimpSolver(const SimpSolver &s) : Solver(s)
+  , parsing            (s.parsing)
+  , grow               (s.grow)
+  , clause_lim         (s.clause_lim)
+  , subsumption_lim    (s.subsumption_lim)
+  , simp_garbage_frac  (s.simp_garbage_frac)
+  , use_asymm          (s.use_asymm)
+  , use_rcheck         (s.use_rcheck)
+  , use_elim           (s.use_elim)
+  , merges             (s.merges)
+  , asymm_lits         (s.asymm_lits)
+  , eliminated_vars    (s.eliminated_vars)
+  , elimorder          (s.elimorder)
+  , use_simplification (s.use_simplification)
+  , occurs             (ClauseDeleted(ca))
+  , elim_heap          (ElimLt(n_occ))
+  , bwdsub_assigns     (s.bwdsub_assigns)
+  , n_touched          (s.n_touched)
+{
+  // The clause allocator has been copied, the dummy clause with it
+  bwdsub_tmpunit        = s.bwdsub_tmpunit;
+  remove_satisfied      = s.remove_satisfied;
+
+  s.elimclauses.memCopyTo(elimclauses);
+  s.touched.memCopyTo(touched);
+  s.occurs.copyTo(occurs);
+  s.n_occ.memCopyTo(n_occ);
+  s.elim_heap.copyTo(elim_heap);
+  s.subsumption_queue.copyTo(subsumption_queue);
+  s.frozen.memCopyTo(frozen);
+  s.eliminated.memCopyTo(eliminated);
+}
+
+
 SimpSolver::~SimpSolver()
 {
 }
@@ -43,6 +43,7 @@ class SimpSolver : public Solver {
     // Constructor/Destructor:
     //
     SimpSolver();
+    SimpSolver(const SimpSolver & s);
     ~SimpSolver();
 
     // Problem specification:
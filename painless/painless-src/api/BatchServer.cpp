@@ -0,0 +1,462 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#include "../api/BatchServer.h"
+#include "../clauses/ClauseManager.h"
+#include "../painless.h"
+#include "../sharing/HordeSatSharing.h"
+#include "../solvers/SolverFactory.h"
+#include "../utils/Logger.h"
+#include "../utils/Parameters.h"
+#include "../utils/System.h"
+
+#include <ctype.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <zlib.h>
+
+using namespace std;
+
+// Main executed by the thread of each lane
+void * mainLane(void * arg)
+{
+   BatchServer::Lane * lane = (BatchServer::Lane *)arg;
+   BatchServer * server     = lane->server;
+
+   pthread_mutex_lock(&server->mutexLanes);
+
+   while (true) {
+      while (lane->job.empty() && server->stopLanes == false) {
+         pthread_cond_wait(&server->condLanes, &server->mutexLanes);
+      }
+
+      if (lane->job.empty())
+         break;
+
+      string path = lane->job;
+      FILE * out  = lane->out;
+
+      pthread_mutex_unlock(&server->mutexLanes);
+
+      server->run(vector<BatchServer::Lane *>(1, lane), path, out);
+
+      pthread_mutex_lock(&server->mutexLanes);
+
+      lane->job.clear();
+
+      pthread_cond_broadcast(&server->condLanes);
+   }
+
+   pthread_mutex_unlock(&server->mutexLanes);
+
+   return NULL;
+}
+
+// Return the number of clauses of the header of a dimacs file, -1 if the
+// file cannot be read
+static int countClauses(const string & path)
+{
+   gzFile in = gzopen(path.c_str(), "rb");
+
+   if (in == NULL)
+      return -1;
+
+   char line[1024];
+   int vars, clauses = -1;
+
+   while (gzgets(in, line, sizeof(line)) != NULL) {
+      if (sscanf(line, "p cnf %d %d", &vars, &clauses) == 2)
+         break;
+
+      if (line[0] != 'c' && line[0] != 'p' && line[0] != '\n')
+         break;
+   }
+
+   gzclose(in);
+
+   return clauses;
+}
+
+BatchServer::BatchServer(int nThreads)
+{
+   int laneSize = Parameters::getIntParam("srv-lane", 4);
+   if (laneSize < 1 || laneSize > nThreads)
+      laneSize = nThreads;
+
+   int nLanes = nThreads / laneSize;
+   if (nLanes < 1)
+      nLanes = 1;
+
+   pthread_mutex_init(&mutexLanes, NULL);
+   pthread_cond_init (&condLanes, NULL);
+
+   stopLanes = false;
+
+   ClauseManager::initClauseManager();
+
+   whole = new IncrementalPortfolio();
+
+   for (int i = 0; i < nLanes; i++) {
+      Lane * lane = new Lane();
+
+      // The workers start with empty solvers, replaced by each instance
+      vector<SolverInterface *> solvers;
+      for (int j = 0; j < laneSize; j++) {
+         solvers.push_back(SolverFactory::createIncrementalMapleCOMSPSSolver());
+      }
+
+      lane->server    = this;
+      lane->out       = NULL;
+      lane->sharer    = new Sharer(i + 1, new HordeSatSharing(), solvers,
+                                   solvers);
+      lane->portfolio = new IncrementalPortfolio();
+
+      for (int j = 0; j < laneSize; j++) {
+         lane->workers.push_back(new SequentialWorker(solvers[j]));
+         lane->portfolio->addSlave(lane->workers[j]);
+      }
+
+      lanes.push_back(lane);
+
+      lane->thread = new Thread(mainLane, lane);
+   }
+
+   log(1, "BatchServer %d lanes of %d workers\n", nLanes, laneSize);
+}
+
+BatchServer::~BatchServer()
+{
+   pthread_mutex_lock(&mutexLanes);
+   stopLanes = true;
+   pthread_cond_broadcast(&condLanes);
+   pthread_mutex_unlock(&mutexLanes);
+
+   for (size_t i = 0; i < lanes.size(); i++) {
+      lanes[i]->thread->join();
+      delete lanes[i]->thread;
+   }
+
+   // The sharers and the workers stop
+   setGlobalEnding();
+
+   for (size_t i = 0; i < lanes.size(); i++) {
+      delete lanes[i]->sharer;
+
+      // The workers release their solvers
+      delete lanes[i]->portfolio;
+      delete lanes[i];
+   }
+
+   delete whole;
+
+   ClauseManager::joinClauseManager();
+
+   pthread_mutex_destroy(&mutexLanes);
+   pthread_cond_destroy (&condLanes);
+}
+
+bool
+BatchServer::serve(FILE * in, FILE * out)
+{
+   int small  = Parameters::getIntParam("srv-small", 100000);
+   bool alive = true;
+
+   char * line = NULL;
+   size_t cap  = 0;
+
+   while (getline(&line, &cap, in) != -1) {
+      string path(line);
+
+      while (path.empty() == false && isspace(path.back())) {
+         path.pop_back();
+      }
+
+      if (path.empty())
+         continue;
+
+      if (path == "shutdown") {
+         alive = false;
+         break;
+      }
+
+      int clauses = countClauses(path);
+
+      if (clauses < 0) {
+         writeResult(out, path, "ERROR", 0, 0, vector<int>());
+      } else if (clauses <= small) {
+         Lane * lane = waitLane();
+
+         pthread_mutex_lock(&mutexLanes);
+         lane->job = path;
+         lane->out = out;
+         pthread_cond_broadcast(&condLanes);
+         pthread_mutex_unlock(&mutexLanes);
+      } else {
+         waitIdle();
+         run(lanes, path, out);
+      }
+   }
+
+   free(line);
+
+   waitIdle();
+
+   return alive;
+}
+
+bool
+BatchServer::serveSocket(const char * path)
+{
+   struct sockaddr_un addr;
+
+   if (strlen(path) >= sizeof(addr.sun_path))
+      return false;
+
+   memset(&addr, 0, sizeof(addr));
+   addr.sun_family = AF_UNIX;
+   strcpy(addr.sun_path, path);
+
+   int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+   if (fd < 0)
+      return false;
+
+   unlink(path);
+
+   if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0 ||
+       listen(fd, 16) < 0) {
+      close(fd);
+      return false;
+   }
+
+   bool alive = true;
+
+   while (alive) {
+      int conn = accept(fd, NULL, NULL);
+
+      if (conn < 0)
+         continue;
+
+      FILE * in  = fdopen(conn, "r");
+      FILE * out = fdopen(dup(conn), "w");
+
+      alive = serve(in, out);
+
+      fclose(out);
+      fclose(in);
+   }
+
+   close(fd);
+   unlink(path);
+
+   return true;
+}
+
+void
+BatchServer::run(const vector<Lane *> & group, const string & path,
+                 FILE * out)
+{
+   double start = getRelativeTime();
+
+   vector<SequentialWorker *> workers;
+
+   for (size_t i = 0; i < group.size(); i++) {
+      workers.insert(workers.end(), group[i]->workers.begin(),
+                     group[i]->workers.end());
+   }
+
+   // Fresh solvers, diversified as in the main: the formula is parsed once
+   // and copied while the memory allows it
+   vector<SolverInterface *> solvers;
+   vector<SolverInterface *> solvers_LRB;
+   vector<SolverInterface *> solvers_VSIDS;
+
+   SolverFactory::createMapleCOMSPSSolvers(workers.size(), solvers,
+                                           path.c_str());
+
+   for (size_t i = 0; i < solvers.size(); i++) {
+      if (i % 2) {
+         solvers_LRB.push_back(solvers[i]);
+      } else {
+         solvers_VSIDS.push_back(solvers[i]);
+      }
+   }
+
+   SolverFactory::nativeDiversification(solvers);
+   SolverFactory::sparseRandomDiversification(solvers_LRB);
+   SolverFactory::sparseRandomDiversification(solvers_VSIDS);
+
+   // The workers are idle, their sharer drops the old solvers before the
+   // new ones share their clauses. The workers left without a solver get an
+   // empty one and stay out of the sharer and of the portfolio for this run.
+   for (size_t i = 0, k = 0; i < group.size(); i++) {
+      for (size_t j = 0; j < group[i]->workers.size(); j++, k++) {
+         SequentialWorker * worker = group[i]->workers[j];
+         SolverInterface * old     = worker->solver;
+
+         if (k < solvers.size()) {
+            group[i]->sharer->replaceSolver(old, solvers[k]);
+            worker->solver = solvers[k];
+         } else {
+            group[i]->sharer->removeProducer(old);
+            group[i]->sharer->removeConsumer(old);
+            group[i]->portfolio->removeSlave(worker);
+            worker->solver =
+               SolverFactory::createIncrementalMapleCOMSPSSolver();
+         }
+
+         old->release();
+      }
+   }
+
+   if (solvers.size() < workers.size()) {
+      log(1, "BatchServer %s runs on %zu workers out of %zu, memory limit\n",
+          path.c_str(), solvers.size(), workers.size());
+   }
+
+   IncrementalPortfolio * portfolio = group[0]->portfolio;
+
+   if (group.size() > 1) {
+      portfolio = whole;
+
+      for (size_t i = 0, k = 0; i < group.size(); i++) {
+         for (size_t j = 0; j < group[i]->workers.size(); j++, k++) {
+            if (k >= solvers.size())
+               continue;
+
+            group[i]->portfolio->removeSlave(group[i]->workers[j]);
+            whole->addSlave(group[i]->workers[j]);
+         }
+      }
+   }
+
+   vector<int> cube;
+   vector<int> model;
+
+   portfolio->solve(cube);
+
+   SatResult res = portfolio->waitResult(model,
+                                         Parameters::getIntParam("t", -1));
+
+   if (group.size() > 1) {
+      for (size_t i = 0, k = 0; i < group.size(); i++) {
+         for (size_t j = 0; j < group[i]->workers.size(); j++, k++) {
+            if (k >= solvers.size())
+               continue;
+
+            whole->removeSlave(group[i]->workers[j]);
+            group[i]->portfolio->addSlave(group[i]->workers[j]);
+         }
+      }
+   }
+
+   // The unused workers are back, with their empty solver
+   for (size_t i = 0, k = 0; i < group.size(); i++) {
+      for (size_t j = 0; j < group[i]->workers.size(); j++, k++) {
+         if (k < solvers.size())
+            continue;
+
+         SequentialWorker * worker = group[i]->workers[j];
+
+         group[i]->sharer->addProducer(worker->solver);
+         group[i]->sharer->addConsumer(worker->solver);
+         group[i]->portfolio->addSlave(worker);
+      }
+   }
+
+   if (res != SAT) {
+      model.clear();
+   }
+
+   writeResult(out, path, res == SAT ? "SAT" : res == UNSAT ? "UNSAT" :
+               "UNKNOWN", getRelativeTime() - start, solvers.size(), model);
+}
+
+BatchServer::Lane *
+BatchServer::waitLane()
+{
+   Lane * idle = NULL;
+
+   pthread_mutex_lock(&mutexLanes);
+
+   while (idle == NULL) {
+      for (size_t i = 0; i < lanes.size() && idle == NULL; i++) {
+         if (lanes[i]->job.empty())
+            idle = lanes[i];
+      }
+
+      if (idle == NULL)
+         pthread_cond_wait(&condLanes, &mutexLanes);
+   }
+
+   pthread_mutex_unlock(&mutexLanes);
+
+   return idle;
+}
+
+void
+BatchServer::waitIdle()
+{
+   pthread_mutex_lock(&mutexLanes);
+
+   for (size_t i = 0; i < lanes.size(); i++) {
+      while (lanes[i]->job.empty() == false) {
+         pthread_cond_wait(&condLanes, &mutexLanes);
+      }
+   }
+
+   pthread_mutex_unlock(&mutexLanes);
+}
+
+void
+BatchServer::writeResult(FILE * out, const string & path, const char * result,
+                         double time, int threads, const vector<int> & model)
+{
+   string file;
+
+   for (size_t i = 0; i < path.size(); i++) {
+      if (path[i] == '"' || path[i] == '\\')
+         file += '\\';
+
+      file += path[i];
+   }
+
+   outputLock.lock();
+
+   fprintf(out, "{\"file\": \"%s\", \"result\": \"%s\", \"time\": %.3f, "
+           "\"threads\": %d", file.c_str(), result, time, threads);
+
+   if (Parameters::getBoolParam("srv-model") && model.empty() == false) {
+      fprintf(out, ", \"model\": [");
+
+      for (size_t i = 0; i < model.size(); i++) {
+         fprintf(out, i ? ", %d" : "%d", model[i]);
+      }
+
+      fprintf(out, "]");
+   }
+
+   fprintf(out, "}\n");
+   fflush(out);
+
+   outputLock.unlock();
+}
@@ -0,0 +1,121 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "../sharing/Sharer.h"
+#include "../utils/Threading.h"
+#include "../working/IncrementalPortfolio.h"
+#include "../working/SequentialWorker.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Main executed by the thread of each lane
+static void * mainLane(void * arg);
+
+/// Server solving a stream of instances with one pool of workers and
+/// sharers. The pool is split in lanes of srv-lane workers, each lane has
+/// its own sharer. An instance with at most srv-small clauses runs on one
+/// lane, several of them at a time; a larger one waits for every lane and
+/// runs on the whole pool. The threads are kept between two instances, the
+/// solvers of the workers are replaced by fresh ones.
+///
+/// Each input line is the path of a dimacs file. Each result is written as
+/// one JSON line, in the order of completion.
+class BatchServer
+{
+public:
+   /// Create a pool of nThreads workers.
+   BatchServer(int nThreads);
+
+   /// Stop the threads and delete the solvers.
+   ~BatchServer();
+
+   /// Solve the instances read from in, write the results to out. Return
+   /// false when the line "shutdown" is read.
+   bool serve(FILE * in, FILE * out);
+
+   /// Serve the connections of a Unix socket one after the other, until one
+   /// of them asks to shutdown. Return false if the socket cannot be used.
+   bool serveSocket(const char * path);
+
+protected:
+   friend void * mainLane(void * arg);
+
+   /// Group of workers sharing their clauses.
+   struct Lane
+   {
+      BatchServer * server;
+
+      /// Strategy of the lane when it runs an instance alone.
+      IncrementalPortfolio * portfolio;
+
+      /// Workers of the lane.
+      vector<SequentialWorker *> workers;
+
+      /// Sharer between the solvers of the workers.
+      Sharer * sharer;
+
+      /// Thread running the instances given to the lane.
+      Thread * thread;
+
+      /// Path of the instance given to the lane, empty if idle.
+      string job;
+
+      /// Stream of the result of the instance.
+      FILE * out;
+   };
+
+   /// Solve an instance on a set of lanes, write its result.
+   void run(const vector<Lane *> & group, const string & path, FILE * out);
+
+   /// Wait for an idle lane.
+   Lane * waitLane();
+
+   /// Wait until every lane is idle.
+   void waitIdle();
+
+   /// Write a result line.
+   void writeResult(FILE * out, const string & path, const char * result,
+                    double time, int threads, const vector<int> & model);
+
+   /// Lanes of the pool.
+   vector<Lane *> lanes;
+
+   /// Strategy running an instance on the whole pool.
+   IncrementalPortfolio * whole;
+
+   /// Protect the jobs of the lanes.
+   pthread_mutex_t mutexLanes;
+
+   /// Signaled when a lane gets a job or becomes idle.
+   pthread_cond_t condLanes;
+
+   /// Used to stop the threads of the lanes.
+   bool stopLanes;
+
+   /// Protect the output streams.
+   Mutex outputLock;
+};
@@ -0,0 +1,135 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#include "../api/PainlessSolver.h"
+#include "../clauses/ClauseManager.h"
+#include "../painless.h"
+#include "../sharing/HordeSatSharing.h"
+#include "../solvers/SolverFactory.h"
+#include "../working/SequentialWorker.h"
+
+using namespace std;
+
+PainlessSolver::PainlessSolver(int nSolvers)
+{
+   if (nSolvers < 1)
+      nSolvers = 1;
+
+   for (int i = 0; i < nSolvers; i++) {
+      solvers.push_back(SolverFactory::createIncrementalMapleCOMSPSSolver());
+   }
+
+   SolverFactory::nativeDiversification(solvers);
+
+   // Every solver exports to and imports from the others
+   sharerList.push_back(new Sharer(1, new HordeSatSharing(), solvers,
+                                   solvers));
+
+   nSharers = sharerList.size();
+   sharers  = sharerList.data();
+
+   ClauseManager::initClauseManager();
+
+   portfolio = new IncrementalPortfolio();
+   working   = portfolio;
+
+   for (int i = 0; i < nSolvers; i++) {
+      portfolio->addSlave(new SequentialWorker(solvers[i]));
+   }
+}
+
+PainlessSolver::~PainlessSolver()
+{
+   // The sharers and the workers stop at the end of the search
+   portfolio->setInterrupt();
+   setGlobalEnding();
+
+   for (size_t i = 0; i < sharerList.size(); i++) {
+      delete sharerList[i];
+   }
+
+   // The workers release the solvers
+   delete portfolio;
+
+   ClauseManager::joinClauseManager();
+
+   sharers      = NULL;
+   nSharers     = 0;
+   working      = NULL;
+   globalEnding = false;
+}
+
+void
+PainlessSolver::addClause(const vector<int> & cls)
+{
+   ClauseExchange * ncls = ClauseManager::allocClause(cls.size());
+
+   for (size_t i = 0; i < cls.size(); i++) {
+      ncls->lits[i] = cls[i];
+   }
+
+   // One reference per solver
+   ClauseManager::increaseClause(ncls, solvers.size() - 1);
+
+   for (size_t i = 0; i < solvers.size(); i++) {
+      solvers[i]->addClause(ncls);
+   }
+}
+
+SatResult
+PainlessSolver::solve(const vector<int> & assumptions)
+{
+   vector<int> res;
+
+   model.clear();
+   failed.clear();
+
+   portfolio->solve(assumptions);
+
+   SatResult result = portfolio->waitResult(res);
+
+   if (result == SAT) {
+      model = res;
+   } else if (result == UNSAT) {
+      // The final analysis is a clause made of negated assumptions
+      for (size_t i = 0; i < res.size(); i++) {
+         failed.push_back(-res[i]);
+      }
+   }
+
+   return result;
+}
+
+void
+PainlessSolver::interrupt()
+{
+   portfolio->setInterrupt();
+}
+
+const vector<int> &
+PainlessSolver::getModel()
+{
+   return model;
+}
+
+const vector<int> &
+PainlessSolver::getFailedAssumptions()
+{
+   return failed;
+}
@@ -0,0 +1,78 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "../sharing/Sharer.h"
+#include "../solvers/SolverInterface.h"
+#include "../working/IncrementalPortfolio.h"
+
+#include <vector>
+
+using namespace std;
+
+/// Incremental API of the framework, built in libpainless.a. The solvers,
+/// their threads, their learnt clauses and the sharers stay alive between
+/// two calls to solve. The options are the ones of the command line, they
+/// are read with Parameters, e.g. shr-sleep and lbd-limit.
+///
+/// The framework uses global variables: only one instance may exist at a
+/// time. Clauses are added between two calls to solve.
+class PainlessSolver
+{
+public:
+   /// Create nSolvers diversified CDCL solvers sharing their clauses.
+   PainlessSolver(int nSolvers);
+
+   /// Stop the threads and delete the solvers.
+   ~PainlessSolver();
+
+   /// Add a permanent clause, as a list of non zero literals.
+   void addClause(const vector<int> & cls);
+
+   /// Solve the formula under assumptions. Return SAT, UNSAT, or UNKNOWN if
+   /// interrupted.
+   SatResult solve(const vector<int> & assumptions);
+
+   /// Interrupt the current solve, can be called from another thread.
+   void interrupt();
+
+   /// Model of the last SAT result.
+   const vector<int> & getModel();
+
+   /// Assumptions responsible for the last UNSAT result, empty if the
+   /// formula is UNSAT without assumptions.
+   const vector<int> & getFailedAssumptions();
+
+protected:
+   /// CDCL solvers.
+   vector<SolverInterface *> solvers;
+
+   /// Sharers of the learnt clauses.
+   vector<Sharer *> sharerList;
+
+   /// Top strategy, its workers wait for the next solve between two calls.
+   IncrementalPortfolio * portfolio;
+
+   /// Model of the last SAT result.
+   vector<int> model;
+
+   /// Failed assumptions of the last UNSAT result.
+   vector<int> failed;
+};
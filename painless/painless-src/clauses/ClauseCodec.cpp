@@ -0,0 +1,283 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#include "../clauses/ClauseCodec.h"
+#include "../clauses/ClauseManager.h"
+
+#include <algorithm>
+#include <stdlib.h>
+
+using namespace std;
+
+// Write a varint, return the position after it
+static inline uint8_t * writeVarint(uint8_t * p, uint32_t value)
+{
+   while (value >= 0x80) {
+      *p++    = (value & 0x7f) | 0x80;
+      value >>= 7;
+   }
+
+   *p++ = value;
+
+   return p;
+}
+
+// Read a varint, return false if the buffer ends before it
+static inline bool readVarint(const uint8_t *& p, const uint8_t * end,
+                              uint32_t & value)
+{
+   value = 0;
+
+   for (int shift = 0; p < end && shift < 35; shift += 7) {
+      uint8_t byte = *p++;
+
+      value |= (uint32_t)(byte & 0x7f) << shift;
+
+      if ((byte & 0x80) == 0)
+         return true;
+   }
+
+   return false;
+}
+
+ClauseCodec::ClauseCodec(int dictSize)
+{
+   this->dictSize = dictSize;
+}
+
+void
+ClauseCodec::buildDictionary(const vector<ClauseExchange *> & clauses)
+{
+   dict.clear();
+
+   if (dictSize <= 0)
+      return;
+
+   for (size_t i = 0; i < clauses.size(); i++) {
+      for (int k = 0; k < clauses[i]->size; k++) {
+         int var = abs(clauses[i]->lits[k]);
+
+         if (var >= (int)occurrences.size()) {
+            occurrences.resize(2 * var + 1, 0);
+            dictPos.resize(2 * var + 1, 0);
+         }
+
+         if (occurrences[var]++ == 0)
+            vars.push_back(var);
+      }
+   }
+
+   // A variable in the dictionary costs its code once
+   int n = min((int)vars.size(), dictSize);
+
+   partial_sort(vars.begin(), vars.begin() + n, vars.end(),
+                [this](int a, int b) {
+                   return occurrences[a] > occurrences[b];
+                });
+
+   for (int i = 0; i < n && occurrences[vars[i]] > 1; i++) {
+      dict.push_back(vars[i]);
+      dictPos[vars[i]] = dict.size();
+   }
+
+   for (size_t i = 0; i < vars.size(); i++) {
+      occurrences[vars[i]] = 0;
+   }
+
+   vars.clear();
+}
+
+void
+ClauseCodec::encode(const vector<ClauseExchange *> & clauses,
+                    vector<uint8_t> & out)
+{
+   buildDictionary(clauses);
+
+   uint32_t n = dict.size();
+
+   // Sorted codes of each clause
+   codes.clear();
+   starts.clear();
+   order.clear();
+
+   for (size_t i = 0; i < clauses.size(); i++) {
+      starts.push_back(codes.size());
+      order.push_back(i);
+
+      for (int k = 0; k < clauses[i]->size; k++) {
+         int lit  = clauses[i]->lits[k];
+         int var  = abs(lit);
+         int pos  = var < (int)dictPos.size() ? dictPos[var] : 0;
+         uint32_t id = pos > 0 ? pos : var + n;
+
+         codes.push_back(2 * id + (lit < 0));
+      }
+
+      // Insertion sort, the shared clauses are short
+      uint32_t * c = codes.data() + starts[i];
+
+      for (int k = 1; k < clauses[i]->size; k++) {
+         uint32_t code = c[k];
+         int j         = k;
+
+         for (; j > 0 && c[j - 1] > code; j--) {
+            c[j] = c[j - 1];
+         }
+
+         c[j] = code;
+      }
+   }
+
+   sort(order.begin(), order.end(), [this, &clauses](int a, int b) {
+      int sa = clauses[a]->size;
+      int sb = clauses[b]->size;
+
+      if (sa != sb)
+         return sa < sb;
+
+      return lexicographical_compare(codes.begin() + starts[a],
+                                     codes.begin() + starts[a] + sa,
+                                     codes.begin() + starts[b],
+                                     codes.begin() + starts[b] + sb);
+   });
+
+   // At most 5 bytes per number
+   size_t offset = out.size();
+
+   out.resize(offset + 5 * (2 + n + 2 * clauses.size() + codes.size()));
+
+   uint8_t * p = out.data() + offset;
+
+   p = writeVarint(p, clauses.size());
+   p = writeVarint(p, n);
+
+   for (uint32_t i = 0; i < n; i++) {
+      p = writeVarint(p, dict[i]);
+      dictPos[dict[i]] = 0;
+   }
+
+   uint32_t prevSize  = 0;
+   uint32_t prevFirst = 0;
+
+   for (size_t i = 0; i < order.size(); i++) {
+      ClauseExchange * cls = clauses[order[i]];
+      const uint32_t * c   = codes.data() + starts[order[i]];
+      uint32_t size        = cls->size;
+
+      p = writeVarint(p, size - prevSize);
+      p = writeVarint(p, cls->lbd);
+
+      for (uint32_t k = 0; k < size; k++) {
+         uint32_t base = k > 0 ? c[k - 1] : size == prevSize ? prevFirst : 0;
+
+         p = writeVarint(p, c[k] - base);
+      }
+
+      prevSize  = size;
+      prevFirst = size > 0 ? c[0] : 0;
+   }
+
+   out.resize(p - out.data());
+}
+
+size_t
+ClauseCodec::decode(const uint8_t * data, size_t size,
+                    vector<ClauseExchange *> & clauses)
+{
+   const uint8_t * p   = data;
+   const uint8_t * end = data + size;
+
+   uint32_t count, n, value;
+
+   if (readVarint(p, end, count) == false || readVarint(p, end, n) == false)
+      return 0;
+
+   dict.resize(n);
+
+   for (uint32_t i = 0; i < n; i++) {
+      if (readVarint(p, end, value) == false)
+         return 0;
+
+      dict[i] = value;
+   }
+
+   size_t first = clauses.size();
+
+   uint32_t prevSize  = 0;
+   uint32_t prevFirst = 0;
+
+   bool ok = true;
+
+   for (uint32_t i = 0; i < count && ok; i++) {
+      uint32_t delta, lbd;
+
+      ok = readVarint(p, end, delta) && readVarint(p, end, lbd);
+
+      uint32_t clsSize = prevSize + delta;
+
+      // Each literal takes at least one byte
+      if (ok == false || (size_t)(end - p) < clsSize) {
+         ok = false;
+         break;
+      }
+
+      ClauseExchange * cls = ClauseManager::allocClause(clsSize);
+
+      cls->lbd  = lbd;
+      cls->from = -1;
+
+      clauses.push_back(cls);
+
+      uint32_t code = clsSize == prevSize ? prevFirst : 0;
+
+      for (uint32_t k = 0; k < clsSize && ok; k++) {
+         ok = readVarint(p, end, value);
+
+         code += value;
+
+         uint32_t id = code >> 1;
+         int var     = id <= n ? (id > 0 ? dict[id - 1] : 0) : id - n;
+
+         cls->lits[k] = code & 1 ? -var : var;
+
+         if (k == 0)
+            prevFirst = code;
+
+         if (var == 0)
+            ok = false;
+      }
+
+      prevSize  = clsSize;
+      prevFirst = clsSize > 0 ? prevFirst : 0;
+   }
+
+   // Malformed batch, nothing is decoded
+   if (ok == false) {
+      for (size_t i = first; i < clauses.size(); i++) {
+         ClauseManager::releaseClause(clauses[i]);
+      }
+
+      clauses.resize(first);
+
+      return 0;
+   }
+
+   return p - data;
+}
@@ -0,0 +1,78 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "../clauses/ClauseExchange.h"
+
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+/// Compact serialization of a batch of shared clauses, for the exchanges
+/// between processes. A literal is coded as 2 * var + sign. The literals of
+/// a clause are sorted and delta coded, the clauses are sorted by size then
+/// by literals so that the sizes and the first literals are delta coded
+/// from the previous clause. Every number is a varint, 7 bits per byte.
+/// With a dictionary, the most frequent variables of the batch get the
+/// smallest codes.
+class ClauseCodec
+{
+public:
+   /// Constructor, the dictionary has at most dictSize variables.
+   ClauseCodec(int dictSize = 0);
+
+   /// Encode a batch of clauses, append the bytes to out.
+   void encode(const vector<ClauseExchange *> & clauses, vector<uint8_t> & out);
+
+   /// Decode a batch, the clauses are allocated with the ClauseManager.
+   /// Return the number of bytes read, 0 if the batch is malformed.
+   size_t decode(const uint8_t * data, size_t size,
+                 vector<ClauseExchange *> & clauses);
+
+protected:
+   /// Choose the dictionary of a batch.
+   void buildDictionary(const vector<ClauseExchange *> & clauses);
+
+   /// Maximum size of the dictionary.
+   int dictSize;
+
+   /// Variables of the dictionary, the most frequent first.
+   vector<int> dict;
+
+   /// Position + 1 of each variable in the dictionary, 0 if not in it.
+   vector<int> dictPos;
+
+   /// Number of occurrences of each variable in the batch.
+   vector<int> occurrences;
+
+   /// Variables of the batch.
+   vector<int> vars;
+
+   /// Sorted codes of the clauses, one after the other.
+   vector<uint32_t> codes;
+
+   /// Position of each clause in codes.
+   vector<size_t> starts;
+
+   /// Clauses in the order of the encoding.
+   vector<int> order;
+};
@@ -17,11 +17,14 @@
 // this program.  If not, see <http://www.gnu.org/licenses/>.
 // -----------------------------------------------------------------------------
 
+
 #include "../clauses/ClauseDatabase.h"
 #include "../clauses/ClauseManager.h"
 #include "../clauses/ClauseExchange.h"
 #include "../utils/Logger.h"
+#include "../utils/Parameters.h"
 
+#include <algorithm>
 #include <string.h>
 #include <stdio.h>
 
@@ -29,29 +32,70 @@ using namespace std;
 
 ClauseDatabase::ClauseDatabase()
 {
+   bucketCap = Parameters::getIntParam("shr-db-cap", 1000);
+   maxAge    = Parameters::getIntParam("shr-db-age", 0);
+   round     = 0;
 }
 
 ClauseDatabase::~ClauseDatabase()
 {
+   for (size_t i = 0; i < buckets.size(); i++) {
+      for (size_t j = 0; j < buckets[i].size(); j++) {
+         for (size_t k = 0; k < buckets[i][j].size(); k++) {
+            ClauseManager::releaseClause(buckets[i][j][k].cls);
+         }
+      }
+   }
 }
 
 void
 ClauseDatabase::addClause(ClauseExchange * clause)
 {
-	int clsSize = clause->size;
+   unsigned clsSize = clause->size;
+   unsigned lbd     = max(1, min(clause->lbd, DATABASE_MAX_LBD));
+
+   if (buckets.size() < lbd) {
+      buckets.resize(lbd);
+   }
 
-	while (clauses.size() < clsSize) {
-      vector<ClauseExchange *> newVector;
-		clauses.push_back(newVector);
-	}
+   vector<vector<Entry> > & sizes = buckets[lbd - 1];
 
-   if ((clauses[clsSize-1].size() + 1) * clsSize < 1000) {
-      clauses[clsSize-1].push_back(clause);
+   if (sizes.size() < clsSize) {
+      sizes.resize(clsSize);
+   }
+
+   vector<Entry> & bucket = sizes[clsSize - 1];
+
+   if ((bucket.size() + 1) * clsSize < bucketCap) {
+      Entry entry;
+      entry.cls   = clause;
+      entry.round = round;
+
+      bucket.push_back(entry);
    } else {
       ClauseManager::releaseClause(clause);
    }
 }
 
+void
+ClauseDatabase::evict()
+{
+   for (size_t i = 0; i < buckets.size(); i++) {
+      for (size_t j = 0; j < buckets[i].size(); j++) {
+         vector<Entry> & bucket = buckets[i][j];
+
+         size_t old = 0;
+
+         while (old < bucket.size() && bucket[old].round + maxAge < round) {
+            ClauseManager::releaseClause(bucket[old].cls);
+            old++;
+         }
+
+         bucket.erase(bucket.begin(), bucket.begin() + old);
+      }
+   }
+}
+
 int
 ClauseDatabase::giveSelection(vector<ClauseExchange *> & selectedCls,
                               unsigned totalSize, int * selectCount)
@@ -59,35 +103,33 @@ ClauseDatabase::giveSelection(vector<ClauseExchange *> & selectedCls,
    int used     = 0;
    *selectCount = 0;
 
-   for (unsigned i = 0; i < clauses.size(); i++) {
-      unsigned clsSize = i + 1;
-      unsigned left    = totalSize - used;
+   round++;
+
+   if (maxAge > 0) {
+      evict();
+   }
 
-      if (left < clsSize) // No more place
-         return used;
-      
-      if (left >= clsSize * clauses[i].size()) {
-         // If all the clauses of size clsSize (i+1) can be added
-         used = used + clsSize * clauses[i].size();
+   for (size_t i = 0; i < buckets.size(); i++) {
+      for (size_t j = 0; j < buckets[i].size(); j++) {
+         vector<Entry> & bucket = buckets[i][j];
 
-         selectedCls.insert(selectedCls.end(), clauses[i].begin(),
-                            clauses[i].end());
+         unsigned clsSize = j + 1;
+         unsigned left    = totalSize - used;
 
-         *selectCount += clauses[i].size();
+         // The next buckets of this LBD have longer clauses
+         if (left < clsSize)
+            break;
 
-         clauses[i].clear();
-      } else {
-         // Else how many clauses can be added
-         // Add them one by one
-         unsigned nCls = left / clsSize;
-         used              = used + clsSize * nCls;
+         // As many clauses as possible, the most recent first
+         unsigned nCls = min((size_t)(left / clsSize), bucket.size());
 
          for (unsigned k = 0; k < nCls; k++) {
-            selectedCls.push_back(clauses[i].back());
-            clauses[i].pop_back();
-
-            *selectCount += 1;
+            selectedCls.push_back(bucket.back().cls);
+            bucket.pop_back();
          }
+
+         used         += clsSize * nCls;
+         *selectCount += nCls;
       }
    }
 
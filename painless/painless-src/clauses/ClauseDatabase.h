@@ -17,6 +17,7 @@
 // this program.  If not, see <http://www.gnu.org/licenses/>.
 // -----------------------------------------------------------------------------
 
+
 #pragma once 
 
 #include "../clauses/ClauseExchange.h"
@@ -26,25 +27,53 @@
 
 using namespace std;
 
-/// Clause database used for Hordesat
+/// The clauses are bucketed per LBD up to this value, the clauses with a
+/// larger LBD share the last bucket.
+#define DATABASE_MAX_LBD 16
+
+/// Clause database used for Hordesat. The clauses are bucketed per LBD then
+/// per size, the selection takes the lowest LBD first then the shortest
+/// clauses. A bucket holds a limited number of literals, the clauses beyond
+/// are dropped, and a clause not selected after a number of rounds is
+/// evicted. A round is a call to giveSelection.
 class ClauseDatabase
 {
 public:
    /// Constructor.
-	ClauseDatabase();
+   ClauseDatabase();
 
-   /// Destructor
-	~ClauseDatabase();
+   /// Destructor, release the clauses left.
+   ~ClauseDatabase();
+
+   /// Add a shared clause to the database.
+   void addClause(ClauseExchange * clause);
 
-	/// Add a shared clause to the database.
-	void addClause(ClauseExchange * clause);
-	 
    /// Fill the given buffer with shared clauses.
-	/// @return the number of used literals.
-	int giveSelection(vector<ClauseExchange *> & selectedCls, unsigned totalSize,
+   /// @return the number of used literals.
+   int giveSelection(vector<ClauseExchange *> & selectedCls, unsigned totalSize,
                      int * selectCount);
 
 protected:
-   /// Vector of vector of shared clauses, on vector per size.
-	vector<vector<ClauseExchange *> > clauses;
+   /// Shared clause with the round of its insertion.
+   struct Entry
+   {
+      ClauseExchange * cls;
+      unsigned long round;
+   };
+
+   /// Release the clauses older than maxAge rounds.
+   void evict();
+
+   /// Buckets of shared clauses, buckets[lbd - 1][size - 1], the oldest
+   /// clauses first.
+   vector<vector<vector<Entry> > > buckets;
+
+   /// Maximum number of literals of a bucket.
+   unsigned bucketCap;
+
+   /// Number of rounds a clause can wait for its selection, 0 for ever.
+   unsigned long maxAge;
+
+   /// Number of rounds.
+   unsigned long round;
 };
@@ -0,0 +1,205 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#include "../clauses/ClauseManager.h"
+#include "../clauses/ClausePriorityBuffer.h"
+#include "../utils/System.h"
+
+#include <iterator>
+#include <sys/time.h>
+#include <vector>
+
+using namespace std;
+
+//-------------------------------------------------
+// Constructor & Destructor
+//-------------------------------------------------
+ClausePriorityBuffer::ClausePriorityBuffer(int maxSize_, double maxAge_)
+{
+   maxSize    = maxSize_ > 0 ? maxSize_ : 1;
+   maxAge     = maxAge_;
+   nAdded     = 0;
+   duplicates = 0;
+   overflows  = 0;
+   stales     = 0;
+
+   pthread_mutex_init(&mutex, NULL);
+   pthread_cond_init (&condNotEmpty, NULL);
+}
+
+ClausePriorityBuffer::~ClausePriorityBuffer()
+{
+   for (auto it = elements.begin(); it != elements.end(); it++) {
+      ClauseManager::releaseClause(it->clause);
+   }
+
+   pthread_mutex_destroy(&mutex);
+   pthread_cond_destroy (&condNotEmpty);
+}
+
+//-------------------------------------------------
+//  Hash
+//-------------------------------------------------
+uint64_t
+ClausePriorityBuffer::hashClause(ClauseExchange * clause)
+{
+   uint64_t sum = 0, xored = 0;
+
+   for (int i = 0; i < clause->size; i++) {
+      // Mix each literal (splitmix64 finalizer), then combine with
+      // commutative operations
+      uint64_t h = (uint64_t)(int64_t)clause->lits[i] + 0x9e3779b97f4a7c15ULL;
+      h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+      h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+      h =  h ^ (h >> 31);
+
+      sum   += h;
+      xored ^= h;
+   }
+
+   return (sum ^ (xored << 1)) + clause->size;
+}
+
+//-------------------------------------------------
+//  Add clause
+//-------------------------------------------------
+bool
+ClausePriorityBuffer::addClause(ClauseExchange * clause)
+{
+   Element elem;
+   elem.clause = clause;
+   elem.hash   = hashClause(clause);
+   elem.time   = getRelativeTime();
+
+   ClauseExchange * dropped = NULL;
+
+   pthread_mutex_lock(&mutex);
+
+   if (hashes.count(elem.hash)) {
+      duplicates++;
+      dropped = clause;
+   } else {
+      elem.order = nAdded++;
+
+      if (elements.size() >= maxSize) {
+         // Backpressure: keep the best clauses only
+         auto worst = prev(elements.end());
+
+         if (ElementLess()(elem, *worst)) {
+            dropped = worst->clause;
+            hashes.erase(worst->hash);
+            elements.erase(worst);
+         } else {
+            dropped = clause;
+         }
+
+         overflows++;
+      }
+
+      if (dropped != clause) {
+         elements.insert(elem);
+         hashes.insert(elem.hash);
+         pthread_cond_signal(&condNotEmpty);
+      }
+   }
+
+   pthread_mutex_unlock(&mutex);
+
+   if (dropped != NULL) {
+      ClauseManager::releaseClause(dropped);
+   }
+
+   return dropped != clause;
+}
+
+//-------------------------------------------------
+//  Get clause
+//-------------------------------------------------
+bool
+ClausePriorityBuffer::getClause(ClauseExchange ** clause, int timeout)
+{
+   bool found = false;
+
+   vector<ClauseExchange *> staleCls;
+
+   pthread_mutex_lock(&mutex);
+
+   if (elements.empty() && timeout > 0) {
+      struct timeval now;
+      struct timespec deadline;
+
+      gettimeofday(&now, NULL);
+
+      long usec         = now.tv_usec + timeout;
+      deadline.tv_sec   = now.tv_sec + usec / 1000000;
+      deadline.tv_nsec  = (usec % 1000000) * 1000;
+
+      pthread_cond_timedwait(&condNotEmpty, &mutex, &deadline);
+   }
+
+   double now = getRelativeTime();
+
+   while (!elements.empty()) {
+      auto best = elements.begin();
+
+      hashes.erase(best->hash);
+
+      if (maxAge > 0 && now - best->time > maxAge) {
+         staleCls.push_back(best->clause);
+         elements.erase(best);
+         continue;
+      }
+
+      *clause = best->clause;
+      elements.erase(best);
+      found = true;
+      break;
+   }
+
+   pthread_mutex_unlock(&mutex);
+
+   stales += staleCls.size();
+
+   for (size_t i = 0; i < staleCls.size(); i++) {
+      ClauseManager::releaseClause(staleCls[i]);
+   }
+
+   return found;
+}
+
+void
+ClausePriorityBuffer::wakeUp()
+{
+   pthread_mutex_lock(&mutex);
+   pthread_cond_broadcast(&condNotEmpty);
+   pthread_mutex_unlock(&mutex);
+}
+
+//-------------------------------------------------
+//  Get size of the buffer.
+//-------------------------------------------------
+int
+ClausePriorityBuffer::size()
+{
+   pthread_mutex_lock(&mutex);
+   int ret = elements.size();
+   pthread_mutex_unlock(&mutex);
+
+   return ret;
+}
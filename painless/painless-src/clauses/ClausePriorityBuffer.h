@@ -0,0 +1,122 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "../clauses/ClauseExchange.h"
+
+#include <atomic>
+#include <pthread.h>
+#include <set>
+#include <stdint.h>
+#include <unordered_set>
+
+using namespace std;
+
+/// Clause priority buffer is a bounded queue containing shared clauses. The
+/// clauses are given back by increasing LBD, then size, then age (the youngest
+/// first). Duplicated clauses are filtered while they are in the buffer.
+class ClausePriorityBuffer
+{
+public:
+   /// Constructor, maxSize is the maximum number of clauses in the buffer and
+   /// maxAge the time in seconds after which a clause is considered stale.
+   ClausePriorityBuffer(int maxSize, double maxAge);
+
+   /// Destructor.
+   ~ClausePriorityBuffer();
+
+   /// Enqueue a shared clause to the buffer, the clause is released if it is
+   /// dropped. Return false if the clause has been dropped.
+   bool addClause(ClauseExchange * clause);
+
+   /// Dequeue the best clause that is not stale, wait at most timeout
+   /// useconds if the buffer is empty.
+   bool getClause(ClauseExchange ** clause, int timeout);
+
+   /// Wake up the threads waiting for a clause.
+   void wakeUp();
+
+   /// Return the current size of the buffer.
+   int size();
+
+   /// Number of clauses dropped because they were duplicated.
+   atomic<unsigned long> duplicates;
+
+   /// Number of clauses dropped because the buffer was full.
+   atomic<unsigned long> overflows;
+
+   /// Number of clauses dropped because they were stale.
+   atomic<unsigned long> stales;
+
+protected:
+   /// Element of the buffer.
+   struct Element
+   {
+      ClauseExchange * clause;
+
+      /// Hash of the literals of the clause.
+      uint64_t hash;
+
+      /// Time at which the clause has been added.
+      double time;
+
+      /// Insertion number, used to order clauses by age.
+      unsigned long order;
+   };
+
+   /// Order of the elements, the best first.
+   struct ElementLess
+   {
+      bool operator()(const Element & a, const Element & b) const
+      {
+         if (a.clause->lbd != b.clause->lbd)
+            return a.clause->lbd < b.clause->lbd;
+
+         if (a.clause->size != b.clause->size)
+            return a.clause->size < b.clause->size;
+
+         return a.order > b.order;
+      }
+   };
+
+   /// Compute a hash of a clause that does not depend on literals order.
+   static uint64_t hashClause(ClauseExchange * clause);
+
+   /// Maximum number of clauses in the buffer.
+   unsigned maxSize;
+
+   /// Age in seconds after which a clause is stale.
+   double maxAge;
+
+   /// Number of clauses added since the creation of the buffer.
+   unsigned long nAdded;
+
+   /// Elements ordered by priority.
+   set<Element, ElementLess> elements;
+
+   /// Hashes of the clauses in the buffer.
+   unordered_set<uint64_t> hashes;
+
+   /// Mutex protecting the buffer.
+   pthread_mutex_t mutex;
+
+   /// Condition used to wait for clauses.
+   pthread_cond_t condNotEmpty;
+};
@@ -0,0 +1,138 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#include "../clauses/ClauseManager.h"
+#include "../clauses/ClauseRing.h"
+
+#include <new>
+
+using namespace std;
+
+size_t
+ClauseRing::memorySize(size_t capacity)
+{
+   return sizeof(ClauseRing) + capacity * sizeof(int);
+}
+
+ClauseRing *
+ClauseRing::init(void * memory, size_t capacity)
+{
+   ClauseRing * ring = new (memory) ClauseRing();
+
+   ring->capacity = capacity;
+   ring->reserved = 0;
+   ring->written  = 0;
+
+   return ring;
+}
+
+uint64_t
+ClauseRing::end()
+{
+   return written.load(memory_order_acquire);
+}
+
+void
+ClauseRing::write(const vector<ClauseExchange *> & clauses)
+{
+   uint64_t pos = written.load(memory_order_relaxed);
+   uint64_t len = 0;
+
+   for (size_t i = 0; i < clauses.size(); i++) {
+      len += 2 + clauses[i]->size;
+   }
+
+   if (len == 0 || len > capacity)
+      return;
+
+   // The readers see the reservation before any overwritten int
+   reserved.store(pos + len, memory_order_relaxed);
+   atomic_thread_fence(memory_order_release);
+
+   int * ints = data();
+
+   for (size_t i = 0; i < clauses.size(); i++) {
+      ClauseExchange * cls = clauses[i];
+
+      ints[pos++ % capacity] = cls->size;
+      ints[pos++ % capacity] = cls->lbd;
+
+      for (int k = 0; k < cls->size; k++) {
+         ints[pos++ % capacity] = cls->lits[k];
+      }
+   }
+
+   written.store(pos, memory_order_release);
+}
+
+size_t
+ClauseRing::read(uint64_t & cursor, vector<ClauseExchange *> & clauses)
+{
+   uint64_t last = written.load(memory_order_acquire);
+
+   if (last - cursor > capacity) {
+      size_t lost = last - cursor;
+      cursor      = last;
+      return lost;
+   }
+
+   int * ints = data();
+
+   vector<int> copy(last - cursor);
+
+   for (uint64_t pos = cursor; pos < last; pos++) {
+      copy[pos - cursor] = ints[pos % capacity];
+   }
+
+   // The copy is valid if the writer has not reserved its first ints since
+   atomic_thread_fence(memory_order_acquire);
+
+   if (reserved.load(memory_order_relaxed) > cursor + capacity) {
+      size_t lost = last - cursor;
+      cursor      = last;
+      return lost;
+   }
+
+   cursor = last;
+
+   size_t pos = 0;
+
+   while (pos + 2 <= copy.size()) {
+      int size = copy[pos];
+
+      if (size < 0 || pos + 2 + size > copy.size())
+         break;
+
+      ClauseExchange * cls = ClauseManager::allocClause(size);
+
+      cls->lbd  = copy[pos + 1];
+      cls->from = -1;
+
+      for (int k = 0; k < size; k++) {
+         cls->lits[k] = copy[pos + 2 + k];
+      }
+
+      clauses.push_back(cls);
+
+      pos += 2 + size;
+   }
+
+   return 0;
+}
@@ -0,0 +1,71 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "../clauses/ClauseExchange.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+/// Ring of clauses in a memory shared by several processes, written by one
+/// process and read by all the others, each with its own cursor. A clause is
+/// stored as its size, its LBD and its literals. The writer never waits: a
+/// reader that is overtaken loses the overwritten clauses. The ring lives in
+/// the shared memory, it is placed with init and never destroyed.
+class ClauseRing
+{
+public:
+   /// Number of bytes of a ring of capacity ints.
+   static size_t memorySize(size_t capacity);
+
+   /// Place a ring of capacity ints in memory of size memorySize(capacity).
+   static ClauseRing * init(void * memory, size_t capacity);
+
+   /// Append a list of clauses, a single thread may write at a time.
+   void write(const vector<ClauseExchange *> & clauses);
+
+   /// Read the clauses written after the cursor, the cursor is moved after
+   /// them. Return the number of ints lost because they were overwritten.
+   size_t read(uint64_t & cursor, vector<ClauseExchange *> & clauses);
+
+   /// Position of the end of the written clauses.
+   uint64_t end();
+
+protected:
+   /// Ints of the ring, after the header.
+   inline int * data()
+   {
+      return (int *)(this + 1);
+   }
+
+   /// Number of ints of the ring.
+   uint64_t capacity;
+
+   /// End of the clauses being written, the ints before it minus the
+   /// capacity may have been overwritten.
+   atomic<uint64_t> reserved;
+
+   /// End of the written clauses.
+   atomic<uint64_t> written;
+};
@@ -0,0 +1,203 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#include "../clauses/DuplicateTable.h"
+
+#include <stdio.h>
+
+/// Number of entries where a clause is looked for.
+#define DUPLICATE_WINDOW 4
+
+/// Mask of the solvers of an entry.
+#define SOLVERS_MASK ((1ULL << DUPLICATE_SOLVER_BITS) - 1)
+
+/// Mix the bits of a 64 bits value (splitmix64).
+static inline uint64_t mix(uint64_t x)
+{
+   x += 0x9e3779b97f4a7c15ULL;
+   x  = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+   x  = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+   return x ^ (x >> 31);
+}
+
+DuplicateTable::DuplicateTable(int logSize, int promoteCount, int maxLbd)
+{
+   this->promoteCount = promoteCount;
+   this->maxLbd       = maxLbd;
+
+   mask    = (1ULL << logSize) - 1;
+   entries = new atomic<uint64_t>[mask + 1];
+
+   for (uint64_t i = 0; i <= mask; i++) {
+      entries[i] = 0;
+   }
+
+   for (int i = 0; i < DUPLICATE_SOLVER_BITS; i++) {
+      slots[i] = -1;
+   }
+
+   nReplaced  = 0;
+   nPromoted  = 0;
+   nUnslotted = 0;
+}
+
+DuplicateTable::~DuplicateTable()
+{
+   delete [] entries;
+}
+
+uint64_t
+DuplicateTable::hashClause(const int * lits, int size)
+{
+   // A sum of the mixed literals, whatever their order
+   uint64_t sum = 0;
+
+   for (int i = 0; i < size; i++) {
+      sum += mix((uint32_t)lits[i]);
+   }
+
+   return mix(sum ^ size);
+}
+
+int
+DuplicateTable::getSlot(int solverId)
+{
+   // Only the thread of the solver takes its slot
+   for (int i = 0; i < DUPLICATE_SOLVER_BITS; i++) {
+      if (slots[i].load(memory_order_relaxed) == solverId)
+         return i;
+   }
+
+   for (int i = 0; i < DUPLICATE_SOLVER_BITS; i++) {
+      int none = -1;
+
+      if (slots[i].compare_exchange_strong(none, solverId))
+         return i;
+   }
+
+   return -1;
+}
+
+void
+DuplicateTable::removeSolver(int solverId)
+{
+   for (int i = 0; i < DUPLICATE_SOLVER_BITS; i++) {
+      int owner = solverId;
+
+      if (slots[i].compare_exchange_strong(owner, -1))
+         return;
+   }
+}
+
+int
+DuplicateTable::add(const int * lits, int size, int solverId)
+{
+   int solverSlot = getSlot(solverId);
+
+   if (solverSlot < 0) {
+      nUnslotted++;
+      return 1;
+   }
+
+   uint64_t hash = hashClause(lits, size);
+   uint64_t fp   = (hash >> DUPLICATE_SOLVER_BITS) | 1;
+   uint64_t bit  = 1ULL << solverSlot;
+
+   uint64_t victim = hash & mask;
+   int victimCount = DUPLICATE_SOLVER_BITS + 1;
+
+   for (int i = 0; i < DUPLICATE_WINDOW; i++) {
+      uint64_t slot  = (hash + i) & mask;
+      uint64_t entry = entries[slot].load(memory_order_relaxed);
+
+      if (entry >> DUPLICATE_SOLVER_BITS == fp) {
+         entry = entries[slot].fetch_or(bit, memory_order_relaxed) | bit;
+
+         // The entry may have been replaced in the meantime
+         if (entry >> DUPLICATE_SOLVER_BITS != fp)
+            return 1;
+
+         return __builtin_popcountll(entry & SOLVERS_MASK);
+      }
+
+      int count = entry == 0 ? 0 : __builtin_popcountll(entry & SOLVERS_MASK);
+
+      if (count < victimCount) {
+         victim      = slot;
+         victimCount = count;
+      }
+   }
+
+   // The least shared entry of the window, the table is lossy
+   uint64_t old = entries[victim].load(memory_order_relaxed);
+
+   if (__builtin_popcountll(old & SOLVERS_MASK) == victimCount &&
+       entries[victim].compare_exchange_strong(old,
+                                               (fp << DUPLICATE_SOLVER_BITS) |
+                                               bit, memory_order_relaxed) &&
+       old != 0) {
+      nReplaced++;
+   }
+
+   return 1;
+}
+
+int
+DuplicateTable::count(const int * lits, int size)
+{
+   uint64_t hash = hashClause(lits, size);
+   uint64_t fp   = (hash >> DUPLICATE_SOLVER_BITS) | 1;
+
+   for (int i = 0; i < DUPLICATE_WINDOW; i++) {
+      uint64_t entry = entries[(hash + i) & mask].load(memory_order_relaxed);
+
+      if (entry >> DUPLICATE_SOLVER_BITS == fp)
+         return __builtin_popcountll(entry & SOLVERS_MASK);
+   }
+
+   return 0;
+}
+
+int
+DuplicateTable::getPromoteCount()
+{
+   return promoteCount;
+}
+
+int
+DuplicateTable::getMaxLbd()
+{
+   return maxLbd;
+}
+
+void
+DuplicateTable::notifyPromotion()
+{
+   nPromoted++;
+}
+
+void
+DuplicateTable::printStats()
+{
+   printf("c DuplicateTable entries %lu, replaced %lu, promoted cls %lu, "
+          "unrecorded cls %lu\n", (unsigned long)mask + 1,
+          (unsigned long)nReplaced, (unsigned long)nPromoted,
+          (unsigned long)nUnslotted);
+}
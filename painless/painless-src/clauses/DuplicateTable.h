@@ -0,0 +1,107 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#pragma once
+
+#include <atomic>
+#include <stdint.h>
+
+using namespace std;
+
+/// Number of bits of the mask of the solvers in an entry, the other bits are
+/// the fingerprint of the clause.
+#define DUPLICATE_SOLVER_BITS 32
+
+/// Table of the clauses learnt by the solvers, shared by all of them, to
+/// count how many distinct solvers learnt each clause. It is bounded and
+/// lock-free: an entry is a word holding a fingerprint of the clause and the
+/// mask of the solvers that learnt it, one bit per slot. A solver takes a
+/// free slot at its first clause and gives it back when it is deleted, so at
+/// most DUPLICATE_SOLVER_BITS solvers are counted at once and promoteCount
+/// cannot be larger; the clauses of the solvers beyond are not recorded. A
+/// solver taking back a slot inherits the clauses of the previous owner,
+/// which are then counted once. A clause is looked for in a window of
+/// entries, a new clause takes the place of the least shared one. The
+/// fingerprint does not depend on the order of the literals.
+class DuplicateTable
+{
+public:
+   /// Constructor, the table has 2^logSize entries. The clauses learnt by
+   /// promoteCount solvers are promoted, only the clauses with a LBD up to
+   /// maxLbd are recorded.
+   DuplicateTable(int logSize, int promoteCount, int maxLbd);
+
+   /// Destructor.
+   ~DuplicateTable();
+
+   /// Record that a solver learnt a clause. Return the number of distinct
+   /// solvers that learnt it, this one included.
+   int add(const int * lits, int size, int solverId);
+
+   /// Return the number of distinct solvers that learnt a clause.
+   int count(const int * lits, int size);
+
+   /// Give back the slot of a deleted solver.
+   void removeSolver(int solverId);
+
+   /// Number of solvers from which a clause is promoted.
+   int getPromoteCount();
+
+   /// Maximum LBD of the recorded clauses.
+   int getMaxLbd();
+
+   /// Count a clause promoted by a solver.
+   void notifyPromotion();
+
+   /// Print the statistics of the table.
+   void printStats();
+
+protected:
+   /// Hash of a clause.
+   uint64_t hashClause(const int * lits, int size);
+
+   /// Slot of a solver, a free one is taken at its first call. Return -1 if
+   /// all the slots are taken.
+   int getSlot(int solverId);
+
+   /// Id of the solver of each slot, -1 if free.
+   atomic<int> slots[DUPLICATE_SOLVER_BITS];
+
+   /// Entries of the table, 0 if free.
+   atomic<uint64_t> * entries;
+
+   /// Number of solvers from which a clause is promoted.
+   int promoteCount;
+
+   /// Maximum LBD of the recorded clauses.
+   int maxLbd;
+
+   /// Number of entries minus one.
+   uint64_t mask;
+
+   /// Number of clauses that took the place of another one.
+   atomic<unsigned long> nReplaced;
+
+   /// Number of promoted clauses.
+   atomic<unsigned long> nPromoted;
+
+   /// Number of clauses not recorded because their solver has no slot.
+   atomic<unsigned long> nUnslotted;
+};
@@ -0,0 +1,234 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#include "../clauses/ClauseManager.h"
+#include "../clauses/UnitLog.h"
+
+#include <stdio.h>
+
+//-------------------------------------------------
+// Constructor & Destructor
+//-------------------------------------------------
+UnitLog::UnitLog(int nVars_, int maxBinaries_)
+{
+   nVars       = nVars_;
+   maxBinaries = maxBinaries_ > 0 ? maxBinaries_ : 0;
+
+   // Each literal can be published once as a unit
+   capacity = 2 * (size_t)nVars + maxBinaries;
+   entries  = new Entry[capacity];
+   tail     = 0;
+
+   for (size_t i = 0; i < capacity; i++) {
+      entries[i].ready = false;
+   }
+
+   units = new atomic<bool>[2 * (size_t)nVars + 2];
+
+   for (size_t i = 0; i < 2 * (size_t)nVars + 2; i++) {
+      units[i] = false;
+   }
+
+   // Load factor of at most 1/2
+   size_t size = 2;
+   while (size < 2 * maxBinaries) {
+      size *= 2;
+   }
+
+   binaries     = new atomic<uint64_t>[size];
+   binariesMask = size - 1;
+
+   for (size_t i = 0; i < size; i++) {
+      binaries[i] = 0;
+   }
+
+   nUnits      = 0;
+   nBinaries   = 0;
+   nDuplicates = 0;
+   nDropped    = 0;
+}
+
+UnitLog::~UnitLog()
+{
+   delete [] entries;
+   delete [] units;
+   delete [] binaries;
+}
+
+//-------------------------------------------------
+//  Publish
+//-------------------------------------------------
+void
+UnitLog::append(int lit1, int lit2, int from)
+{
+   size_t index = tail.fetch_add(1);
+
+   Entry & entry = entries[index];
+   entry.from    = from;
+   entry.lit1    = lit1;
+   entry.lit2    = lit2;
+   entry.ready.store(true, memory_order_release);
+}
+
+bool
+UnitLog::addUnit(int lit, int from)
+{
+   int index = lit > 0 ? 2 * lit : -2 * lit + 1;
+
+   if (abs(lit) > nVars) {
+      nDropped++;
+      return false;
+   }
+
+   if (units[index].exchange(true)) {
+      nDuplicates++;
+      return true;
+   }
+
+   append(lit, 0, from);
+
+   nUnits++;
+
+   return true;
+}
+
+bool
+UnitLog::insertBinary(int lit1, int lit2)
+{
+   if (lit1 > lit2) {
+      int tmp = lit1;
+      lit1    = lit2;
+      lit2    = tmp;
+   }
+
+   // Literals are not null so the key is never 0
+   uint64_t key = ((uint64_t)(uint32_t)lit1 << 32) | (uint32_t)lit2;
+
+   uint64_t h = key;
+   h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ULL;
+   h = (h ^ (h >> 27)) * 0x94d049bb133111ebULL;
+   h =  h ^ (h >> 31);
+
+   for (size_t probe = 0; probe <= binariesMask; probe++) {
+      atomic<uint64_t> & slot = binaries[(h + probe) & binariesMask];
+
+      uint64_t current = slot.load();
+
+      if (current == 0) {
+         if (slot.compare_exchange_strong(current, key))
+            return true;
+      }
+
+      if (current == key)
+         return false;
+   }
+
+   return false;
+}
+
+bool
+UnitLog::addBinary(int lit1, int lit2, int from)
+{
+   // A place is reserved first, so that the hash set never holds more than
+   // maxBinaries clauses: a clause it holds is always in the log
+   if (nBinaries.fetch_add(1) >= maxBinaries) {
+      nBinaries--;
+      nDropped++;
+      return false;
+   }
+
+   if (insertBinary(lit1, lit2) == false) {
+      nBinaries--;
+      nDuplicates++;
+      return true;
+   }
+
+   append(lit1, lit2, from);
+
+   return true;
+}
+
+//-------------------------------------------------
+//  Read
+//-------------------------------------------------
+void
+UnitLog::read(size_t & cursor, int id, vector<int> & unitsRead,
+              vector<pair<int, int> > & binariesRead)
+{
+   size_t end = tail.load();
+
+   if (end > capacity)
+      end = capacity;
+
+   // Stop at the first entry that is still being written
+   while (cursor < end &&
+          entries[cursor].ready.load(memory_order_acquire)) {
+      Entry & entry = entries[cursor];
+
+      if (entry.from != id) {
+         if (entry.lit2 == 0) {
+            unitsRead.push_back(entry.lit1);
+         } else {
+            binariesRead.push_back(make_pair(entry.lit1, entry.lit2));
+         }
+      }
+
+      cursor++;
+   }
+}
+
+void
+UnitLog::readClauses(size_t & cursor, int id,
+                     vector<ClauseExchange *> & clauses)
+{
+   size_t end = tail.load();
+
+   if (end > capacity)
+      end = capacity;
+
+   // The clauses keep the id of the solver that published them
+   while (cursor < end &&
+          entries[cursor].ready.load(memory_order_acquire)) {
+      Entry & entry = entries[cursor];
+
+      if (entry.from != id) {
+         int size = entry.lit2 == 0 ? 1 : 2;
+
+         ClauseExchange * cls = ClauseManager::allocClause(size);
+         cls->lits[0] = entry.lit1;
+         if (size == 2) {
+            cls->lits[1] = entry.lit2;
+         }
+         cls->lbd  = size;
+         cls->from = entry.from;
+         clauses.push_back(cls);
+      }
+
+      cursor++;
+   }
+}
+
+void
+UnitLog::printStats()
+{
+   printf("c Unit log units %lu, binaries %lu, duplicates %lu, dropped %lu\n",
+          (unsigned long)nUnits, (unsigned long)nBinaries,
+          (unsigned long)nDuplicates, (unsigned long)nDropped);
+}
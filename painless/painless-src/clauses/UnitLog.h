@@ -0,0 +1,118 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "../clauses/ClauseExchange.h"
+
+#include <atomic>
+#include <stdint.h>
+#include <stdlib.h>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+/// Unit log is a lock-free append-only log of the units and binary clauses
+/// shared by the solvers. Each solver reads it with its own cursor, and so do
+/// the bridges to the other processes. Duplicated units and binaries are
+/// filtered. The clauses the log refuses (binaries over the limit, unknown
+/// variables) are shared by the caller through the sharers instead.
+class UnitLog
+{
+public:
+   /// Constructor, maxBinaries is the maximum number of binary clauses kept.
+   UnitLog(int nVars, int maxBinaries);
+
+   /// Destructor.
+   ~UnitLog();
+
+   /// Publish a unit, return false if the log cannot hold it (a duplicate is
+   /// accepted).
+   bool addUnit(int lit, int from);
+
+   /// Publish a binary clause, return false if the log cannot hold it (a
+   /// duplicate is accepted).
+   bool addBinary(int lit1, int lit2, int from);
+
+   /// Read the entries published after the cursor by the other solvers, the
+   /// cursor is moved after them.
+   void read(size_t & cursor, int id, vector<int> & units,
+             vector<pair<int, int> > & binaries);
+
+   /// Same as read, the entries are given as clauses of LBD 1 and 2, from the
+   /// solver that published them.
+   void readClauses(size_t & cursor, int id,
+                    vector<ClauseExchange *> & clauses);
+
+   /// Print the statistics of the log.
+   void printStats();
+
+protected:
+   /// Entry of the log, lit2 is 0 for a unit.
+   struct Entry
+   {
+      atomic<bool> ready;
+      int from;
+      int lit1;
+      int lit2;
+   };
+
+   /// Append an entry.
+   void append(int lit1, int lit2, int from);
+
+   /// Insert a binary clause in the hash set, return false if present.
+   bool insertBinary(int lit1, int lit2);
+
+   /// Number of variables.
+   int nVars;
+
+   /// Capacity of the log.
+   size_t capacity;
+
+   /// Entries of the log.
+   Entry * entries;
+
+   /// Index of the next free entry.
+   atomic<size_t> tail;
+
+   /// Flags of the published units, indexed by literal.
+   atomic<bool> * units;
+
+   /// Open-addressing hash set of the published binaries, 0 is empty.
+   atomic<uint64_t> * binaries;
+
+   /// Mask of the hash set.
+   size_t binariesMask;
+
+   /// Maximum number of binaries.
+   unsigned long maxBinaries;
+
+   /// Number of published units.
+   atomic<unsigned long> nUnits;
+
+   /// Number of published binaries.
+   atomic<unsigned long> nBinaries;
+
+   /// Number of filtered duplicates.
+   atomic<unsigned long> nDuplicates;
+
+   /// Number of binaries dropped because the log was full.
+   atomic<unsigned long> nDropped;
+};
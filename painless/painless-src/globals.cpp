@@ -0,0 +1,115 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#include "painless.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <sys/time.h>
+
+using namespace std;
+
+
+// -------------------------------------------
+// Declaration of global variables
+// -------------------------------------------
+atomic<bool> globalEnding(false);
+
+Sharer ** sharers = NULL;
+
+int nSharers = 0;
+
+WorkingStrategy * working = NULL;
+
+UnitLog * unitLog = NULL;
+
+DuplicateTable * duplicateTable = NULL;
+
+SharingTrace * sharingTrace = NULL;
+
+SatResult finalResult = UNKNOWN;
+
+vector<int> finalModel;
+
+/// Protect the final result and the end of the search.
+static pthread_mutex_t mutexEnding = PTHREAD_MUTEX_INITIALIZER;
+
+/// Signaled at the end of the search.
+static pthread_cond_t condEnding = PTHREAD_COND_INITIALIZER;
+
+
+void
+setFinalResult(SatResult res, const vector<int> & model)
+{
+   pthread_mutex_lock(&mutexEnding);
+
+   if (globalEnding == false) {
+      finalResult = res;
+
+      if (res == SAT) {
+         finalModel = model;
+      }
+   }
+
+   globalEnding = true;
+
+   pthread_cond_broadcast(&condEnding);
+   pthread_mutex_unlock(&mutexEnding);
+}
+
+void
+setGlobalEnding()
+{
+   pthread_mutex_lock(&mutexEnding);
+
+   globalEnding = true;
+
+   pthread_cond_broadcast(&condEnding);
+   pthread_mutex_unlock(&mutexEnding);
+}
+
+bool
+waitGlobalEnding(long useconds)
+{
+   struct timeval now;
+   struct timespec deadline;
+
+   gettimeofday(&now, NULL);
+
+   long usec        = now.tv_usec + (useconds < 0 ? 0 : useconds);
+   deadline.tv_sec  = now.tv_sec + usec / 1000000;
+   deadline.tv_nsec = (usec % 1000000) * 1000;
+
+   pthread_mutex_lock(&mutexEnding);
+
+   while (globalEnding == false) {
+      if (useconds < 0) {
+         pthread_cond_wait(&condEnding, &mutexEnding);
+      } else if (pthread_cond_timedwait(&condEnding, &mutexEnding,
+                                        &deadline) == ETIMEDOUT) {
+         break;
+      }
+   }
+
+   bool ended = globalEnding;
+
+   pthread_mutex_unlock(&mutexEnding);
+
+   return ended;
+}
@@ -22,36 +22,117 @@
 #include "utils/System.h"
 #include "utils/SatUtils.h"
 
+#include "solvers/MapleCOMSPSSolver.h"
+#include "solvers/Reducer.h"
 #include "solvers/SolverFactory.h"
 
 #include "clauses/ClauseManager.h"
 
+#include "sharing/ActivitySharing.h"
+#include "sharing/BarrierSharing.h"
+#include "sharing/ForwardSharing.h"
 #include "sharing/HordeSatSharing.h"
+#include "sharing/MpiBridge.h"
+#include "sharing/PhaseSharing.h"
 #include "sharing/Sharer.h"
+#include "sharing/ShmBridge.h"
 
+#include "working/CubeGenerator.h"
+#include "working/DistributedDivideAndConquer.h"
+#include "working/DivideAndConquer.h"
+#include "working/FitnessPortfolio.h"
+#include "working/Hybrid.h"
 #include "working/SequentialWorker.h"
 #include "working/Portfolio.h"
+#include "working/ProcessGroup.h"
 
+#include "api/BatchServer.h"
+
+#include <algorithm>
 #include <unistd.h>
 
+#ifdef USE_MPI
+#include <mpi.h>
+#endif
+
 
 using namespace std;
 
 
-// -------------------------------------------
-// Declaration of global variables
-// -------------------------------------------
-atomic<bool> globalEnding(false);
+// Print the result and the model if SAT
+static void printResult()
+{
+   if (finalResult == SAT) {
+      cout << "s SATISFIABLE" << endl;
 
-Sharer ** sharers = NULL;
+      if (Parameters::getBoolParam("no-model") == false) {
+         printModel(finalModel);
+      }
+   } else if (finalResult == UNSAT) {
+      cout << "s UNSATISFIABLE" << endl;
+   } else {
+      cout << "s UNKNOWN" << endl;
+   }
+}
 
-int nSharers = 0;
 
-WorkingStrategy * working = NULL;
+// Deterministic search: a portfolio of MapleCOMSPS solvers sharing their
+// clauses at conflict barriers, the result and the model only depend on the
+// number of solvers
+static void solveDeterministic(int cpus)
+{
+   vector<SolverInterface *> solvers;
+   vector<SolverInterface *> solvers_VSIDS;
+   vector<SolverInterface *> solvers_LRB;
+
+   SolverFactory::createMapleCOMSPSSolvers(cpus, solvers);
+   SolverFactory::nativeDiversification(solvers);
 
-SatResult finalResult = UNKNOWN;
+   for (size_t id = 0; id < solvers.size(); id++) {
+      if (id % 2) {
+         solvers_LRB.push_back(solvers[id]);
+      } else {
+         solvers_VSIDS.push_back(solvers[id]);
+      }
+   }
+
+   SolverFactory::sparseRandomDiversification(solvers_LRB);
+   SolverFactory::sparseRandomDiversification(solvers_VSIDS);
+
+   BarrierSharing * barrier =
+      new BarrierSharing(solvers.size(),
+                         Parameters::getIntParam("det-period", 1000));
+
+   working = new Portfolio();
+
+   for (size_t i = 0; i < solvers.size(); i++) {
+      ((MapleCOMSPSSolver *)solvers[i])->setBarrier(barrier, i);
+      working->addSlave(new SequentialWorker(solvers[i]));
+   }
+
+   vector<int> cube;
+   working->solve(cube);
+
+   int timeout = Parameters::getIntParam("t", -1);
+   long left   = -1;
+
+   if (timeout > 0) {
+      left = max(0.0, timeout - getRelativeTime()) * 1000000;
+   }
+
+   if (waitGlobalEnding(left) == false) {
+      setGlobalEnding();
+   }
+
+   working->setInterrupt();
+   barrier->setInterrupt();
+
+   if (Parameters::getIntParam("v", 0) > 0) {
+      barrier->printStats();
+   }
 
-vector<int> finalModel;
+   printResult();
+}
 
 
 // -------------------------------------------
@@ -61,10 +142,12 @@ int main(int argc, char ** argv)
 {
    Parameters::init(argc, argv);
 
-   if (Parameters::getFilename() == NULL ||
+   if ((Parameters::getFilename() == NULL &&
+        Parameters::getBoolParam("server") == false) ||
        Parameters::getBoolParam("h"))
    {
       cout << "USAGE: " << argv[0] << " [options] input.cnf" << endl;
+      cout << "       " << argv[0] << " -server [options]" << endl;
       cout << "Options:" << endl;
       cout << "\t-c=<INT>\t\t number of cpus, default is 24" << endl;
       cout << "\t-max-memory=<INT>\t memory limit in GB, default is 200" << \
@@ -76,6 +159,125 @@ int main(int argc, char ** argv)
          "round, default is 500000 (0.5s)" << endl;
       cout << "\t-shr-lit=<INT>\t\t number of literals shared per round, " \
          "default is 1500" << endl;
+      cout << "\t-chrono=<INT>\t\t number of CDCL solvers running " \
+         "MapleChronoBT instead of MapleCOMSPS, they stay out of the " \
+         "cubes of wkr-strat 2 to 4, default is 0" << endl;
+      cout << "\t-chrono-viv\t\t vivify the core and tier2 learnt clauses " \
+         "of the MapleChronoBT solvers in a helper thread each" << endl;
+      cout << "\t-chrono-viv-batch=<INT> number of learnt clauses of a " \
+         "snapshot of the vivification, default is 1000" << endl;
+      cout << "\t-ls=<INT>\t\t number of local search solvers, taken " \
+         "from the CDCL solvers, default is 0" << endl;
+      cout << "\t-ls-flips=<INT>\t\t number of flips between two " \
+         "adoptions of the CDCL phases, default is 1000000" << endl;
+      cout << "\t-red-workers=<INT>\t number of threads of each reducer, " \
+         "default is 1" << endl;
+      cout << "\t-red-queue-size=<INT>\t maximum number of clauses waiting " \
+         "in a reducer, default is 10000" << endl;
+      cout << "\t-red-max-age=<INT>\t time in seconds after which a waiting " \
+         "clause is dropped, default is 10" << endl;
+      cout << "\t-red-strat=<INT>\t strengthening of the reducers: 0 full " \
+         "solve, 1 propagation only, 2 propagation then full solve if LBD " \
+         "<= red-full-lbd, default is 0" << endl;
+      cout << "\t-red-full-lbd=<INT>\t LBD limit of the full solve with " \
+         "red-strat=2, default is 4" << endl;
+      cout << "\t-act-share\t\t share the most active variables between " \
+         "the CDCL solvers" << endl;
+      cout << "\t-act-k=<INT>\t\t number of shared active variables, " \
+         "default is 100" << endl;
+      cout << "\t-act-strong=<INT>\t number of solvers giving their active " \
+         "variables, default is 2" << endl;
+      cout << "\t-act-bump=<INT>\t\t number of bumps given to the most " \
+         "active variable of the focus, default is 2" << endl;
+      cout << "\t-act-period=<INT>\t number of sharer rounds between two " \
+         "activity broadcasts, default is 10" << endl;
+      cout << "\t-phs-share\t\t share phases between the CDCL solvers" << \
+         endl;
+      cout << "\t-phs-period=<INT>\t number of sharer rounds between two " \
+         "phase exchanges, default is 4" << endl;
+      cout << "\t-phs-source=<INT>\t shared phases: 0 saved phases, 1 " \
+         "longest trail, default is 1" << endl;
+      cout << "\t-phs-policy=<INT>\t adoption: 0 best snapshot (longest " \
+         "trail, or lowest LBD of the learnt clauses with the saved " \
+         "phases), 1 majority vote, default is 0" << endl;
+      cout << "\t-phs-adopt=<INT>\t percentage of the shared phases " \
+         "adopted, default is 50" << endl;
+      cout << "\t-unit-log\t\t share units and binaries through a " \
+         "lock-free log" << endl;
+      cout << "\t-unit-log-bin=<INT>\t maximum number of binaries in the " \
+         "log, default is 1000000" << endl;
+      cout << "\t-dup-share=<INT>\t number of solvers learning a clause " \
+         "to put it in the core tier of all of them, at most 32, 0 " \
+         "disables, default is 0; only 32 solvers at once are counted" << endl;
+      cout << "\t-dup-size=<INT>\t\t log2 of the number of entries of the " \
+         "table of learnt clauses, default is 20" << endl;
+      cout << "\t-dup-lbd=<INT>\t\t LBD limit of the clauses put in the " \
+         "table, default is 12" << endl;
+      cout << "\t-shr-db-cap=<INT>\t literals of a (LBD, size) bucket of " \
+         "the clause databases of the sharers, default is 1000" << endl;
+      cout << "\t-shr-db-age=<INT>\t rounds a clause waits for its " \
+         "selection before its eviction, 0 for ever, default is 0" << endl;
+      cout << "\t-shr-feedback\t\t weight the producers and filter the " \
+         "LBD of their clauses by the usage of the imported clauses, " \
+         "tracked for 31 producers per solver" << endl;
+      cout << "\t-shr-trace=<FILE>\t record the exchanges of the sharers " \
+         "in a binary trace, suffixed by the process index" << endl;
+      cout << "\t-wkr-strat=<INT>\t working strategy: 1 portfolio, 2 " \
+         "divide and conquer, 3 cube and conquer, 4 portfolio switching to " \
+         "divide and conquer, default is 1" << endl;
+      cout << "\t-dc-balance=<INT>\t time in useconds between two work " \
+         "stealing attempts, default is 100000" << endl;
+      cout << "\t-fitness\t\t replace the weakest CDCL solvers of the " \
+         "portfolio by clones of the best ones" << endl;
+      cout << "\t-fit-period=<INT>\t time in useconds between two " \
+         "replacements, default is 10000000" << endl;
+      cout << "\t-fit-perturb=<INT>\t one variable out of this number " \
+         "gets a random phase in a clone, default is 4" << endl;
+      cout << "\t-hyb-period=<INT>\t time in useconds between two " \
+         "progress measures of the hybrid strategy, default is 2000000" << endl;
+      cout << "\t-hyb-patience=<INT>\t number of stagnating measures " \
+         "before moving workers, default is 3" << endl;
+      cout << "\t-hyb-units=<INT>\t learnt units per 10k conflicts under " \
+         "which the portfolio stagnates, default is 1" << endl;
+      cout << "\t-hyb-step=<INT>\t number of workers moved at once, " \
+         "default is 2" << endl;
+      cout << "\t-hyb-max=<INT>\t\t maximum percentage of workers in " \
+         "divide and conquer, default is 50" << endl;
+      cout << "\t-cube-threads=<INT>\t number of lookahead threads " \
+         "generating the cubes, default is 2" << endl;
+      cout << "\t-cube-depth=<INT>\t maximum number of decisions in a " \
+         "cube, default is 10" << endl;
+      cout << "\t-cube-refuted=<INT>\t number of refuted nodes after " \
+         "which the splitting stops, 0 for no limit, default is 1000" << endl;
+      cout << "\t-cube-cands=<INT>\t number of variables looked ahead " \
+         "at each node, default is 50" << endl;
+      cout << "\t-server\t\t\t solve the dimacs files read line by line, " \
+         "write one JSON result per line, -t applies to each file" << endl;
+      cout << "\t-srv-socket=<PATH>\t read the files from the connections " \
+         "of a Unix socket instead of stdin" << endl;
+      cout << "\t-srv-lane=<INT>\t\t number of workers of a lane, default " \
+         "is 4" << endl;
+      cout << "\t-srv-small=<INT>\t number of clauses up to which a file " \
+         "runs on one lane, default is 100000" << endl;
+      cout << "\t-srv-model\t\t write the models in the results" << endl;
+      cout << "\t-det\t\t\t deterministic portfolio of c MapleCOMSPS " \
+         "solvers sharing clauses at conflict barriers" << endl;
+      cout << "\t-det-period=<INT>\t number of conflicts between two " \
+         "barriers, default is 1000" << endl;
+      cout << "\t-procs=<INT>\t\t number of processes sharing the cpus, " \
+         "each one runs its own solvers and sharers, default is 1" << endl;
+      cout << "\t-shm-ring=<INT>\t\t number of ints of the ring of shared " \
+         "clauses of each process, default is 1048576" << endl;
+      cout << "\t-shm-period=<INT>\t useconds between two reads of the " \
+         "rings of the other processes, default is 10000" << endl;
+#ifdef USE_MPI
+      cout << "\t-mpi-lit=<INT>\t\t number of literals sent to the other " \
+         "processes per round, default is 3000" << endl;
+      cout << "\t-mpi-dict=<INT>\t\t size of the dictionary of frequent " \
+         "variables of the sent batches, default is 0" << endl;
+      cout << "\t-mpi-dc\t\t\t with wkr-strat=2, split the search space " \
+         "between the processes, an idle process steals a cube" << endl;
+#endif
       cout << "\t-v=<INT>\t\t verbosity level, default is 0" << endl;
       return 0;
    }
@@ -85,18 +287,140 @@ int main(int argc, char ** argv)
    int cpus = Parameters::getIntParam("c", 30);
    setVerbosityLevel(Parameters::getIntParam("v", 0));
 
+   // The table of the learnt clauses tells apart a bounded number of solvers
+   if (Parameters::getIntParam("dup-share", 0) > DUPLICATE_SOLVER_BITS) {
+      cerr << "The dup-share option is at most " << DUPLICATE_SOLVER_BITS <<
+         endl;
+      return 1;
+   }
+
+
+   // Server mode, the pool of workers is kept between the instances
+   if (Parameters::getBoolParam("server")) {
+      BatchServer server(cpus);
+
+      string socketPath = Parameters::getParam("srv-socket");
+
+      if (socketPath.empty()) {
+         server.serve(stdin, stdout);
+      } else if (server.serveSocket(socketPath.c_str()) == false) {
+         cerr << "Cannot listen on " << socketPath << endl;
+         return 1;
+      }
+
+      return 0;
+   }
+
+
+   // Deterministic mode, the other options of the solvers do not apply
+   if (Parameters::getBoolParam("det")) {
+      solveDeterministic(cpus);
+      return 0;
+   }
+
+
+   // Rank of the process and number of processes of a distributed run
+   int rank   = 0;
+   int nProcs = 1;
+
+#ifdef USE_MPI
+   // Only the thread of the bridge calls MPI during the search
+   int provided;
+   MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+   MPI_Comm_size(MPI_COMM_WORLD, &nProcs);
+
+   if (provided < MPI_THREAD_SERIALIZED) {
+      cerr << "MPI does not support MPI_THREAD_SERIALIZED" << endl;
+      MPI_Abort(MPI_COMM_WORLD, 1);
+   }
+#endif
+
+
+   // Multi-process mode, the cpus are split between processes isolated from
+   // each other, the parent only supervises them
+   int nGroups = Parameters::getIntParam("procs", 1);
+   ProcessGroup * group = NULL;
+
+#ifdef USE_MPI
+   // The processes of a distributed run are already isolated
+   nGroups = 1;
+#endif
+
+   if (nGroups > 1) {
+      group = new ProcessGroup(nGroups,
+                               Parameters::getIntParam("shm-ring", 1 << 20));
+
+      if (group->start() == false) {
+         cerr << "Cannot start the processes" << endl;
+         return 1;
+      }
+
+      if (group->getIndex() < 0) {
+         group->supervise(Parameters::getIntParam("t", -1));
+         printResult();
+         return 0;
+      }
+
+      cpus = max(cpus / nGroups, 1);
+   }
+
 
    // Create and init solvers
    vector<SolverInterface *> solvers;
    vector<SolverInterface *> solvers_VSIDS;
    vector<SolverInterface *> solvers_LRB;
 
-   SolverFactory::createMapleCOMSPSSolvers(cpus - 2, solvers);
-   solvers.push_back(SolverFactory::createReducerSolver(SolverFactory::createMapleCOMSPSSolver()));
-   solvers.push_back(SolverFactory::createReducerSolver(SolverFactory::createMapleCOMSPSSolver()));
+   // Each of the two reducers uses redWorkers threads
+   int redWorkers = Parameters::getIntParam("red-workers", 1);
+   if (redWorkers < 1)
+      redWorkers = 1;
+
+   // Local search solvers, they only look for a model
+   int nLocalSearch = Parameters::getIntParam("ls", 0);
+   if (nLocalSearch < 0)
+      nLocalSearch = 0;
+
+   int nCDCL = cpus - 2 * redWorkers - nLocalSearch;
+   if (nCDCL < 2)
+      nCDCL = 2;
+
+   // Part of the CDCL solvers may be MapleChronoBT instead of MapleCOMSPS
+   int nChrono = Parameters::getIntParam("chrono", 0);
+   if (nChrono > nCDCL - 1)
+      nChrono = nCDCL - 1;
+
+   vector<SolverInterface *> solvers_chrono;
+
+   SolverFactory::createMapleCOMSPSSolvers(nCDCL - nChrono, solvers);
+   SolverFactory::createMapleChronoBTSolvers(nChrono, solvers_chrono);
+   solvers.insert(solvers.end(), solvers_chrono.begin(), solvers_chrono.end());
+   nCDCL = solvers.size();
+
+   // MapleChronoBT does not solve under assumptions, only the MapleCOMSPS
+   // solvers take part in the strategies splitting the formula in cubes
+   int nMaple = nCDCL - solvers_chrono.size();
+
+   // The workers of the reducers are copies of the first MapleCOMSPS solver,
+   // the formula is not parsed again
+   for (int i = 0; i < 2; i++) {
+      vector<SolverInterface *> inner;
+      for (int j = 0; j < redWorkers; j++) {
+         inner.push_back(SolverFactory::cloneSolver(solvers[0]));
+      }
+      solvers.push_back(SolverFactory::createReducerSolver(inner));
+   }
    int nSolvers = solvers.size();
 
-   SolverFactory::nativeDiversification(solvers);
+   // Each solver family has its own native diversification
+   vector<SolverInterface *> solvers_maple(solvers.begin(),
+                                           solvers.begin() + nCDCL -
+                                           solvers_chrono.size());
+   solvers_maple.insert(solvers_maple.end(), solvers.begin() + nCDCL,
+                        solvers.end());
+
+   SolverFactory::nativeDiversification(solvers_maple);
+   SolverFactory::nativeDiversification(solvers_chrono);
 
    for (int id = 0; id < nSolvers; id++) {
       if (id % 2) {
@@ -106,11 +430,37 @@ int main(int argc, char ** argv)
       }
    }
 
-   SolverFactory::sparseRandomDiversification(solvers_LRB);
-   SolverFactory::sparseRandomDiversification(solvers_VSIDS);
+   // Each process diversifies its solvers differently
+   int seed = group != NULL ? group->getIndex() : rank;
+
+   SolverFactory::sparseRandomDiversification(solvers_LRB, seed);
+   SolverFactory::sparseRandomDiversification(solvers_VSIDS, seed);
+
+   vector<SolverInterface *> solvers_ls;
+   for (int i = 0; i < nLocalSearch; i++) {
+      solvers_ls.push_back(SolverFactory::createLocalSearchSolver());
+      solvers_ls[i]->diversify(i);
+   }
+
+   // Record the sharing, one trace per process
+   if (Parameters::getBoolParam("shr-trace")) {
+      string tracePath = Parameters::getParam("shr-trace");
+
+      if (group != NULL || nProcs > 1) {
+         tracePath += "." + to_string(seed);
+      }
+
+      sharingTrace = new SharingTrace();
+
+      if (sharingTrace->open(tracePath.c_str(), true) == false) {
+         cerr << "Cannot write the sharing trace " << tracePath << endl;
+         delete sharingTrace;
+         sharingTrace = NULL;
+      }
+   }
 
    // Init Sharing
-   // 15 CDCL, 1 Reducer producers by Sharer
+   // Half of the CDCL, 1 Reducer producers by Sharer
    vector<SolverInterface* > prod1;
    vector<SolverInterface* > prod2;
    vector<SolverInterface *> reducerCons1;
@@ -118,27 +468,29 @@ int main(int argc, char ** argv)
    vector<SolverInterface* > cons1;
    vector<SolverInterface* > cons2;
    vector<SolverInterface*> consCDCL;
+   vector<Sharer *> sharerList;
 
    switch (Parameters::getIntParam("shr-strat", 1))
    {
    case 1:
-      prod1.insert(prod1.end(), solvers.begin(), solvers.begin() + (cpus/2 - 1));
+      prod1.insert(prod1.end(), solvers.begin(), solvers.begin() + nCDCL / 2);
       prod1.push_back(solvers[solvers.size() - 2]);
-      prod2.insert(prod2.end(), solvers.begin() + (cpus/2 - 1), solvers.end() - 2);
+      prod2.insert(prod2.end(), solvers.begin() + nCDCL / 2, solvers.end() - 2);
       prod2.push_back(solvers[solvers.size() - 1]);
-      // 30 CDCL, 1 Reducer consumers by Sharer
+      // All CDCL, 1 Reducer consumers by Sharer
       cons1.insert(cons1.end(), solvers.begin(), solvers.end() - 1);
       cons2.insert(cons2.end(), solvers.begin(), solvers.end() - 2);
       cons2.push_back(solvers[solvers.size() - 1]);
+      // The local search solvers only use the units
+      cons1.insert(cons1.end(), solvers_ls.begin(), solvers_ls.end());
+      cons2.insert(cons2.end(), solvers_ls.begin(), solvers_ls.end());
 
-      nSharers = 2;
-      sharers  = new Sharer*[nSharers];
-      sharers[0] = new Sharer(1, new HordeSatSharing(), prod1, cons1);
-      sharers[1] = new Sharer(2, new HordeSatSharing(), prod2, cons2);
+      sharerList.push_back(new Sharer(1, new HordeSatSharing(), prod1, cons1));
+      sharerList.push_back(new Sharer(2, new HordeSatSharing(), prod2, cons2));
       break;
    case 2:
-      prod1.insert(prod1.end(), solvers.begin(), solvers.begin() + (cpus/2 - 1));
-      prod2.insert(prod2.end(), solvers.begin() + (cpus/2 - 1), solvers.end() - 2);
+      prod1.insert(prod1.end(), solvers.begin(), solvers.begin() + nCDCL / 2);
+      prod2.insert(prod2.end(), solvers.begin() + nCDCL / 2, solvers.end() - 2);
       reducerCons1.push_back(solvers[solvers.size() - 2]);
       reducerCons2.push_back(solvers[solvers.size() - 1]);
 
@@ -148,22 +500,211 @@ int main(int argc, char ** argv)
       cons2.push_back(solvers[solvers.size() - 1]);
       consCDCL.insert(consCDCL.end(), prod1.begin(), prod1.end());
       consCDCL.insert(consCDCL.end(), prod2.begin(), prod2.end());
-
-      nSharers = 4;
-      sharers  = new Sharer*[nSharers];
-      sharers[0] = new Sharer(1, new HordeSatSharing(), prod1, cons1);
-      sharers[1] = new Sharer(2, new HordeSatSharing(), prod2, cons2);
-      sharers[2] = new Sharer(3, new HordeSatSharing(), reducerCons1, consCDCL);
-      sharers[3] = new Sharer(4, new HordeSatSharing(), reducerCons2, consCDCL);
+      consCDCL.insert(consCDCL.end(), solvers_ls.begin(), solvers_ls.end());
+
+      sharerList.push_back(new Sharer(1, new HordeSatSharing(), prod1, cons1));
+      sharerList.push_back(new Sharer(2, new HordeSatSharing(), prod2, cons2));
+      sharerList.push_back(new Sharer(3, new HordeSatSharing(), reducerCons1,
+                                      consCDCL));
+      sharerList.push_back(new Sharer(4, new HordeSatSharing(), reducerCons2,
+                                      consCDCL));
       break;
    default:
       break;
    }
 
+#ifdef USE_MPI
+   // The clauses shared locally are exchanged with the other processes
+   MpiBridge * bridge = NULL;
+
+   if (nProcs > 1) {
+      bridge = (MpiBridge *)SolverFactory::createMpiBridge();
+
+      for (size_t i = 0; i < sharerList.size(); i++) {
+         sharerList[i]->addConsumer(bridge);
+      }
+
+      if (sharerList.size() > 0) {
+         sharerList[0]->addProducer(bridge);
+      }
+   }
+#endif
+
+   // The clauses shared locally go through the rings of the process group
+   ShmBridge * shmBridge = NULL;
+
+   if (group != NULL) {
+      shmBridge = (ShmBridge *)SolverFactory::createShmBridge(group);
+
+      for (size_t i = 0; i < sharerList.size(); i++) {
+         sharerList[i]->addConsumer(shmBridge);
+      }
+
+      // The clauses of the others have been selected by their sharers, a
+      // sharer of its own gives them to the solvers every shm-period, instead
+      // of waiting for a round of the local sharers
+      if (sharerList.size() > 0) {
+         vector<SolverInterface *> remoteCons(solvers.begin(), solvers.end());
+         remoteCons.insert(remoteCons.end(), solvers_ls.begin(),
+                           solvers_ls.end());
+
+         sharerList.push_back(new Sharer(sharerList.size() + 1,
+                                         new ForwardSharing(),
+                                         vector<SolverInterface *>(1, shmBridge),
+                                         remoteCons,
+                                         Parameters::getIntParam("shm-period",
+                                                                 10000)));
+      }
+   }
+
+   // Activity sharing between the CDCL solvers
+   if (Parameters::getBoolParam("act-share")) {
+      vector<SolverInterface *> cdcl(solvers.begin(), solvers.begin() + nCDCL);
+
+      sharerList.push_back(new Sharer(sharerList.size() + 1,
+                                      new ActivitySharing(), cdcl, cdcl));
+   }
+
+   // Phase sharing between the CDCL solvers
+   if (Parameters::getBoolParam("phs-share")) {
+      vector<SolverInterface *> cdcl(solvers.begin(), solvers.begin() + nCDCL);
+
+      sharerList.push_back(new Sharer(sharerList.size() + 1,
+                                      new PhaseSharing(), cdcl, cdcl));
+   }
+
+   // The local search solvers start from the phases of the CDCL solvers,
+   // their best assignments are hints for the CDCL solvers
+   if (nLocalSearch > 0) {
+      vector<SolverInterface *> cdcl(solvers.begin(), solvers.begin() + nCDCL);
+
+      sharerList.push_back(new Sharer(sharerList.size() + 1,
+                                      new PhaseSharing(), cdcl, solvers_ls));
+      sharerList.push_back(new Sharer(sharerList.size() + 1,
+                                      new PhaseSharing(), solvers_ls, cdcl));
+   }
+
+   nSharers = sharerList.size();
+   sharers  = new Sharer*[nSharers];
+   for (int i = 0; i < nSharers; i++) {
+      sharers[i] = sharerList[i];
+   }
+
+   // Init the log of units and binaries, before the solvers start
+   if (Parameters::getBoolParam("unit-log")) {
+      unitLog = new UnitLog(solvers[0]->getVariablesCount(),
+                            Parameters::getIntParam("unit-log-bin", 1000000));
+   }
+
+   // Init the table of the learnt clauses, before the solvers start
+   if (Parameters::getIntParam("dup-share", 0) > 0) {
+      if (nCDCL > DUPLICATE_SOLVER_BITS) {
+         cerr << "The table of the learnt clauses only counts " <<
+            DUPLICATE_SOLVER_BITS << " of the " << nCDCL << " CDCL solvers" <<
+            endl;
+      }
+
+      duplicateTable =
+         new DuplicateTable(Parameters::getIntParam("dup-size", 20),
+                            Parameters::getIntParam("dup-share", 0),
+                            Parameters::getIntParam("dup-lbd", 12));
+   }
+
    // Init working
+   DivideAndConquer * dc      = NULL;
+   CubeGenerator * generator  = NULL;
+   Hybrid * hybrid            = NULL;
+   FitnessPortfolio * fitness = NULL;
+
+#ifdef USE_MPI
+   DistributedDivideAndConquer * ddc = NULL;
+#endif
+
    working = new Portfolio();
-   for (size_t i = 0; i < nSolvers; i++) {
-      working->addSlave(new SequentialWorker(solvers[i]));
+
+   switch (Parameters::getIntParam("wkr-strat", 1))
+   {
+   case 3:
+      // Lookahead threads split the formula in cubes for the CDCL solvers
+      dc        = new DivideAndConquer();
+      generator = new CubeGenerator(dc, Parameters::getIntParam("cube-threads",
+                                                                2));
+      if (generator->loadFormula(Parameters::getFilename())) {
+         dc->expectCubes();
+      } else {
+         // The solvers split the search space by themselves
+         cerr << "The cube generator cannot load " <<
+            Parameters::getFilename() << ", running wkr-strat 2" << endl;
+         delete generator;
+         generator = NULL;
+      }
+      // Fallthrough
+   case 2:
+      // The MapleCOMSPS solvers split the search space, the other solvers
+      // still run
+      if (dc == NULL)
+         dc = new DivideAndConquer();
+      for (int i = 0; i < nMaple; i++) {
+         dc->addSlave(new SequentialWorker(solvers[i]));
+      }
+
+#ifdef USE_MPI
+      // The processes split the search space between them
+      if (bridge != NULL && generator == NULL &&
+          Parameters::getBoolParam("mpi-dc")) {
+         ddc = new DistributedDivideAndConquer(dc, rank, nProcs);
+         bridge->setWork(ddc);
+         working->addSlave(ddc);
+         dc = NULL;
+      }
+#endif
+
+      if (dc != NULL) {
+         working->addSlave(dc);
+      }
+
+      for (int i = nMaple; i < nSolvers; i++) {
+         working->addSlave(new SequentialWorker(solvers[i]));
+      }
+      break;
+   case 4:
+      // The MapleCOMSPS solvers start as a portfolio, the other solvers
+      // still run
+      hybrid = new Hybrid();
+      for (int i = 0; i < nMaple; i++) {
+         hybrid->addWorker(new SequentialWorker(solvers[i]));
+      }
+      working->addSlave(hybrid);
+
+      for (int i = nMaple; i < nSolvers; i++) {
+         working->addSlave(new SequentialWorker(solvers[i]));
+      }
+      break;
+   default:
+      if (Parameters::getBoolParam("fitness")) {
+         // The CDCL solvers may be replaced, the reducers are kept
+         fitness = new FitnessPortfolio();
+         for (int i = 0; i < nCDCL; i++) {
+            fitness->addWorker(new SequentialWorker(solvers[i]));
+         }
+         working->addSlave(fitness);
+
+         for (int i = nCDCL; i < nSolvers; i++) {
+            working->addSlave(new SequentialWorker(solvers[i]));
+         }
+         break;
+      }
+
+      for (size_t i = 0; i < nSolvers; i++) {
+         working->addSlave(new SequentialWorker(solvers[i]));
+      }
+      break;
+   }
+
+
+   // The local search solvers are members of the top portfolio
+   for (int i = 0; i < nLocalSearch; i++) {
+      working->addSlave(new SequentialWorker(solvers_ls[i]));
    }
 
 
@@ -175,18 +716,42 @@ int main(int argc, char ** argv)
    vector<int> cube;
    working->solve(cube);
 
+   if (generator != NULL) {
+      generator->start(cube);
+   }
+
 
-   // Wait until end or timeout
+   // Wait until end or timeout, the first result wakes the main thread
    int timeout = Parameters::getIntParam("t", -1);
+   long left   = -1;
 
-   while(globalEnding == false) {
-      sleep(1);
+   if (timeout > 0) {
+      left = max(0.0, timeout - getRelativeTime()) * 1000000;
+   }
+
+   if (waitGlobalEnding(left) == false) {
+      setGlobalEnding();
+   }
 
-      if (timeout > 0 && getRelativeTime() >= timeout) {
-         globalEnding = true;
-         working->setInterrupt();
+   // The solvers still running stop, the sharers are already awake
+   working->setInterrupt();
+
+   // The rounds in progress are not recorded
+   if (sharingTrace != NULL) {
+      sharingTrace->close();
+   }
+
+#ifdef USE_MPI
+   // The process 0 prints the result of the first process that has one
+   if (bridge != NULL) {
+      bridge->join();
+      bridge->gatherResult();
+
+      if (Parameters::getIntParam("v", 0) > 0) {
+         bridge->printStats();
       }
    }
+#endif
 
 
    // Delete sharers
@@ -200,6 +765,50 @@ int main(int argc, char ** argv)
    // Print solver stats
    // SolverFactory::printStats(solvers);
 
+   if (Parameters::getIntParam("v", 0) > 0) {
+      for (int id = nCDCL; id < nSolvers; id++) {
+         ((Reducer *)solvers[id])->printStatsStrengthening();
+      }
+
+      if (unitLog != NULL) {
+         unitLog->printStats();
+      }
+
+      if (sharingTrace != NULL) {
+         sharingTrace->printStats();
+      }
+
+      if (duplicateTable != NULL) {
+         duplicateTable->printStats();
+      }
+
+      if (dc != NULL) {
+         dc->printStats();
+      }
+
+      if (generator != NULL) {
+         generator->printStats();
+      }
+
+      if (hybrid != NULL) {
+         hybrid->printStats();
+      }
+
+      if (fitness != NULL) {
+         fitness->printStats();
+      }
+
+      if (shmBridge != NULL) {
+         shmBridge->printStats();
+      }
+
+#ifdef USE_MPI
+      if (ddc != NULL) {
+         ddc->printStats();
+      }
+#endif
+   }
+
 
    // Delete working strategy
    // delete working;
@@ -209,20 +818,18 @@ int main(int argc, char ** argv)
    ClauseManager::joinClauseManager();
 
 
-   // Print the result and the model if SAT
+   // Print the result and the model if SAT, once for all the processes
    // cout << "c Resolution time: " << getRelativeTime() << "s" << endl;
 
-   if (finalResult == SAT) {
-      cout << "s SATISFIABLE" << endl;
-
-      if (Parameters::getBoolParam("no-model") == false) {
-         printModel(finalModel);
-      }
-   } else if (finalResult == UNSAT) {
-      cout << "s UNSATISFIABLE" << endl;
-   } else {
-      cout << "s UNKNOWN" << endl;
+   if (group != NULL) {
+      group->sendResult();
+   } else if (rank == 0) {
+      printResult();
    }
 
+#ifdef USE_MPI
+   MPI_Finalize();
+#endif
+
    return 0;
 }
@@ -19,7 +19,10 @@
 
 #pragma once
 
+#include "clauses/DuplicateTable.h"
+#include "clauses/UnitLog.h"
 #include "sharing/Sharer.h"
+#include "sharing/SharingTrace.h"
 #include "solvers/SolverInterface.h"
 #include "working/WorkingStrategy.h"
 
@@ -40,8 +43,27 @@ extern Sharer ** sharers;
 /// Size of the array of sharers
 extern int nSharers;
 
+/// Log of the shared units and binaries, NULL if not used
+extern UnitLog * unitLog;
+
+/// Table of the clauses learnt by the solvers, NULL if not used
+extern DuplicateTable * duplicateTable;
+
+/// Trace of the sharing, NULL if not recorded
+extern SharingTrace * sharingTrace;
+
 /// Final result
 extern SatResult finalResult;
 
 /// Model for SAT instances
 extern vector<int> finalModel;
+
+/// Give the final result, only the first one is kept, and end the search.
+void setFinalResult(SatResult res, const vector<int> & model);
+
+/// End the search without result, wake the threads waiting for the end.
+void setGlobalEnding();
+
+/// Wait for the end of the search, at most useconds if not negative. Return
+/// true if the search has ended.
+bool waitGlobalEnding(long useconds);
@@ -0,0 +1,145 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#include "../sharing/ActivitySharing.h"
+#include "../utils/Logger.h"
+#include "../utils/Parameters.h"
+
+#include <algorithm>
+
+ActivitySharing::ActivitySharing()
+{
+   focusSize = Parameters::getIntParam("act-k", 100);
+   nStrong   = Parameters::getIntParam("act-strong", 2);
+   maxBump   = Parameters::getIntParam("act-bump", 2);
+   period    = Parameters::getIntParam("act-period", 10);
+   round     = 0;
+}
+
+ActivitySharing::~ActivitySharing()
+{
+}
+
+void
+ActivitySharing::doSharing(int idSharer, const vector<SolverInterface *> & from,
+                           const vector<SolverInterface *> & to)
+{
+   round++;
+
+   // The consumers that just joined catch up with the current focus
+   for (size_t j = 0; j < to.size(); j++) {
+      if (informed.insert(to[j]->id).second && focus.empty() == false) {
+         blendFocus(to[j]);
+      }
+   }
+
+   if (round % period)
+      return;
+
+   // Rank the producers by conflicts since the last broadcast
+   vector<pair<unsigned long, SolverInterface *> > ranking;
+
+   for (size_t i = 0; i < from.size(); i++) {
+      unsigned long conflicts = from[i]->getStatistics().conflicts;
+      unsigned long last      = lastConflicts[from[i]->id];
+
+      lastConflicts[from[i]->id] = conflicts;
+
+      ranking.push_back(make_pair(conflicts - last, from[i]));
+   }
+
+   sort(ranking.begin(), ranking.end(),
+        [](const pair<unsigned long, SolverInterface *> & a,
+           const pair<unsigned long, SolverInterface *> & b) {
+           return a.first > b.first;
+        });
+
+   if (ranking.size() > nStrong)
+      ranking.resize(nStrong);
+
+   // Merge the lists, a variable scores more when it is ranked higher
+   unordered_map<int, int> scores;
+   vector<int> vars;
+
+   for (size_t i = 0; i < ranking.size(); i++) {
+      ranking[i].second->getActiveVariables(focusSize, vars);
+
+      if (vars.empty() == false)
+         stats.receivedClauses++;
+
+      for (size_t r = 0; r < vars.size(); r++) {
+         scores[vars[r]] += focusSize - r;
+      }
+   }
+
+   if (scores.empty())
+      return;
+
+   vector<pair<int, int> > merged(scores.begin(), scores.end());
+
+   sort(merged.begin(), merged.end(),
+        [](const pair<int, int> & a, const pair<int, int> & b) {
+           return a.second > b.second ||
+                  (a.second == b.second && a.first < b.first);
+        });
+
+   if (merged.size() > focusSize)
+      merged.resize(focusSize);
+
+   focus.clear();
+   for (size_t i = 0; i < merged.size(); i++) {
+      focus.push_back(merged[i].first);
+   }
+
+   log(1, "Sharer %d new focus of %zu variables from %zu solvers\n", idSharer,
+       focus.size(), ranking.size());
+
+   // Blend the focus in the other consumers
+   for (size_t j = 0; j < to.size(); j++) {
+      bool strong = false;
+
+      for (size_t i = 0; i < ranking.size(); i++) {
+         if (ranking[i].second->id == to[j]->id)
+            strong = true;
+      }
+
+      if (strong)
+         continue;
+
+      blendFocus(to[j]);
+   }
+}
+
+void
+ActivitySharing::blendFocus(SolverInterface * solver)
+{
+   for (size_t r = 0; r < focus.size(); r++) {
+      int times = maxBump - (r * maxBump) / focus.size();
+      solver->bumpVariableActivity(focus[r], times);
+   }
+
+   stats.sharedClauses += focus.size();
+}
+
+SharingStatistics
+ActivitySharing::getStatistics()
+{
+   return stats;
+}
@@ -0,0 +1,81 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "../sharing/SharingStrategy.h"
+#include "../solvers/SolverInterface.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/// This strategy shares the most active variables of the strongest producers
+/// (the ones with the most conflicts since the last broadcast). Their lists
+/// are merged in a focus that is bumped in the heuristics of the other
+/// consumers. A consumer joining the sharer later, a clone of the fitness
+/// portfolio for instance, gets the current focus at its first round.
+/// Statistics count the received lists and the bumped variables.
+class ActivitySharing : public SharingStrategy
+{
+public:
+   /// Constructor.
+   ActivitySharing();
+
+   /// Destructor.
+   ~ActivitySharing();
+
+   /// This method shared the focus from the producers to the consumers.
+   void doSharing(int idSharer, const vector<SolverInterface *> & from,
+                  const vector<SolverInterface *> & to);
+
+   /// Return the sharing statistics of this sharng strategy.
+   SharingStatistics getStatistics();
+
+protected:
+   /// Bump the variables of the focus in a solver, the first ones the most.
+   void blendFocus(SolverInterface * solver);
+
+   /// Number of variables in the focus.
+   int focusSize;
+
+   /// Number of producers whose activities are merged.
+   int nStrong;
+
+   /// Number of bumps given to the most active variable of the focus.
+   int maxBump;
+
+   /// Number of rounds between two broadcasts.
+   int period;
+
+   /// Number of rounds since the creation.
+   int round;
+
+   /// Number of conflicts of the producers at the last broadcast.
+   unordered_map<int, unsigned long> lastConflicts;
+
+   /// Current focus.
+   vector<int> focus;
+
+   /// Ids of the consumers seen by this strategy.
+   unordered_set<int> informed;
+
+   /// Sharing statistics.
+   SharingStatistics stats;
+};
@@ -0,0 +1,204 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#include "../clauses/ClauseManager.h"
+#include "../sharing/BarrierSharing.h"
+#include "../utils/Parameters.h"
+
+using namespace std;
+
+BarrierSharing::BarrierSharing(int nSolvers, int period)
+{
+   this->nSolvers = nSolvers;
+   this->period   = period;
+
+   literalsPerRound = Parameters::getIntParam("shr-lit", 1500);
+
+   arrived    = 0;
+   generation = 0;
+   ended      = false;
+   winner     = -1;
+   nSelected  = 0;
+
+   done.resize(nSolvers, false);
+   periodClauses.resize(nSolvers);
+
+   for (int i = 0; i < nSolvers; i++) {
+      databases.push_back(new ClauseDatabase());
+   }
+
+   pthread_mutex_init(&mutexBarrier, NULL);
+   pthread_cond_init (&condBarrier, NULL);
+}
+
+BarrierSharing::~BarrierSharing()
+{
+   for (int i = 0; i < nSolvers; i++) {
+      delete databases[i];
+
+      for (size_t k = 0; k < periodClauses[i].size(); k++) {
+         ClauseManager::releaseClause(periodClauses[i][k]);
+      }
+   }
+
+   for (size_t i = 0; i < selection.size(); i++) {
+      ClauseManager::releaseClause(selection[i].second);
+   }
+
+   pthread_mutex_destroy(&mutexBarrier);
+   pthread_cond_destroy (&condBarrier);
+}
+
+int
+BarrierSharing::getPeriod()
+{
+   return period;
+}
+
+bool
+BarrierSharing::exchange(int slot, vector<ClauseExchange *> & exported,
+                         vector<ClauseExchange *> & imported)
+{
+   return arrive(slot, false, &exported, &imported);
+}
+
+bool
+BarrierSharing::finish(int slot)
+{
+   arrive(slot, true, NULL, NULL);
+
+   return winner == slot;
+}
+
+bool
+BarrierSharing::hasEnded()
+{
+   pthread_mutex_lock(&mutexBarrier);
+   bool res = ended;
+   pthread_mutex_unlock(&mutexBarrier);
+
+   return res;
+}
+
+void
+BarrierSharing::setInterrupt()
+{
+   pthread_mutex_lock  (&mutexBarrier);
+   ended = true;
+   pthread_cond_broadcast(&condBarrier);
+   pthread_mutex_unlock(&mutexBarrier);
+}
+
+bool
+BarrierSharing::arrive(int slot, bool result, vector<ClauseExchange *> *
+                       exported, vector<ClauseExchange *> * imported)
+{
+   pthread_mutex_lock(&mutexBarrier);
+
+   if (ended) {
+      pthread_mutex_unlock(&mutexBarrier);
+      return false;
+   }
+
+   done[slot] = result;
+
+   if (exported != NULL) {
+      periodClauses[slot].swap(*exported);
+   }
+
+   if (++arrived == nSolvers) {
+      select();
+
+      arrived = 0;
+      generation++;
+
+      pthread_cond_broadcast(&condBarrier);
+   } else {
+      unsigned long current = generation;
+
+      while (generation == current && ended == false) {
+         pthread_cond_wait(&condBarrier, &mutexBarrier);
+      }
+   }
+
+   // The clauses of the others, in the order of the slots
+   if (imported != NULL && ended == false) {
+      for (size_t i = 0; i < selection.size(); i++) {
+         if (selection[i].first != slot) {
+            ClauseManager::increaseClause(selection[i].second);
+            imported->push_back(selection[i].second);
+         }
+      }
+   }
+
+   bool res = ended == false;
+
+   pthread_mutex_unlock(&mutexBarrier);
+
+   return res;
+}
+
+void
+BarrierSharing::select()
+{
+   for (size_t i = 0; i < selection.size(); i++) {
+      ClauseManager::releaseClause(selection[i].second);
+   }
+
+   selection.clear();
+
+   // The first solver with a result wins
+   for (int i = 0; i < nSolvers && winner < 0; i++) {
+      if (done[i])
+         winner = i;
+   }
+
+   if (winner >= 0) {
+      ended = true;
+      return;
+   }
+
+   vector<ClauseExchange *> tmp;
+
+   for (int i = 0; i < nSolvers; i++) {
+      for (size_t k = 0; k < periodClauses[i].size(); k++) {
+         databases[i]->addClause(periodClauses[i][k]);
+      }
+
+      periodClauses[i].clear();
+
+      int selectCount;
+      tmp.clear();
+      databases[i]->giveSelection(tmp, literalsPerRound, &selectCount);
+
+      for (size_t k = 0; k < tmp.size(); k++) {
+         selection.push_back(make_pair(i, tmp[k]));
+      }
+   }
+
+   nSelected += selection.size();
+}
+
+void
+BarrierSharing::printStats()
+{
+   printf("c BarrierSharing barriers %lu, period %d conflicts, selected cls "
+          "%lu, winner %d\n", generation, period, nSelected, winner);
+}
@@ -0,0 +1,115 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "../clauses/ClauseDatabase.h"
+#include "../clauses/ClauseExchange.h"
+
+#include <pthread.h>
+#include <vector>
+
+using namespace std;
+
+/// Deterministic sharing: the solvers exchange their clauses at barriers
+/// every period conflicts, instead of a sharer waking on the wall clock.
+/// The clauses of a period are selected per producer as by HordeSat and
+/// given to every solver in the order of the producers. A solver that has
+/// a result arrives at its next barrier with it: the search ends at this
+/// barrier and the winner is the first solver with a result, whatever the
+/// speed of the threads. Each solver has a slot, from 0 to nSolvers - 1.
+class BarrierSharing
+{
+public:
+   /// Constructor.
+   BarrierSharing(int nSolvers, int period);
+
+   /// Destructor.
+   ~BarrierSharing();
+
+   /// Number of conflicts between two barriers.
+   int getPeriod();
+
+   /// Give the clauses of the period of a solver, wait for the others and
+   /// get their clauses. Return false if the search has ended.
+   bool exchange(int slot, vector<ClauseExchange *> & exported,
+                 vector<ClauseExchange *> & imported);
+
+   /// A solver has a result, wait for the others at the barrier. Return true
+   /// if it is the winner.
+   bool finish(int slot);
+
+   /// Has the search ended.
+   bool hasEnded();
+
+   /// End the search, the waiting solvers are released.
+   void setInterrupt();
+
+   /// Print the statistics of the barriers.
+   void printStats();
+
+protected:
+   /// Arrive at a barrier, return false if the search has ended.
+   bool arrive(int slot, bool done, vector<ClauseExchange *> * exported,
+               vector<ClauseExchange *> * imported);
+
+   /// Select the clauses of the period, called by the last solver arrived.
+   void select();
+
+   /// Number of solvers.
+   int nSolvers;
+
+   /// Number of conflicts between two barriers.
+   int period;
+
+   /// Number of literals selected per producer and period.
+   int literalsPerRound;
+
+   /// Number of solvers arrived at the current barrier.
+   int arrived;
+
+   /// Number of the current barrier.
+   unsigned long generation;
+
+   /// Has the search ended.
+   bool ended;
+
+   /// Slot of the winner, -1 if none.
+   int winner;
+
+   /// Has each solver a result.
+   vector<bool> done;
+
+   /// Clauses of the period of each solver.
+   vector<vector<ClauseExchange *> > periodClauses;
+
+   /// Clauses waiting for their selection, one database per solver.
+   vector<ClauseDatabase *> databases;
+
+   /// Clauses selected at the last barrier, with their slot.
+   vector<pair<int, ClauseExchange *> > selection;
+
+   /// Number of selected clauses.
+   unsigned long nSelected;
+
+   /// Mutex and condition of the barrier.
+   pthread_mutex_t mutexBarrier;
+   pthread_cond_t  condBarrier;
+};
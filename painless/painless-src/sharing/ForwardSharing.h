@@ -0,0 +1,52 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "../sharing/SharingStrategy.h"
+#include "../solvers/SolverInterface.h"
+
+#include <vector>
+
+/// This strategy gives all the clauses of each producer to every consumer,
+/// without any selection. It serves the producers whose clauses have already
+/// been selected elsewhere, as the bridges to other processes.
+class ForwardSharing : public SharingStrategy
+{
+public:
+   /// Constructor.
+   ForwardSharing();
+
+   /// Destructor.
+   ~ForwardSharing();
+
+   /// This method shared clauses from the producers to the consumers.
+   void doSharing(int idSharer, const vector<SolverInterface *> & from,
+                  const vector<SolverInterface *> & to);
+
+   /// Return the sharing statistics of this sharng strategy.
+   SharingStatistics getStatistics();
+
+protected:
+   /// Used to get the clauses of a producer.
+   vector<ClauseExchange *> tmp;
+
+   /// Sharing statistics.
+   SharingStatistics stats;
+};
@@ -18,13 +18,32 @@
 // -----------------------------------------------------------------------------
 
 #include "../clauses/ClauseManager.h"
+#include "../painless.h"
 #include "../sharing/HordeSatSharing.h"
 #include "../solvers/SolverFactory.h"
 #include "../utils/Logger.h"
 #include "../utils/Parameters.h"
 
+#include <algorithm>
+
+/// Minimum number of imported clauses before their usage is trusted.
+#define FEEDBACK_MIN_IMPORTS 200
+
+/// The clauses of a LBD are dropped when they are used this many times less
+/// than the ones of the best LBD of their producer.
+#define FEEDBACK_LBD_RATIO 4
+
+/// The dropped LBD are shared once every this many rounds, so that their
+/// usage is still measured.
+#define FEEDBACK_PROBE 10
+
 HordeSatSharing::HordeSatSharing()
 {
+   this->feedback  = Parameters::getBoolParam("shr-feedback");
+   this->nRounds   = 0;
+   this->meanUsage = 0;
+   this->nFiltered = 0;
+
    this->literalPerRound = Parameters::getIntParam("shr-lit", 1500);
    this->initPhase = true;
    // number of round corresponding to 5% of the 5000s timeout
@@ -43,9 +62,37 @@ HordeSatSharing::doSharing(int idSharer, const vector<SolverInterface *> & from,
                            const vector<SolverInterface *> & to)
 {
    static unsigned int round = 1;
+
+   // Drop the clauses of the producers that left the sharer
+   for (auto it = databases.begin(); it != databases.end();) {
+      bool present = false;
+
+      for (size_t i = 0; i < from.size(); i++) {
+         if (from[i]->id == it->first) {
+            present = true;
+            break;
+         }
+      }
+
+      if (present) {
+         it++;
+      } else {
+         delete it->second;
+         it = databases.erase(it);
+      }
+   }
+
+   if (feedback) {
+      updateUsage(idSharer, from, to);
+   }
+
+   // The clauses of all the LBD are shared in the probing rounds
+   bool probe = nRounds++ % FEEDBACK_PROBE == 0;
+
    for (size_t i = 0; i < from.size(); i++) {
       int used, usedPercent, selectCount;
-      int id = from[i]->id;
+      int id     = from[i]->id;
+      int budget = feedback ? getBudget(id) : literalPerRound;
 
       if (!this->databases.count(id)) {
           this->databases[id] = new ClauseDatabase();
@@ -57,25 +104,43 @@ HordeSatSharing::doSharing(int idSharer, const vector<SolverInterface *> & from,
 
       stats.receivedClauses += tmp.size();
 
+      if (sharingTrace != NULL) {
+         sharingTrace->recordBatch(idSharer, id, tmp);
+      }
+
       for (size_t k = 0; k < tmp.size(); k++) {
+         if (feedback && probe == false && keepLbd(id, tmp[k]->lbd) == false) {
+            ClauseManager::releaseClause(tmp[k]);
+            nFiltered++;
+            continue;
+         }
+
          this->databases[id]->addClause(tmp[k]);
       }
 
       tmp.clear();
 
-      used        = this->databases[id]->giveSelection(tmp, literalPerRound, &selectCount);
-      usedPercent = (100 * used) / literalPerRound;
+      used        = this->databases[id]->giveSelection(tmp, budget, &selectCount);
+      usedPercent = (100 * used) / budget;
 
       stats.sharedClauses += tmp.size();
 
+      int request = 0;
+
       if (usedPercent < 75 && !this->initPhase) {
          from[i]->increaseClauseProduction();
          log(1, "Sharer %d production increase for solver %d.\n", idSharer,
              from[i]->id);
+         request = 1;
       } else if (usedPercent > 98) {
          from[i]->decreaseClauseProduction();
          log(1, "Sharer %d production decrease for solver %d.\n", idSharer,
              from[i]->id);
+         request = 2;
+      }
+
+      if (sharingTrace != NULL) {
+         sharingTrace->recordSelection(idSharer, id, tmp.size(), used, request);
       }
 
       if (selectCount > 0) {
@@ -101,6 +166,117 @@ HordeSatSharing::doSharing(int idSharer, const vector<SolverInterface *> & from,
       }
    }
    round++;
+
+   if (sharingTrace != NULL) {
+      sharingTrace->recordRound(idSharer);
+   }
+}
+
+void
+HordeSatSharing::updateUsage(int idSharer,
+                             const vector<SolverInterface *> & from,
+                             const vector<SolverInterface *> & to)
+{
+   vector<ClauseUsage> counts;
+
+   for (size_t j = 0; j < to.size(); j++) {
+      to[j]->getImportUsage(counts);
+   }
+
+   usage.clear();
+
+   for (size_t i = 0; i < counts.size(); i++) {
+      vector<pair<unsigned long, unsigned long> > & lbds =
+         usage[counts[i].producer];
+
+      lbds.resize(USAGE_MAX_LBD + 1);
+      lbds[counts[i].lbd].first  += counts[i].imported;
+      lbds[counts[i].lbd].second += counts[i].used;
+   }
+
+   // Average usage over the producers of this sharer
+   double sum = 0;
+   int n      = 0;
+
+   for (size_t i = 0; i < from.size(); i++) {
+      auto it = usage.find(from[i]->id);
+
+      if (it == usage.end())
+         continue;
+
+      unsigned long imported = 0, used = 0;
+
+      for (size_t lbd = 0; lbd < it->second.size(); lbd++) {
+         imported += it->second[lbd].first;
+         used     += it->second[lbd].second;
+      }
+
+      if (imported >= FEEDBACK_MIN_IMPORTS) {
+         sum += (double)used / imported;
+         n++;
+
+         log(1, "Sharer %d feedback: %lu/%lu clauses of solver %d used\n",
+             idSharer, used, imported, from[i]->id);
+      }
+   }
+
+   meanUsage = n > 0 ? sum / n : 0;
+
+   log(1, "Sharer %d feedback: %lu clauses dropped by their LBD\n", idSharer,
+       nFiltered);
+}
+
+int
+HordeSatSharing::getBudget(int id)
+{
+   auto it = usage.find(id);
+
+   if (it == usage.end() || meanUsage <= 0)
+      return literalPerRound;
+
+   unsigned long imported = 0, used = 0;
+
+   for (size_t lbd = 0; lbd < it->second.size(); lbd++) {
+      imported += it->second[lbd].first;
+      used     += it->second[lbd].second;
+   }
+
+   if (imported < FEEDBACK_MIN_IMPORTS)
+      return literalPerRound;
+
+   // Between half and twice the budget
+   double weight = (double)used / imported / meanUsage;
+   weight        = max(0.5, min(2.0, weight));
+
+   return literalPerRound * weight;
+}
+
+bool
+HordeSatSharing::keepLbd(int id, int lbd)
+{
+   auto it = usage.find(id);
+
+   if (it == usage.end())
+      return true;
+
+   const vector<pair<unsigned long, unsigned long> > & lbds = it->second;
+
+   lbd = max(1, min(lbd, USAGE_MAX_LBD));
+
+   if (lbds[lbd].first < FEEDBACK_MIN_IMPORTS)
+      return true;
+
+   double best = 0;
+
+   for (size_t i = 1; i < lbds.size(); i++) {
+      if (lbds[i].first >= FEEDBACK_MIN_IMPORTS) {
+         best = max(best, (double)lbds[i].second / lbds[i].first);
+      }
+   }
+
+   double rate = (double)lbds[lbd].second / lbds[lbd].first;
+
+   return rate * FEEDBACK_LBD_RATIO >= best;
 }
 
 SharingStatistics
@@ -24,6 +24,7 @@
 #include "../solvers/SolverInterface.h"
 
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 /// This strategy is a hordesat like sharing strategy.
@@ -44,6 +45,17 @@ public:
    SharingStatistics getStatistics();
 
 protected:
+   /// Sum the usage of the imported clauses over the consumers.
+   void updateUsage(int idSharer, const vector<SolverInterface *> & from,
+                    const vector<SolverInterface *> & to);
+
+   /// Literals per round of a producer, weighted by the usage of its
+   /// clauses compared to the other producers.
+   int getBudget(int id);
+
+   /// Should the clauses of a producer with a given LBD be shared.
+   bool keepLbd(int id, int lbd);
+
    /// Number of shared literals per round.
    int literalPerRound;
 
@@ -53,6 +65,22 @@ protected:
    /// Number of round before forcing an increase in production
    int roundBeforeIncrease;
 
+   /// Use the usage of the imported clauses to select the clauses.
+   bool feedback;
+
+   /// Number of rounds.
+   unsigned long nRounds;
+
+   /// Imported and used clauses of each producer per LBD, summed over the
+   /// consumers.
+   unordered_map<int, vector<pair<unsigned long, unsigned long> > > usage;
+
+   /// Average usage of the clauses of the producers.
+   double meanUsage;
+
+   /// Number of clauses dropped because of their LBD.
+   unsigned long nFiltered;
+
    /// Databse used to store the clauses.
    unordered_map<int, ClauseDatabase *> databases;
 
@@ -0,0 +1,385 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#ifdef USE_MPI
+
+#include "../clauses/ClauseManager.h"
+#include "../painless.h"
+#include "../sharing/MpiBridge.h"
+#include "../utils/Logger.h"
+#include "../utils/Parameters.h"
+#include "../utils/System.h"
+#include "../working/DistributedDivideAndConquer.h"
+
+#include <mpi.h>
+
+using namespace std;
+
+// Time in useconds between two checks of the messages of the work
+#define WORK_PERIOD 1000
+
+// Main executed by the thread exchanging with the other processes
+void * mainMpiBridge(void * arg)
+{
+   MpiBridge * bridge = (MpiBridge *)arg;
+
+   int sleepTime = Parameters::getIntParam("shr-sleep", 500000);
+
+   while (true) {
+      DistributedDivideAndConquer * work = bridge->work;
+
+      // The local end starts the last round at once
+      if (work == NULL) {
+         waitGlobalEnding(sleepTime);
+      } else {
+         double roundEnd = getRelativeTime() + sleepTime / 1000000.0;
+
+         do {
+            work->communicate();
+         } while (getRelativeTime() < roundEnd &&
+                  waitGlobalEnding(WORK_PERIOD) == false);
+      }
+
+      if (bridge->exchange())
+         break;
+   }
+
+   DistributedDivideAndConquer * work = bridge->work;
+
+   if (work != NULL) {
+      work->finish();
+   }
+
+   // The end may come from another process
+   setGlobalEnding();
+
+   return NULL;
+}
+
+MpiBridge::MpiBridge(int id) : SolverInterface(id, REMOTE)
+{
+   MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+   MPI_Comm_size(MPI_COMM_WORLD, &nProcs);
+
+   literalsPerRound = Parameters::getIntParam("mpi-lit", 3000);
+
+   codec = ClauseCodec(Parameters::getIntParam("mpi-dict", 0));
+
+   counts.resize(nProcs);
+   displs.resize(nProcs);
+
+   nRounds   = 0;
+   nBytes    = 0;
+   nSent     = 0;
+   nReceived = 0;
+   work      = NULL;
+
+   unitLogCursor = 0;
+
+   thread = new Thread(mainMpiBridge, this);
+}
+
+MpiBridge::~MpiBridge()
+{
+   join();
+
+   vector<ClauseExchange *> clauses;
+
+   clausesToSend.getClauses(clauses);
+   clausesReceived.getClauses(clauses);
+
+   for (size_t i = 0; i < clauses.size(); i++) {
+      ClauseManager::releaseClause(clauses[i]);
+   }
+}
+
+void
+MpiBridge::join()
+{
+   if (thread != NULL) {
+      thread->join();
+      delete thread;
+      thread = NULL;
+   }
+}
+
+bool
+MpiBridge::exchange()
+{
+   bool ended = globalEnding;
+
+   nRounds++;
+
+   // The shortest local clauses are sent
+   vector<ClauseExchange *> clauses;
+
+   clausesToSend.getClauses(clauses);
+
+   // The units and binaries of the local solvers only go through the log
+   if (unitLog != NULL) {
+      unitLog->readClauses(unitLogCursor, id, clauses);
+   }
+
+   for (size_t i = 0; i < clauses.size(); i++) {
+      database.addClause(clauses[i]);
+   }
+
+   clauses.clear();
+
+   int selectCount;
+   database.giveSelection(clauses, literalsPerRound, &selectCount);
+
+   sendBuffer.clear();
+   sendBuffer.push_back(ended);
+
+   codec.encode(clauses, sendBuffer);
+
+   for (size_t i = 0; i < clauses.size(); i++) {
+      ClauseManager::releaseClause(clauses[i]);
+   }
+
+   nSent += clauses.size();
+
+   // Gather the buffers of every process
+   int count = sendBuffer.size();
+
+   MPI_Allgather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT,
+                 MPI_COMM_WORLD);
+
+   nBytes += count;
+
+   int total = 0;
+   for (int p = 0; p < nProcs; p++) {
+      displs[p] = total;
+      total    += counts[p];
+   }
+
+   recvBuffer.resize(total);
+
+   MPI_Allgatherv(sendBuffer.data(), count, MPI_BYTE, recvBuffer.data(),
+                  counts.data(), displs.data(), MPI_BYTE, MPI_COMM_WORLD);
+
+   // Every process reads the same flags, they all end at the same round
+   bool anyEnded = false;
+
+   for (int p = 0; p < nProcs; p++) {
+      if (recvBuffer[displs[p]])
+         anyEnded = true;
+
+      if (p == rank)
+         continue;
+
+      clauses.clear();
+
+      codec.decode(&recvBuffer[displs[p] + 1], counts[p] - 1, clauses);
+
+      for (size_t i = 0; i < clauses.size(); i++) {
+         clauses[i]->from = id;
+      }
+
+      clausesReceived.addClauses(clauses);
+      nReceived += clauses.size();
+   }
+
+   return anyEnded;
+}
+
+void
+MpiBridge::gatherResult()
+{
+   int local = finalResult;
+
+   vector<int> results(nProcs);
+
+   MPI_Allgather(&local, 1, MPI_INT, results.data(), 1, MPI_INT,
+                 MPI_COMM_WORLD);
+
+   int winner = -1;
+
+   for (int p = 0; p < nProcs && winner < 0; p++) {
+      if (results[p] != UNKNOWN)
+         winner = p;
+   }
+
+   if (winner <= 0)
+      return;
+
+   if (rank == winner && results[winner] == SAT) {
+      MPI_Send(finalModel.data(), finalModel.size(), MPI_INT, 0, 0,
+               MPI_COMM_WORLD);
+   }
+
+   if (rank == 0) {
+      finalResult = (SatResult)results[winner];
+
+      if (finalResult == SAT) {
+         MPI_Status status;
+         int size;
+
+         MPI_Probe(winner, 0, MPI_COMM_WORLD, &status);
+         MPI_Get_count(&status, MPI_INT, &size);
+
+         finalModel.resize(size);
+
+         MPI_Recv(finalModel.data(), size, MPI_INT, winner, 0, MPI_COMM_WORLD,
+                  MPI_STATUS_IGNORE);
+      }
+   }
+}
+
+void
+MpiBridge::setWork(DistributedDivideAndConquer * work)
+{
+   this->work = work;
+}
+
+void
+MpiBridge::printStats()
+{
+   printf("c MpiBridge process %d/%d rounds %lu, sent cls %lu in %lu bytes, "
+          "received cls %lu\n", rank, nProcs, nRounds, nSent, nBytes,
+          (unsigned long)nReceived);
+}
+
+bool
+MpiBridge::loadFormula(const char* filename)
+{
+   return false;
+}
+
+int
+MpiBridge::getVariablesCount()
+{
+   return 0;
+}
+
+int
+MpiBridge::getDivisionVariable()
+{
+   return 0;
+}
+
+void
+MpiBridge::setPhase(const int var, const bool phase)
+{
+}
+
+void
+MpiBridge::bumpVariableActivity(const int var, const int times)
+{
+}
+
+void
+MpiBridge::setSolverInterrupt()
+{
+}
+
+void
+MpiBridge::unsetSolverInterrupt()
+{
+}
+
+SatResult
+MpiBridge::solve(const vector<int> & cube)
+{
+   return UNKNOWN;
+}
+
+void
+MpiBridge::addClause(ClauseExchange * clause)
+{
+   ClauseManager::releaseClause(clause);
+}
+
+void
+MpiBridge::addClauses(const vector<ClauseExchange *> & clauses)
+{
+   for (size_t i = 0; i < clauses.size(); i++) {
+      ClauseManager::releaseClause(clauses[i]);
+   }
+}
+
+void
+MpiBridge::addInitialClauses(const vector<ClauseExchange *> & clauses)
+{
+}
+
+void
+MpiBridge::addLearnedClause(ClauseExchange * clause)
+{
+   clausesToSend.addClause(clause);
+}
+
+void
+MpiBridge::addLearnedClauses(const vector<ClauseExchange *> & clauses)
+{
+   clausesToSend.addClauses(clauses);
+}
+
+void
+MpiBridge::getLearnedClauses(vector<ClauseExchange *> & clauses)
+{
+   clausesReceived.getClauses(clauses);
+}
+
+void
+MpiBridge::increaseClauseProduction()
+{
+}
+
+void
+MpiBridge::decreaseClauseProduction()
+{
+}
+
+SolvingStatistics
+MpiBridge::getStatistics()
+{
+   SolvingStatistics stats;
+
+   stats.exported = nReceived;
+
+   return stats;
+}
+
+vector<int>
+MpiBridge::getModel()
+{
+   return vector<int>();
+}
+
+void
+MpiBridge::diversify(int id)
+{
+}
+
+vector<int>
+MpiBridge::getFinalAnalysis()
+{
+   return vector<int>();
+}
+
+vector<int>
+MpiBridge::getSatAssumptions()
+{
+   return vector<int>();
+}
+
+#endif
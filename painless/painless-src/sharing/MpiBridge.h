@@ -0,0 +1,193 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#pragma once
+
+#ifdef USE_MPI
+
+#include "../clauses/ClauseBuffer.h"
+#include "../clauses/ClauseCodec.h"
+#include "../clauses/ClauseDatabase.h"
+#include "../solvers/SolverInterface.h"
+#include "../utils/Threading.h"
+
+#include <vector>
+
+using namespace std;
+
+class DistributedDivideAndConquer;
+
+// Main executed by the thread exchanging with the other processes
+static void * mainMpiBridge(void * arg);
+
+/// Bridge between the local sharers and the other processes of an MPI run,
+/// the sharers see it as a solver. It consumes the clauses shared locally
+/// and produces the clauses received from the other processes. At each
+/// round, every process gathers the shortest clauses of all the others, up
+/// to mpi-lit literals per process. The rounds carry the end of the search
+/// too: once a process has ended, all of them end after the round.
+class MpiBridge : public SolverInterface
+{
+public:
+   /// Load formula from a given dimacs file, return false if failed.
+   bool loadFormula(const char* filename);
+
+   /// Get the number of variables of the current resolution.
+   int getVariablesCount();
+
+   /// Get a variable suitable for search splitting.
+   int getDivisionVariable();
+
+   /// Set initial phase for a given variable.
+   void setPhase(const int var, const bool phase);
+
+   /// Bump activity of a given variable.
+   void bumpVariableActivity(const int var, const int times);
+
+   /// Interrupt resolution, solving cannot continue until interrupt is unset.
+   void setSolverInterrupt();
+
+   /// Remove the SAT solving interrupt request.
+   void unsetSolverInterrupt();
+
+   /// The bridge does not solve, return UNKNOWN.
+   SatResult solve(const vector<int> & cube);
+
+   /// Add a permanent clause to the formula.
+   void addClause(ClauseExchange * clause);
+
+   /// Add a list of permanent clauses to the formula.
+   void addClauses(const vector<ClauseExchange *> & clauses);
+
+   /// Add a list of initial clauses to the formula.
+   void addInitialClauses(const vector<ClauseExchange *> & clauses);
+
+   /// Add a clause to send to the other processes.
+   void addLearnedClause(ClauseExchange * clause);
+
+   /// Add a list of clauses to send to the other processes.
+   void addLearnedClauses(const vector<ClauseExchange *> & clauses);
+
+   /// Get the clauses received from the other processes.
+   void getLearnedClauses(vector<ClauseExchange *> & clauses);
+
+   /// Request the solver to produce more clauses.
+   void increaseClauseProduction();
+
+   /// Request the solver to produce less clauses.
+   void decreaseClauseProduction();
+
+   /// Get the statistics, the exported clauses are the received ones.
+   SolvingStatistics getStatistics();
+
+   /// Return the model in case of SAT result.
+   vector<int> getModel();
+
+   /// Native diversification.
+   void diversify(int id);
+
+   /// Return the final analysis in case of UNSAT result.
+   vector<int> getFinalAnalysis();
+
+   vector<int> getSatAssumptions();
+
+   /// Wait for the last round, it follows the end of the search.
+   void join();
+
+   /// Give the result of the first process that has one to the process 0.
+   /// Called by every process after join.
+   void gatherResult();
+
+   /// Print the statistics of the exchanges.
+   void printStats();
+
+   /// The thread of the bridge handles the messages of a distributed divide
+   /// and conquer between its rounds.
+   void setWork(DistributedDivideAndConquer * work);
+
+   /// Constructor, MPI must be initialized.
+   MpiBridge(int id);
+
+   /// Destructor.
+   virtual ~MpiBridge();
+
+protected:
+   friend void * mainMpiBridge(void * arg);
+
+   /// Exchange the clauses with the other processes. Return true if the
+   /// search has ended in one of them.
+   bool exchange();
+
+   /// Rank of the process.
+   int rank;
+
+   /// Number of processes.
+   int nProcs;
+
+   /// Clauses shared locally, not sent yet.
+   ClauseBuffer clausesToSend;
+
+   /// Clauses received, not given to the sharers yet.
+   ClauseBuffer clausesReceived;
+
+   /// Selection of the clauses to send.
+   ClauseDatabase database;
+
+   /// Number of literals sent per round.
+   int literalsPerRound;
+
+   /// Serialization of the clauses.
+   ClauseCodec codec;
+
+   /// End flag and clauses of this process.
+   vector<uint8_t> sendBuffer;
+
+   /// End flags and clauses of every process.
+   vector<uint8_t> recvBuffer;
+
+   /// Size of the buffer of each process.
+   vector<int> counts;
+
+   /// Position of the buffer of each process.
+   vector<int> displs;
+
+   /// Number of rounds.
+   unsigned long nRounds;
+
+   /// Number of sent bytes.
+   unsigned long nBytes;
+
+   /// Number of sent clauses.
+   unsigned long nSent;
+
+   /// Number of received clauses.
+   atomic<unsigned long> nReceived;
+
+   /// Position of the bridge in the unit log.
+   size_t unitLogCursor;
+
+   /// Distributed divide and conquer, NULL if none.
+   atomic<DistributedDivideAndConquer *> work;
+
+   /// Thread doing the exchanges.
+   Thread * thread;
+};
+
+#endif
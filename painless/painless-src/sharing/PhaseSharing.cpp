@@ -0,0 +1,140 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#include "../sharing/PhaseSharing.h"
+#include "../utils/Logger.h"
+#include "../utils/Parameters.h"
+
+#include <float.h>
+#include <unordered_map>
+
+PhaseSharing::PhaseSharing()
+{
+   period     = Parameters::getIntParam("phs-period", 4);
+   bestTrail  = Parameters::getIntParam("phs-source", 1) == 1;
+   policy     = Parameters::getIntParam("phs-policy", 0);
+   adoptRatio = Parameters::getIntParam("phs-adopt", 50);
+   round      = 0;
+}
+
+PhaseSharing::~PhaseSharing()
+{
+}
+
+void
+PhaseSharing::doSharing(int idSharer, const vector<SolverInterface *> & from,
+                        const vector<SolverInterface *> & to)
+{
+   round++;
+
+   if (round % period)
+      return;
+
+   vector<int> shared;
+   vector<int> lits;
+   int source = -1;
+
+   if (policy == 0) {
+      // The best snapshot: the longest trail, or the saved phases of the
+      // solver learning the clauses of lowest LBD since the last exchange
+      // (the saved phases all have the size of the formula)
+      double bestScore = -DBL_MAX;
+
+      for (size_t i = 0; i < from.size(); i++) {
+         SolvingStatistics current = from[i]->getStatistics();
+         SolvingStatistics & last  = lastStats[from[i]->id];
+
+         unsigned long conflicts = current.conflicts - last.conflicts;
+         unsigned long lbdSum    = current.lbdSum    - last.lbdSum;
+
+         last = current;
+
+         from[i]->getPhases(lits, bestTrail);
+
+         if (lits.empty())
+            continue;
+
+         stats.receivedClauses++;
+
+         double score;
+         if (bestTrail) {
+            score = lits.size();
+         } else {
+            score = conflicts > 0 ? -(double)lbdSum / conflicts : -DBL_MAX;
+         }
+
+         if (source == -1 || score > bestScore) {
+            shared.swap(lits);
+            source    = from[i]->id;
+            bestScore = score;
+         }
+      }
+   } else {
+      // Majority vote of the producers
+      unordered_map<int, int> votes;
+
+      for (size_t i = 0; i < from.size(); i++) {
+         from[i]->getPhases(lits, bestTrail);
+
+         if (lits.empty())
+            continue;
+
+         stats.receivedClauses++;
+
+         for (size_t k = 0; k < lits.size(); k++) {
+            votes[abs(lits[k])] += lits[k] > 0 ? 1 : -1;
+         }
+      }
+
+      for (auto it = votes.begin(); it != votes.end(); it++) {
+         if (it->second != 0) {
+            shared.push_back(it->second > 0 ? it->first : -it->first);
+         }
+      }
+   }
+
+   if (shared.empty())
+      return;
+
+   log(1, "Sharer %d shares %zu phases\n", idSharer, shared.size());
+
+   for (size_t j = 0; j < to.size(); j++) {
+      if (to[j]->id == source)
+         continue;
+
+      // Each consumer adopts a random part to keep the portfolio diverse
+      lits.clear();
+      for (size_t k = 0; k < shared.size(); k++) {
+         if (rand() % 100 < adoptRatio) {
+            lits.push_back(shared[k]);
+         }
+      }
+
+      to[j]->setPhases(lits);
+
+      stats.sharedClauses += lits.size();
+   }
+}
+
+SharingStatistics
+PhaseSharing::getStatistics()
+{
+   return stats;
+}
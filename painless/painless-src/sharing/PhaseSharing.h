@@ -0,0 +1,69 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "../sharing/SharingStrategy.h"
+#include "../solvers/SolverInterface.h"
+
+#include <unordered_map>
+#include <vector>
+
+/// This strategy shares phases between solvers: the producers publish their
+/// saved phases or their longest trail, the consumers adopt a part of them
+/// at their next restart. Statistics count the received snapshots and the
+/// adopted phases.
+class PhaseSharing : public SharingStrategy
+{
+public:
+   /// Constructor.
+   PhaseSharing();
+
+   /// Destructor.
+   ~PhaseSharing();
+
+   /// This method shared phases from the producers to the consumers.
+   void doSharing(int idSharer, const vector<SolverInterface *> & from,
+                  const vector<SolverInterface *> & to);
+
+   /// Return the sharing statistics of this sharng strategy.
+   SharingStatistics getStatistics();
+
+protected:
+   /// Number of rounds between two exchanges.
+   int period;
+
+   /// Share the longest trails instead of the saved phases.
+   bool bestTrail;
+
+   /// Adoption policy: 0 the best snapshot, 1 majority vote.
+   int policy;
+
+   /// Statistics of the producers at the last exchange.
+   unordered_map<int, SolvingStatistics> lastStats;
+
+   /// Percentage of the shared phases adopted by a consumer.
+   int adoptRatio;
+
+   /// Number of rounds since the creation.
+   int round;
+
+   /// Sharing statistics.
+   SharingStatistics stats;
+};
@@ -26,6 +26,14 @@
 #include <algorithm>
 #include <unistd.h>
 
+/// Remove a solver from a list of solvers.
+static void eraseSolver(vector<SolverInterface *> & solvers,
+                        SolverInterface * solver)
+{
+   solvers.erase(remove(solvers.begin(), solvers.end(), solver),
+                 solvers.end());
+}
+
 /// Function exectuted by each sharer.
 /// This is main of sharer threads.
 /// @param  arg contains a pointeur to the associated class
@@ -34,13 +42,11 @@ static void * mainThrSharing(void * arg)
 {
    Sharer * shr  = (Sharer *)arg;
    int round     = 0;
-   int sleepTime = Parameters::getIntParam("shr-sleep", 500000);
+   int sleepTime = shr->sleepTime;
 
    while (true) {
-      // Sleep 
-      usleep(sleepTime);
-   
-      if (globalEnding)
+      // Sleep, the end of the search wakes the sharer
+      if (waitGlobalEnding(sleepTime))
          break; // Need to stop
 
       round++; // New round
@@ -50,9 +56,25 @@ static void * mainThrSharing(void * arg)
           shr->id, round, stats.receivedClauses, stats.sharedClauses);
 
 
-      // Add new solvers
+      // Update the solvers, the removed ones first: a replaced solver does
+      // not share its clauses with its replacement
       // -------------------------
       shr->addLock.lock();
+      shr->removeLock.lock();
+
+      for (size_t i = 0; i < shr->removeProducers.size(); i++) {
+         eraseSolver(shr->producers, shr->removeProducers[i]);
+         eraseSolver(shr->addProducers, shr->removeProducers[i]);
+         shr->removeProducers[i]->release();
+      }
+      shr->removeProducers.clear();
+
+      for (size_t i = 0; i < shr->removeConsumers.size(); i++) {
+         eraseSolver(shr->consumers, shr->removeConsumers[i]);
+         eraseSolver(shr->addConsumers, shr->removeConsumers[i]);
+         shr->removeConsumers[i]->release();
+      }
+      shr->removeConsumers.clear();
 
       shr->producers.insert(shr->producers.end(), shr->addProducers.begin(),
                             shr->addProducers.end());
@@ -62,37 +84,13 @@ static void * mainThrSharing(void * arg)
                             shr->addConsumers.end());
       shr->addConsumers.clear();
 
+      shr->removeLock.unlock();
       shr->addLock.unlock();
 
 
       // Sharing phase
       shr->sharingStrategy->doSharing(shr->id, shr->producers, shr->consumers);
 
-      
-      // Remove solvers
-      // -------------------------
-      shr->removeLock.lock();
-
-      for (size_t i = 0; i < shr->removeProducers.size(); i++) {
-         shr->producers.erase(remove(shr->producers.begin(),
-                                     shr->producers.end(),
-                                     shr->removeProducers[i]),
-                              shr->producers.end());
-         shr->removeProducers[i]->release();
-      }
-      shr->removeProducers.clear();
-
-      for (size_t i = 0; i < shr->removeConsumers.size(); i++) {
-         shr->consumers.erase(remove(shr->consumers.begin(),
-                                     shr->consumers.end(),
-                                     shr->removeConsumers[i]),
-                              shr->consumers.end());
-         shr->removeConsumers[i]->release();
-      }
-      shr->removeConsumers.clear();
-
-      shr->removeLock.unlock();
-
 
       if (globalEnding)
          break; // Need to stop
@@ -103,10 +101,12 @@ static void * mainThrSharing(void * arg)
 
 Sharer::Sharer(int id, SharingStrategy * sharingStrategy,
                vector<SolverInterface *> producers,
-               vector<SolverInterface *> consumers)
+               vector<SolverInterface *> consumers, int sleepTime)
 {
    this->id              = id;
    this->sharingStrategy = sharingStrategy;
+   this->sleepTime       = sleepTime > 0 ? sleepTime :
+                           Parameters::getIntParam("shr-sleep", 500000);
    this->producers       = producers;
    this->consumers       = consumers;
 
@@ -126,17 +126,23 @@ Sharer::~Sharer()
    sharer->join();
    delete sharer;
 
-   removeLock.lock();
+   // Each solver holds one reference, the solvers waiting for their removal
+   // are still in these lists
+   for (size_t i = 0; i < producers.size(); i++) {
+      producers[i]->release();
+   }
 
-   for (int i = 0; i < removeProducers.size(); i++) {
-      removeProducers[i]->release();
+   for (size_t i = 0; i < addProducers.size(); i++) {
+      addProducers[i]->release();
    }
 
-   for (size_t i = 0; i < removeConsumers.size(); i++) {
-      removeConsumers[i]->release();
+   for (size_t i = 0; i < consumers.size(); i++) {
+      consumers[i]->release();
    }
 
-   removeLock.unlock();
+   for (size_t i = 0; i < addConsumers.size(); i++) {
+      addConsumers[i]->release();
+   }
 
    delete sharingStrategy;
 }
@@ -177,6 +183,37 @@ Sharer::removeConsumer(SolverInterface * solver)
    removeLock.unlock();
 }
 
+void
+Sharer::replaceSolver(SolverInterface * oldSolver, SolverInterface * solver)
+{
+   // The sharer thread changes the lists while holding these locks
+   addLock.lock();
+   removeLock.lock();
+
+   bool producer =
+      find(producers.begin(), producers.end(), oldSolver) != producers.end() ||
+      find(addProducers.begin(), addProducers.end(), oldSolver) !=
+         addProducers.end();
+
+   bool consumer =
+      find(consumers.begin(), consumers.end(), oldSolver) != consumers.end() ||
+      find(addConsumers.begin(), addConsumers.end(), oldSolver) !=
+         addConsumers.end();
+
+   removeLock.unlock();
+   addLock.unlock();
+
+   if (producer) {
+      addProducer(solver);
+      removeProducer(oldSolver);
+   }
+
+   if (consumer) {
+      addConsumer(solver);
+      removeConsumer(oldSolver);
+   }
+}
+
 void
 Sharer::printStats()
 {
@@ -30,10 +30,11 @@ static void * mainThrSharing(void * arg);
 class Sharer
 {
 public:
-   /// Constructor.
+   /// Constructor, the rounds are shr-sleep useconds apart unless a
+   /// sleepTime_ is given.
    Sharer(int id_, SharingStrategy * sharingStrategy_,
           vector<SolverInterface *> producers_,
-          vector<SolverInterface *> consumer_);
+          vector<SolverInterface *> consumer_, int sleepTime_ = 0);
 
    /// Destructor.
    ~Sharer();
@@ -50,6 +51,9 @@ public:
    /// Remove a solver from the consumers.
    void removeConsumer(SolverInterface * solver);
 
+   /// Replace a solver by another one in the producers and the consumers.
+   void replaceSolver(SolverInterface * oldSolver, SolverInterface * solver);
+
    /// Print sharing statistics.
    void printStats();
 
@@ -62,6 +66,9 @@ protected:
    /// Strategy used to shared clauses.
    SharingStrategy * sharingStrategy;
 
+   /// Time in useconds between two rounds.
+   int sleepTime;
+
    /// Mutex used to add producers and consumers.
    Mutex addLock;
 
@@ -0,0 +1,254 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#include "../clauses/ClauseManager.h"
+#include "../sharing/SharingTrace.h"
+#include "../utils/System.h"
+
+#include <string.h>
+
+using namespace std;
+
+/// Magic number at the beginning of a trace, with its version.
+#define TRACE_MAGIC   "PLST"
+#define TRACE_VERSION 1
+
+SharingTrace::SharingTrace()
+{
+   file     = NULL;
+   lastTime = 0;
+   nClauses = 0;
+   nBytes   = 0;
+}
+
+SharingTrace::~SharingTrace()
+{
+   close();
+}
+
+bool
+SharingTrace::open(const char * filename, bool write)
+{
+   file = fopen(filename, write ? "wb" : "rb");
+
+   if (file == NULL)
+      return false;
+
+   if (write) {
+      fwrite(TRACE_MAGIC, 1, 4, file);
+      writeVarint(TRACE_VERSION);
+      return true;
+   }
+
+   char magic[4];
+   uint32_t version;
+
+   if (fread(magic, 1, 4, file) != 4 || memcmp(magic, TRACE_MAGIC, 4) != 0 ||
+       readVarint(version) == false || version != TRACE_VERSION) {
+      fclose(file);
+      file = NULL;
+      return false;
+   }
+
+   return true;
+}
+
+void
+SharingTrace::close()
+{
+   traceLock.lock();
+
+   if (file != NULL) {
+      fclose(file);
+      file = NULL;
+   }
+
+   traceLock.unlock();
+}
+
+void
+SharingTrace::recordBatch(int sharer, int producer,
+                          const vector<ClauseExchange *> & clauses)
+{
+   if (clauses.empty())
+      return;
+
+   traceLock.lock();
+
+   if (file == NULL) {
+      traceLock.unlock();
+      return;
+   }
+
+   bytes.clear();
+   codec.encode(clauses, bytes);
+
+   writeHeader(TRACE_BATCH, sharer, producer);
+   writeVarint(bytes.size());
+   fwrite(bytes.data(), 1, bytes.size(), file);
+
+   nBytes   += bytes.size();
+   nClauses += clauses.size();
+
+   traceLock.unlock();
+}
+
+void
+SharingTrace::recordSelection(int sharer, int producer, int selected,
+                              int literals, int request)
+{
+   traceLock.lock();
+
+   if (file == NULL) {
+      traceLock.unlock();
+      return;
+   }
+
+   writeHeader(TRACE_SELECTION, sharer, producer);
+   writeVarint(selected);
+   writeVarint(literals);
+   writeVarint(request);
+
+   traceLock.unlock();
+}
+
+void
+SharingTrace::recordRound(int sharer)
+{
+   traceLock.lock();
+
+   if (file != NULL) {
+      writeHeader(TRACE_ROUND, sharer, -1);
+   }
+
+   traceLock.unlock();
+}
+
+bool
+SharingTrace::read(TraceRecord & record)
+{
+   uint32_t type, delta, sharer, producer;
+
+   if (readVarint(type) == false || readVarint(delta) == false ||
+       readVarint(sharer) == false || readVarint(producer) == false)
+      return false;
+
+   lastTime += delta;
+
+   record.type     = (TraceRecordType)type;
+   record.time     = lastTime;
+   record.sharer   = sharer;
+   record.producer = (int)producer - 1;
+   record.clauses.clear();
+
+   uint32_t size, selected, literals, request;
+
+   switch (type) {
+   case TRACE_BATCH:
+      if (readVarint(size) == false)
+         return false;
+
+      bytes.resize(size);
+
+      if (fread(bytes.data(), 1, size, file) != size ||
+          codec.decode(bytes.data(), size, record.clauses) == 0)
+         return false;
+
+      for (size_t i = 0; i < record.clauses.size(); i++) {
+         record.clauses[i]->from = record.producer;
+      }
+      return true;
+   case TRACE_SELECTION:
+      if (readVarint(selected) == false || readVarint(literals) == false ||
+          readVarint(request) == false)
+         return false;
+
+      record.selected = selected;
+      record.literals = literals;
+      record.request  = request;
+      return true;
+   case TRACE_ROUND:
+      return true;
+   default:
+      return false;
+   }
+}
+
+void
+SharingTrace::printStats()
+{
+   printf("c SharingTrace recorded cls %lu, %.2f bytes per clause\n", nClauses,
+          nClauses > 0 ? (double)nBytes / nClauses : 0.0);
+}
+
+void
+SharingTrace::writeHeader(TraceRecordType type, int sharer, int producer)
+{
+   // The time is taken under the lock, the deltas are never negative
+   unsigned long now = getRelativeTime() * 1000000;
+
+   if (now < lastTime)
+      now = lastTime;
+
+   writeVarint(type);
+   writeVarint(now - lastTime);
+   writeVarint(sharer);
+   writeVarint(producer + 1);
+
+   lastTime = now;
+}
+
+void
+SharingTrace::writeVarint(uint32_t value)
+{
+   uint8_t buf[5];
+   int n = 0;
+
+   while (value >= 0x80) {
+      buf[n++] = (value & 0x7f) | 0x80;
+      value >>= 7;
+   }
+
+   buf[n++] = value;
+
+   fwrite(buf, 1, n, file);
+
+   nBytes += n;
+}
+
+bool
+SharingTrace::readVarint(uint32_t & value)
+{
+   value = 0;
+
+   for (int shift = 0; shift < 35; shift += 7) {
+      int c = getc(file);
+
+      if (c == EOF)
+         return false;
+
+      value |= (uint32_t)(c & 0x7f) << shift;
+
+      if ((c & 0x80) == 0)
+         return true;
+   }
+
+   return false;
+}
@@ -0,0 +1,136 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "../clauses/ClauseCodec.h"
+#include "../clauses/ClauseExchange.h"
+#include "../utils/Threading.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <vector>
+
+using namespace std;
+
+/// Type of a record of the sharing trace.
+enum TraceRecordType
+{
+   TRACE_BATCH     = 1, ///< Clauses exported by a producer.
+   TRACE_SELECTION = 2, ///< Clauses a sharer kept from a producer.
+   TRACE_ROUND     = 3  ///< End of a round of a sharer.
+};
+
+/// Record of the sharing trace.
+struct TraceRecord
+{
+   /// Type of the record.
+   TraceRecordType type;
+
+   /// Time of the record in microseconds.
+   unsigned long time;
+
+   /// Id of the sharer.
+   int sharer;
+
+   /// Id of the producer, -1 for a round.
+   int producer;
+
+   /// Clauses of a batch, allocated with the ClauseManager.
+   vector<ClauseExchange *> clauses;
+
+   /// Number of clauses kept by a selection.
+   int selected;
+
+   /// Number of literals kept by a selection.
+   int literals;
+
+   /// Production request of a selection: 0 none, 1 increase, 2 decrease.
+   int request;
+};
+
+/// Binary trace of the exchanges of the sharers, to study the sharing
+/// offline. Each round of a sharer records the batch of clauses of every
+/// producer, with its LBD and its size, then what the strategy selected.
+/// The batches are coded with the ClauseCodec, the other fields are
+/// varints and the times are delta coded.
+class SharingTrace
+{
+public:
+   /// Constructor.
+   SharingTrace();
+
+   /// Destructor, close the file.
+   ~SharingTrace();
+
+   /// Open a trace to record it or to read it, return false if failed.
+   bool open(const char * filename, bool write);
+
+   /// Stop the recording and close the file, the next records are dropped.
+   void close();
+
+   /// Record the clauses exported by a producer.
+   void recordBatch(int sharer, int producer,
+                    const vector<ClauseExchange *> & clauses);
+
+   /// Record the selection of a sharer for a producer.
+   void recordSelection(int sharer, int producer, int selected, int literals,
+                        int request);
+
+   /// Record the end of a round of a sharer.
+   void recordRound(int sharer);
+
+   /// Read the next record, return false at the end of the trace.
+   bool read(TraceRecord & record);
+
+   /// Print the statistics of the recording.
+   void printStats();
+
+protected:
+   /// Write the header of a record, the lock must be held.
+   void writeHeader(TraceRecordType type, int sharer, int producer);
+
+   /// Write a varint.
+   void writeVarint(uint32_t value);
+
+   /// Read a varint, return false at the end of the file.
+   bool readVarint(uint32_t & value);
+
+   /// File of the trace.
+   FILE * file;
+
+   /// Time of the last record in microseconds.
+   unsigned long lastTime;
+
+   /// Codec of the batches.
+   ClauseCodec codec;
+
+   /// Bytes of a batch.
+   vector<uint8_t> bytes;
+
+   /// Number of recorded clauses.
+   unsigned long nClauses;
+
+   /// Number of written bytes.
+   unsigned long nBytes;
+
+   /// Protect the file, the sharers record concurrently.
+   Mutex traceLock;
+};
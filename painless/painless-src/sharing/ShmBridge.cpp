@@ -0,0 +1,223 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#include "../clauses/ClauseManager.h"
+#include "../painless.h"
+#include "../sharing/ShmBridge.h"
+
+using namespace std;
+
+ShmBridge::ShmBridge(int id, ProcessGroup * group) :
+   SolverInterface(id, REMOTE)
+{
+   this->group = group;
+
+   for (int i = 0; i < group->getCount(); i++) {
+      cursors.push_back(group->getRing(i)->end());
+   }
+
+   nSent         = 0;
+   nReceived     = 0;
+   nLost         = 0;
+   unitLogCursor = 0;
+}
+
+ShmBridge::~ShmBridge()
+{
+}
+
+void
+ShmBridge::printStats()
+{
+   printf("c ShmBridge process %d/%d sent cls %lu, received cls %lu, lost "
+          "ints %lu\n", group->getIndex(), group->getCount(),
+          (unsigned long)nSent, (unsigned long)nReceived,
+          (unsigned long)nLost);
+}
+
+bool
+ShmBridge::loadFormula(const char* filename)
+{
+   return false;
+}
+
+int
+ShmBridge::getVariablesCount()
+{
+   return 0;
+}
+
+int
+ShmBridge::getDivisionVariable()
+{
+   return 0;
+}
+
+void
+ShmBridge::setPhase(const int var, const bool phase)
+{
+}
+
+void
+ShmBridge::bumpVariableActivity(const int var, const int times)
+{
+}
+
+void
+ShmBridge::setSolverInterrupt()
+{
+}
+
+void
+ShmBridge::unsetSolverInterrupt()
+{
+}
+
+SatResult
+ShmBridge::solve(const vector<int> & cube)
+{
+   return UNKNOWN;
+}
+
+void
+ShmBridge::addClause(ClauseExchange * clause)
+{
+   ClauseManager::releaseClause(clause);
+}
+
+void
+ShmBridge::addClauses(const vector<ClauseExchange *> & clauses)
+{
+   for (size_t i = 0; i < clauses.size(); i++) {
+      ClauseManager::releaseClause(clauses[i]);
+   }
+}
+
+void
+ShmBridge::addInitialClauses(const vector<ClauseExchange *> & clauses)
+{
+}
+
+void
+ShmBridge::addLearnedClause(ClauseExchange * clause)
+{
+   addLearnedClauses(vector<ClauseExchange *>(1, clause));
+}
+
+void
+ShmBridge::addLearnedClauses(const vector<ClauseExchange *> & clauses)
+{
+   writeLock.lock();
+   group->getRing(group->getIndex())->write(clauses);
+   writeLock.unlock();
+
+   nSent += clauses.size();
+
+   for (size_t i = 0; i < clauses.size(); i++) {
+      ClauseManager::releaseClause(clauses[i]);
+   }
+}
+
+void
+ShmBridge::getLearnedClauses(vector<ClauseExchange *> & clauses)
+{
+   // The units and binaries of the local solvers only go through the log,
+   // they are sent on the period of the reads
+   if (unitLog != NULL) {
+      vector<ClauseExchange *> logged;
+
+      writeLock.lock();
+
+      unitLog->readClauses(unitLogCursor, id, logged);
+
+      if (logged.empty() == false) {
+         group->getRing(group->getIndex())->write(logged);
+      }
+
+      writeLock.unlock();
+
+      nSent += logged.size();
+
+      for (size_t i = 0; i < logged.size(); i++) {
+         ClauseManager::releaseClause(logged[i]);
+      }
+   }
+
+   size_t first = clauses.size();
+
+   readLock.lock();
+
+   for (int i = 0; i < group->getCount(); i++) {
+      if (i != group->getIndex()) {
+         nLost += group->getRing(i)->read(cursors[i], clauses);
+      }
+   }
+
+   readLock.unlock();
+
+   for (size_t i = first; i < clauses.size(); i++) {
+      clauses[i]->from = id;
+   }
+
+   nReceived += clauses.size() - first;
+}
+
+void
+ShmBridge::increaseClauseProduction()
+{
+}
+
+void
+ShmBridge::decreaseClauseProduction()
+{
+}
+
+SolvingStatistics
+ShmBridge::getStatistics()
+{
+   SolvingStatistics stats;
+
+   stats.exported = nReceived;
+
+   return stats;
+}
+
+vector<int>
+ShmBridge::getModel()
+{
+   return vector<int>();
+}
+
+void
+ShmBridge::diversify(int id)
+{
+}
+
+vector<int>
+ShmBridge::getFinalAnalysis()
+{
+   return vector<int>();
+}
+
+vector<int>
+ShmBridge::getSatAssumptions()
+{
+   return vector<int>();
+}
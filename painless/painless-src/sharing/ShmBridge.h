@@ -0,0 +1,137 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "../solvers/SolverInterface.h"
+#include "../utils/Threading.h"
+#include "../working/ProcessGroup.h"
+
+#include <stdint.h>
+#include <vector>
+
+using namespace std;
+
+/// Bridge between the local sharers and the other processes of a process
+/// group, the sharers see it as a solver. The clauses it consumes are written
+/// at once in the ring of the process, in the round of the sharer selecting
+/// them. The clauses it produces are read from the rings of the others by a
+/// sharer of its own, every shm-period useconds: a clause waits for one round
+/// of the sharers of its process, plus at most this period.
+class ShmBridge : public SolverInterface
+{
+public:
+   /// Load formula from a given dimacs file, return false if failed.
+   bool loadFormula(const char* filename);
+
+   /// Get the number of variables of the current resolution.
+   int getVariablesCount();
+
+   /// Get a variable suitable for search splitting.
+   int getDivisionVariable();
+
+   /// Set initial phase for a given variable.
+   void setPhase(const int var, const bool phase);
+
+   /// Bump activity of a given variable.
+   void bumpVariableActivity(const int var, const int times);
+
+   /// Interrupt resolution, solving cannot continue until interrupt is unset.
+   void setSolverInterrupt();
+
+   /// Remove the SAT solving interrupt request.
+   void unsetSolverInterrupt();
+
+   /// The bridge does not solve, return UNKNOWN.
+   SatResult solve(const vector<int> & cube);
+
+   /// Add a permanent clause to the formula.
+   void addClause(ClauseExchange * clause);
+
+   /// Add a list of permanent clauses to the formula.
+   void addClauses(const vector<ClauseExchange *> & clauses);
+
+   /// Add a list of initial clauses to the formula.
+   void addInitialClauses(const vector<ClauseExchange *> & clauses);
+
+   /// Add a clause to send to the other processes.
+   void addLearnedClause(ClauseExchange * clause);
+
+   /// Add a list of clauses to send to the other processes.
+   void addLearnedClauses(const vector<ClauseExchange *> & clauses);
+
+   /// Get the clauses received from the other processes, and send the units
+   /// and binaries of the unit log.
+   void getLearnedClauses(vector<ClauseExchange *> & clauses);
+
+   /// Request the solver to produce more clauses.
+   void increaseClauseProduction();
+
+   /// Request the solver to produce less clauses.
+   void decreaseClauseProduction();
+
+   /// Get the statistics, the exported clauses are the received ones.
+   SolvingStatistics getStatistics();
+
+   /// Return the model in case of SAT result.
+   vector<int> getModel();
+
+   /// Native diversification.
+   void diversify(int id);
+
+   /// Return the final analysis in case of UNSAT result.
+   vector<int> getFinalAnalysis();
+
+   vector<int> getSatAssumptions();
+
+   /// Print the statistics of the exchanges.
+   void printStats();
+
+   /// Constructor.
+   ShmBridge(int id, ProcessGroup * group);
+
+   /// Destructor.
+   virtual ~ShmBridge();
+
+protected:
+   /// Group of the process.
+   ProcessGroup * group;
+
+   /// Position of the process in the rings of the others.
+   vector<uint64_t> cursors;
+
+   /// Protect the ring of the process.
+   Mutex writeLock;
+
+   /// Protect the cursors.
+   Mutex readLock;
+
+   /// Number of sent clauses.
+   atomic<unsigned long> nSent;
+
+   /// Number of received clauses.
+   atomic<unsigned long> nReceived;
+
+   /// Number of ints lost because a ring has been overwritten.
+   atomic<unsigned long> nLost;
+
+   /// Position of the bridge in the unit log, protected by writeLock.
+   size_t unitLogCursor;
+};
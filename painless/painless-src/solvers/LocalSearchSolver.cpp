@@ -0,0 +1,595 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#include "../painless.h"
+#include "../clauses/ClauseManager.h"
+#include "../solvers/LocalSearchSolver.h"
+#include "../utils/Parameters.h"
+#include "../utils/SatUtils.h"
+#include "../utils/System.h"
+
+#include <algorithm>
+#include <math.h>
+#include <stdlib.h>
+
+using namespace std;
+
+// Break counts with their own probability, the higher ones share the last
+#define MAX_BREAK 64
+
+LocalSearchSolver::LocalSearchSolver(int id) : SolverInterface(id, LOCAL_SEARCH)
+{
+   nVars         = 0;
+   dirty         = false;
+   bestUnsat     = 0;
+   unitLogCursor = 0;
+   seed          = id;
+   period        = Parameters::getIntParam("ls-flips", 1000000);
+   nFlips        = 0;
+   nAdoptions    = 0;
+   stopSolver    = false;
+
+   clauseStart.push_back(0);
+
+   diversify(0);
+}
+
+LocalSearchSolver::~LocalSearchSolver()
+{
+}
+
+bool
+LocalSearchSolver::loadFormula(const char* filename)
+{
+   vector<ClauseExchange *> clauses;
+
+   if (parseFormula(filename, clauses) == false)
+      return false;
+
+   addInitialClauses(clauses);
+
+   for (size_t i = 0; i < clauses.size(); i++) {
+      ClauseManager::releaseClause(clauses[i]);
+   }
+
+   return true;
+}
+
+int
+LocalSearchSolver::getVariablesCount()
+{
+   return nVars;
+}
+
+int
+LocalSearchSolver::getDivisionVariable()
+{
+   return (rand() % getVariablesCount()) + 1;
+}
+
+void
+LocalSearchSolver::setPhase(const int var, const bool phase)
+{
+   phaseLock.lock();
+   pendingPhases.push_back(phase ? var : -var);
+   phaseLock.unlock();
+}
+
+void
+LocalSearchSolver::setPhases(const vector<int> & lits)
+{
+   phaseLock.lock();
+
+   // Only the most recent phases matter
+   if (pendingPhases.size() > 2 * (size_t)nVars) {
+      pendingPhases.clear();
+   }
+
+   pendingPhases.insert(pendingPhases.end(), lits.begin(), lits.end());
+
+   phaseLock.unlock();
+}
+
+void
+LocalSearchSolver::bumpVariableActivity(const int var, const int times)
+{
+}
+
+void
+LocalSearchSolver::setSolverInterrupt()
+{
+   stopSolver = true;
+}
+
+void
+LocalSearchSolver::unsetSolverInterrupt()
+{
+   stopSolver = false;
+}
+
+void
+LocalSearchSolver::diversify(int id)
+{
+   seed = id + 1;
+
+   // Exponents of probSAT for 3-SAT, 4-SAT and 5-SAT, and a greedier one
+   static const double cbs[] = {2.06, 3.0, 3.7, 2.5};
+   cb = cbs[id % 4];
+
+   probs.resize(MAX_BREAK + 1);
+   for (int b = 0; b <= MAX_BREAK; b++) {
+      probs[b] = pow(1.0 + b, -cb);
+   }
+
+   for (int var = 1; var <= nVars; var++) {
+      if (fixed[var] == 0)
+         value[var] = rand_r(&seed) & 1;
+   }
+}
+
+void
+LocalSearchSolver::pushClause(const int * lits, int size)
+{
+   vector<int> cls(lits, lits + size);
+
+   sort(cls.begin(), cls.end(), [](int a, int b) { return abs(a) < abs(b); });
+
+   int j = 0;
+   for (int i = 0; i < size; i++) {
+      if (j > 0 && abs(cls[j - 1]) == abs(cls[i])) {
+         // A tautology is always satisfied
+         if (cls[j - 1] != cls[i])
+            return;
+         continue;
+      }
+      cls[j++] = cls[i];
+   }
+
+   for (int i = 0; i < j; i++) {
+      clauseLits.push_back(cls[i]);
+      nVars = max(nVars, abs(cls[i]));
+   }
+
+   clauseStart.push_back(clauseLits.size());
+
+   dirty = true;
+}
+
+void
+LocalSearchSolver::buildOccurrences()
+{
+   int nClauses = clauseStart.size() - 1;
+   int oldVars  = value.size() > 0 ? value.size() - 1 : 0;
+
+   value.resize(nVars + 1, 0);
+   fixed.resize(nVars + 1, 0);
+   best.resize(nVars + 1, 0);
+   inSinceBest.resize(nVars + 1, 0);
+
+   for (int var = oldVars + 1; var <= nVars; var++) {
+      value[var] = rand_r(&seed) & 1;
+   }
+
+   // Counting sort of the clauses by literal
+   occStart.assign(2 * nVars + 3, 0);
+
+   for (size_t i = 0; i < clauseLits.size(); i++) {
+      occStart[litIndex(clauseLits[i]) + 1]++;
+   }
+
+   for (size_t i = 1; i < occStart.size(); i++) {
+      occStart[i] += occStart[i - 1];
+   }
+
+   occurrences.resize(clauseLits.size());
+
+   vector<int> pos(occStart.begin(), occStart.end() - 1);
+
+   for (int c = 0; c < nClauses; c++) {
+      for (int i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+         occurrences[pos[litIndex(clauseLits[i])]++] = c;
+      }
+
+      // The unit clauses of the formula fix their variable
+      if (clauseStart[c + 1] - clauseStart[c] == 1) {
+         int lit = clauseLits[clauseStart[c]];
+
+         value[abs(lit)] = lit > 0;
+         fixed[abs(lit)] = 1;
+      }
+   }
+
+   dirty = false;
+}
+
+void
+LocalSearchSolver::initCounters()
+{
+   int nClauses = clauseStart.size() - 1;
+
+   numTrue.assign(nClauses, 0);
+   trueXor.assign(nClauses, 0);
+   unsatPos.assign(nClauses, -1);
+   breaks.assign(nVars + 1, 0);
+   unsat.clear();
+
+   for (int c = 0; c < nClauses; c++) {
+      for (int i = clauseStart[c]; i < clauseStart[c + 1]; i++) {
+         if (isTrue(clauseLits[i])) {
+            numTrue[c]++;
+            trueXor[c] ^= abs(clauseLits[i]);
+         }
+      }
+
+      if (numTrue[c] == 0) {
+         unsatPos[c] = unsat.size();
+         unsat.push_back(c);
+      } else if (numTrue[c] == 1) {
+         breaks[trueXor[c]]++;
+      }
+   }
+}
+
+void
+LocalSearchSolver::flip(int var)
+{
+   value[var] = !value[var];
+
+   int trueLit = value[var] ? var : -var;
+
+   // Clauses where the variable becomes true
+   int tl = litIndex(trueLit);
+   for (int i = occStart[tl]; i < occStart[tl + 1]; i++) {
+      int c = occurrences[i];
+
+      trueXor[c] ^= var;
+
+      if (++numTrue[c] == 1) {
+         int last           = unsat.back();
+         unsat[unsatPos[c]] = last;
+         unsatPos[last]     = unsatPos[c];
+         unsatPos[c]        = -1;
+         unsat.pop_back();
+
+         breaks[var]++;
+      } else if (numTrue[c] == 2) {
+         breaks[trueXor[c] ^ var]--;
+      }
+   }
+
+   // Clauses where the variable becomes false
+   int fl = litIndex(-trueLit);
+   for (int i = occStart[fl]; i < occStart[fl + 1]; i++) {
+      int c = occurrences[i];
+
+      trueXor[c] ^= var;
+
+      if (--numTrue[c] == 0) {
+         unsatPos[c] = unsat.size();
+         unsat.push_back(c);
+
+         breaks[var]--;
+      } else if (numTrue[c] == 1) {
+         breaks[trueXor[c]]++;
+      }
+   }
+
+   if (inSinceBest[var] == 0) {
+      inSinceBest[var] = 1;
+      sinceBest.push_back(var);
+   }
+
+   nFlips++;
+}
+
+int
+LocalSearchSolver::pickVariable(int cls)
+{
+   int size   = clauseStart[cls + 1] - clauseStart[cls];
+   double sum = 0;
+
+   scores.resize(size);
+
+   for (int i = 0; i < size; i++) {
+      int var = abs(clauseLits[clauseStart[cls] + i]);
+
+      scores[i] = fixed[var] ? 0 : probs[min(breaks[var], MAX_BREAK)];
+      sum      += scores[i];
+   }
+
+   // All the variables of the clause are fixed
+   if (sum == 0)
+      return 0;
+
+   double r = rand_r(&seed) / (RAND_MAX + 1.0) * sum;
+
+   for (int i = 0; i < size; i++) {
+      r -= scores[i];
+
+      if (r < 0 && scores[i] > 0)
+         return abs(clauseLits[clauseStart[cls] + i]);
+   }
+
+   for (int i = size - 1; i >= 0; i--) {
+      if (scores[i] > 0)
+         return abs(clauseLits[clauseStart[cls] + i]);
+   }
+
+   return 0;
+}
+
+void
+LocalSearchSolver::adoptPhases()
+{
+   vector<int> lits;
+
+   phaseLock.lock();
+   lits.swap(pendingPhases);
+   phaseLock.unlock();
+
+   if (lits.empty())
+      return;
+
+   for (size_t i = 0; i < lits.size(); i++) {
+      int var = abs(lits[i]);
+
+      if (var <= nVars && fixed[var] == 0) {
+         value[var] = lits[i] > 0;
+      }
+   }
+
+   initCounters();
+
+   nAdoptions++;
+}
+
+void
+LocalSearchSolver::importUnits()
+{
+   ClauseExchange * cls = NULL;
+
+   while (unitsToImport.getClause(&cls)) {
+      logUnits.push_back(cls->lits[0]);
+      ClauseManager::releaseClause(cls);
+   }
+
+   if (unitLog != NULL) {
+      unitLog->read(unitLogCursor, id, logUnits, logBinaries);
+      logBinaries.clear();
+   }
+
+   for (size_t i = 0; i < logUnits.size(); i++) {
+      int lit = logUnits[i];
+      int var = abs(lit);
+
+      // The cube has the priority, it is only fixed during this solve
+      if (var > nVars || fixed[var] == 2)
+         continue;
+
+      if (isTrue(lit) == false) {
+         flip(var);
+      }
+
+      fixed[var] = 1;
+   }
+
+   logUnits.clear();
+}
+
+void
+LocalSearchSolver::saveBest()
+{
+   for (size_t i = 0; i < sinceBest.size(); i++) {
+      best[sinceBest[i]]        = value[sinceBest[i]];
+      inSinceBest[sinceBest[i]] = 0;
+   }
+
+   sinceBest.clear();
+
+   bestUnsat = unsat.size();
+}
+
+void
+LocalSearchSolver::publishBest()
+{
+   vector<int> lits;
+
+   for (int var = 1; var <= nVars; var++) {
+      lits.push_back(best[var] ? var : -var);
+   }
+
+   phaseLock.lock();
+   publishedPhases.swap(lits);
+   phaseLock.unlock();
+}
+
+SatResult
+LocalSearchSolver::solve(const vector<int> & cube)
+{
+   unsetSolverInterrupt();
+
+   vector<ClauseExchange *> tmp;
+   clausesToAdd.getClauses(tmp);
+
+   for (size_t i = 0; i < tmp.size(); i++) {
+      pushClause(tmp[i]->lits, tmp[i]->size);
+      ClauseManager::releaseClause(tmp[i]);
+   }
+
+   if (dirty) {
+      buildOccurrences();
+   }
+
+   // The cube of the previous solve is released
+   for (int var = 1; var <= nVars; var++) {
+      if (fixed[var] == 2)
+         fixed[var] = 0;
+   }
+
+   for (size_t i = 0; i < cube.size(); i++) {
+      int var = abs(cube[i]);
+
+      if (var <= nVars) {
+         value[var] = cube[i] > 0;
+         fixed[var] = 2;
+      }
+   }
+
+   initCounters();
+
+   while (true) {
+      // Each period starts from the phases of the other solvers, if any
+      adoptPhases();
+
+      sinceBest.clear();
+      fill(inSinceBest.begin(), inSinceBest.end(), 0);
+      best      = value;
+      bestUnsat = unsat.size();
+
+      for (unsigned long k = 0; k < period; k++) {
+         if (unsat.empty()) {
+            model.clear();
+            for (int var = 1; var <= nVars; var++) {
+               model.push_back(value[var] ? var : -var);
+            }
+            return SAT;
+         }
+
+         if ((k & 1023) == 0) {
+            if (stopSolver) {
+               publishBest();
+               return UNKNOWN;
+            }
+
+            importUnits();
+         }
+
+         int var = pickVariable(unsat[rand_r(&seed) % unsat.size()]);
+
+         if (var != 0) {
+            flip(var);
+
+            if ((int)unsat.size() < bestUnsat) {
+               saveBest();
+            }
+         }
+      }
+
+      publishBest();
+   }
+}
+
+void
+LocalSearchSolver::addClause(ClauseExchange * clause)
+{
+   clausesToAdd.addClause(clause);
+
+   setSolverInterrupt();
+}
+
+void
+LocalSearchSolver::addClauses(const vector<ClauseExchange *> & clauses)
+{
+   clausesToAdd.addClauses(clauses);
+
+   setSolverInterrupt();
+}
+
+void
+LocalSearchSolver::addInitialClauses(const vector<ClauseExchange *> & clauses)
+{
+   for (size_t i = 0; i < clauses.size(); i++) {
+      pushClause(clauses[i]->lits, clauses[i]->size);
+   }
+
+   buildOccurrences();
+}
+
+void
+LocalSearchSolver::addLearnedClause(ClauseExchange * clause)
+{
+   if (clause->size == 1) {
+      unitsToImport.addClause(clause);
+   } else {
+      ClauseManager::releaseClause(clause);
+   }
+}
+
+void
+LocalSearchSolver::addLearnedClauses(const vector<ClauseExchange *> & clauses)
+{
+   for (size_t i = 0; i < clauses.size(); i++) {
+      addLearnedClause(clauses[i]);
+   }
+}
+
+void
+LocalSearchSolver::getLearnedClauses(vector<ClauseExchange *> & clauses)
+{
+}
+
+void
+LocalSearchSolver::increaseClauseProduction()
+{
+}
+
+void
+LocalSearchSolver::decreaseClauseProduction()
+{
+}
+
+SolvingStatistics
+LocalSearchSolver::getStatistics()
+{
+   SolvingStatistics stats;
+
+   stats.decisions = nFlips;
+   stats.restarts  = nAdoptions;
+   stats.memPeak   = getMemoryUsed();
+
+   return stats;
+}
+
+vector<int>
+LocalSearchSolver::getModel()
+{
+   return model;
+}
+
+vector<int>
+LocalSearchSolver::getFinalAnalysis()
+{
+   vector<int> outCls;
+   return outCls;
+}
+
+vector<int>
+LocalSearchSolver::getSatAssumptions()
+{
+   vector<int> outCls;
+   return outCls;
+}
+
+void
+LocalSearchSolver::getPhases(vector<int> & lits, bool bestTrail)
+{
+   phaseLock.lock();
+   lits = publishedPhases;
+   phaseLock.unlock();
+}
@@ -0,0 +1,253 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "../clauses/ClauseBuffer.h"
+#include "../solvers/SolverInterface.h"
+#include "../utils/Threading.h"
+
+#include <vector>
+
+using namespace std;
+
+/// Stochastic local search solver in the style of probSAT. It can only
+/// answer SAT: the solve returns UNKNOWN when interrupted. The phases given
+/// with setPhase are adopted periodically, the best assignment of each period
+/// is published through getPhases. Imported units fix their variables.
+class LocalSearchSolver : public SolverInterface
+{
+public:
+   /// Load formula from a given dimacs file, return false if failed.
+   bool loadFormula(const char* filename);
+
+   /// Get the number of variables of the current resolution.
+   int getVariablesCount();
+
+   /// Get a variable suitable for search splitting.
+   int getDivisionVariable();
+
+   /// Set initial phase for a given variable.
+   void setPhase(const int var, const bool phase);
+
+   /// Set the phases of the variables of a list of literals.
+   void setPhases(const vector<int> & lits);
+
+   /// Bump activity of a given variable.
+   void bumpVariableActivity(const int var, const int times);
+
+   /// Interrupt resolution, solving cannot continue until interrupt is unset.
+   void setSolverInterrupt();
+
+   /// Remove the SAT solving interrupt request.
+   void unsetSolverInterrupt();
+
+   /// Solve the formula with a given cube.
+   SatResult solve(const vector<int> & cube);
+
+   /// Add a permanent clause to the formula.
+   void addClause(ClauseExchange * clause);
+
+   /// Add a list of permanent clauses to the formula.
+   void addClauses(const vector<ClauseExchange *> & clauses);
+
+   /// Add a list of initial clauses to the formula.
+   void addInitialClauses(const vector<ClauseExchange *> & clauses);
+
+   /// Add a learned clause to the formula, only units are used.
+   void addLearnedClause(ClauseExchange * clause);
+
+   /// Add a list of learned clauses to the formula.
+   void addLearnedClauses(const vector<ClauseExchange *> & clauses);
+
+   /// Get a list of learned clauses.
+   void getLearnedClauses(vector<ClauseExchange *> & clauses);
+
+   /// Request the solver to produce more clauses.
+   void increaseClauseProduction();
+
+   /// Request the solver to produce less clauses.
+   void decreaseClauseProduction();
+
+   /// Get solver statistics.
+   SolvingStatistics getStatistics();
+
+   /// Return the model in case of SAT result.
+   vector<int> getModel();
+
+   /// Native diversification.
+   void diversify(int id);
+
+   /// Return the final analysis in case of UNSAT result.
+   vector<int> getFinalAnalysis();
+
+   vector<int> getSatAssumptions();
+
+   /// Get the best assignment of the last period as literals.
+   void getPhases(vector<int> & lits, bool bestTrail);
+
+   /// Constructor.
+   LocalSearchSolver(int id);
+
+   /// Destructor.
+   virtual ~LocalSearchSolver();
+
+protected:
+   /// Add a clause to the formula, tautologies are dropped.
+   void pushClause(const int * lits, int size);
+
+   /// Build the occurrence lists of the literals.
+   void buildOccurrences();
+
+   /// Compute the true literals, the break counts and the unsat list.
+   void initCounters();
+
+   /// Flip the value of a variable, update the counters incrementally.
+   void flip(int var);
+
+   /// Pick the variable to flip in an unsatisfied clause, 0 if none.
+   int pickVariable(int cls);
+
+   /// Adopt the pending phases.
+   void adoptPhases();
+
+   /// Fix the variables of the imported units.
+   void importUnits();
+
+   /// Record the best assignment reached since the last period.
+   void saveBest();
+
+   /// Publish the best assignment for getPhases.
+   void publishBest();
+
+   /// Index of a literal in the occurrence lists.
+   inline int litIndex(int lit)
+   {
+      return lit > 0 ? 2 * lit : -2 * lit + 1;
+   }
+
+   /// Return true if the literal is true in the current assignment.
+   inline bool isTrue(int lit)
+   {
+      return value[abs(lit)] == (lit > 0);
+   }
+
+   /// Number of variables.
+   int nVars;
+
+   /// Literals of the clauses, stored one after the other.
+   vector<int> clauseLits;
+
+   /// Position of each clause in clauseLits, the last one is the end.
+   vector<int> clauseStart;
+
+   /// Clauses of each literal, stored one after the other.
+   vector<int> occurrences;
+
+   /// Position of each literal in occurrences, the last one is the end.
+   vector<int> occStart;
+
+   /// True if clauses have been added since the occurrence lists were built.
+   bool dirty;
+
+   /// Current value of each variable.
+   vector<char> value;
+
+   /// Fixed variables: 1 by an imported unit, 2 by the cube.
+   vector<char> fixed;
+
+   /// Number of true literals of each clause.
+   vector<int> numTrue;
+
+   /// Xor of the variables of the true literals of each clause, it is the
+   /// critical variable when there is only one true literal.
+   vector<int> trueXor;
+
+   /// Number of clauses that become false when flipping each variable.
+   vector<int> breaks;
+
+   /// Unsatisfied clauses.
+   vector<int> unsat;
+
+   /// Position of each clause in unsat, -1 if satisfied.
+   vector<int> unsatPos;
+
+   /// Probability weight of a variable given its break count.
+   vector<double> probs;
+
+   /// Scores of the variables of the clause being repaired.
+   vector<double> scores;
+
+   /// Best assignment since the last period.
+   vector<char> best;
+
+   /// Number of unsatisfied clauses of the best assignment.
+   int bestUnsat;
+
+   /// Variables flipped since the best assignment was saved.
+   vector<int> sinceBest;
+
+   /// Mark of the variables in sinceBest.
+   vector<char> inSinceBest;
+
+   /// Phases given by the other solvers, not adopted yet.
+   vector<int> pendingPhases;
+
+   /// Best assignment published for the other solvers.
+   vector<int> publishedPhases;
+
+   /// Protect the pending and the published phases.
+   Mutex phaseLock;
+
+   /// Buffer used to import the units.
+   ClauseBuffer unitsToImport;
+
+   /// Buffer used to add permanent clauses.
+   ClauseBuffer clausesToAdd;
+
+   /// Position of the solver in the unit log.
+   size_t unitLogCursor;
+
+   /// Units read from the unit log, not yet imported.
+   vector<int> logUnits;
+
+   /// Binaries read from the unit log, they are not used.
+   vector<pair<int, int> > logBinaries;
+
+   /// Exponent of the polynomial break function.
+   double cb;
+
+   /// Seed of the random generator.
+   unsigned int seed;
+
+   /// Number of flips between two adoptions of the shared phases.
+   unsigned long period;
+
+   /// Number of flips.
+   unsigned long nFlips;
+
+   /// Number of adoptions of the shared phases.
+   unsigned long nAdoptions;
+
+   /// Model found by the last solve.
+   vector<int> model;
+
+   /// Used to stop or continue the resolution.
+   atomic<bool> stopSolver;
+};
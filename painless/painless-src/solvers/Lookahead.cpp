@@ -0,0 +1,357 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#include "../solvers/Lookahead.h"
+
+#include <algorithm>
+#include <math.h>
+
+using namespace std;
+
+Lookahead::Lookahead(int nCandidates_)
+{
+   nVars       = 0;
+   ok          = true;
+   nCandidates = nCandidates_ > 0 ? nCandidates_ : 1;
+   qhead       = 0;
+   stamp       = 0;
+   nFailed     = 0;
+   nProbes     = 0;
+
+   // A new binary clause weights 1, each extra literal divides it by 5
+   for (int size = 0; size < 16; size++) {
+      weights.push_back(size < 2 ? 0 : pow(5.0, 2 - size));
+   }
+}
+
+bool
+Lookahead::addClauses(const vector<ClauseExchange *> & cls)
+{
+   for (size_t i = 0; i < cls.size(); i++) {
+      for (int j = 0; j < cls[i]->size; j++) {
+         nVars = max(nVars, abs(cls[i]->lits[j]));
+      }
+   }
+
+   values.resize(nVars + 1, 0);
+   watches.resize(2 * nVars + 2);
+   occurs.resize(2 * nVars + 2);
+
+   for (size_t i = 0; i < cls.size() && ok; i++) {
+      vector<int> lits(cls[i]->lits, cls[i]->lits + cls[i]->size);
+
+      sort(lits.begin(), lits.end());
+      lits.erase(unique(lits.begin(), lits.end()), lits.end());
+
+      bool tautology = false;
+      for (size_t j = 0; j < lits.size(); j++) {
+         if (binary_search(lits.begin(), lits.end(), -lits[j]))
+            tautology = true;
+      }
+
+      if (tautology)
+         continue;
+
+      if (lits.empty()) {
+         ok = false;
+      } else if (lits.size() == 1) {
+         if (value(lits[0]) == -1) {
+            ok = false;
+         } else if (value(lits[0]) == 0) {
+            enqueue(lits[0]);
+         }
+      } else {
+         int id = clauses.size();
+
+         watches[litIndex(lits[0])].push_back(id);
+         watches[litIndex(lits[1])].push_back(id);
+
+         for (size_t j = 0; j < lits.size(); j++) {
+            occurs[litIndex(lits[j])].push_back(id);
+         }
+
+         clauses.push_back(lits);
+      }
+   }
+
+   stamps.resize(clauses.size(), 0);
+
+   if (ok)
+      ok = propagate();
+
+   return ok;
+}
+
+int
+Lookahead::getVariablesCount()
+{
+   return nVars;
+}
+
+void
+Lookahead::enqueue(int lit)
+{
+   values[abs(lit)] = lit > 0 ? 1 : -1;
+   trail.push_back(lit);
+}
+
+bool
+Lookahead::propagate()
+{
+   while (qhead < trail.size()) {
+      int falseLit       = -trail[qhead++];
+      vector<int> & ws   = watches[litIndex(falseLit)];
+      size_t i = 0, j = 0;
+
+      while (i < ws.size()) {
+         int id            = ws[i++];
+         vector<int> & cls = clauses[id];
+
+         if (cls[0] == falseLit)
+            swap(cls[0], cls[1]);
+
+         if (value(cls[0]) == 1) {
+            ws[j++] = id;
+            continue;
+         }
+
+         // Look for a new literal to watch
+         bool found = false;
+         for (size_t k = 2; k < cls.size(); k++) {
+            if (value(cls[k]) != -1) {
+               swap(cls[1], cls[k]);
+               watches[litIndex(cls[1])].push_back(id);
+               found = true;
+               break;
+            }
+         }
+
+         if (found)
+            continue;
+
+         ws[j++] = id;
+
+         if (value(cls[0]) == -1) {
+            // Conflict
+            while (i < ws.size()) {
+               ws[j++] = ws[i++];
+            }
+            ws.resize(j);
+            qhead = trail.size();
+            return false;
+         }
+
+         enqueue(cls[0]);
+      }
+
+      ws.resize(j);
+   }
+
+   return true;
+}
+
+void
+Lookahead::newLevel()
+{
+   trailLim.push_back(trail.size());
+}
+
+void
+Lookahead::backtrack(size_t level)
+{
+   if (trailLim.size() <= level)
+      return;
+
+   size_t pos = trailLim[level];
+
+   while (trail.size() > pos) {
+      values[abs(trail.back())] = 0;
+      trail.pop_back();
+   }
+
+   trailLim.resize(level);
+   qhead = trail.size();
+}
+
+bool
+Lookahead::assume(const vector<int> & cube)
+{
+   backtrack(0);
+
+   if (ok == false)
+      return false;
+
+   newLevel();
+
+   for (size_t i = 0; i < cube.size(); i++) {
+      int val = value(cube[i]);
+
+      if (val == -1)
+         return false;
+
+      if (val == 0)
+         enqueue(cube[i]);
+   }
+
+   return propagate();
+}
+
+double
+Lookahead::reduction(size_t from)
+{
+   double score = 0;
+
+   stamp++;
+
+   for (size_t i = from; i < trail.size(); i++) {
+      const vector<int> & occ = occurs[litIndex(-trail[i])];
+
+      for (size_t j = 0; j < occ.size(); j++) {
+         int id = occ[j];
+
+         if (stamps[id] == stamp)
+            continue;
+
+         stamps[id] = stamp;
+
+         const vector<int> & cls = clauses[id];
+         int nFree      = 0;
+         bool satisfied = false;
+
+         for (size_t k = 0; k < cls.size(); k++) {
+            int val = value(cls[k]);
+
+            if (val == 1) {
+               satisfied = true;
+               break;
+            }
+
+            if (val == 0)
+               nFree++;
+         }
+
+         if (satisfied == false && nFree < (int)weights.size())
+            score += weights[nFree];
+      }
+   }
+
+   return score;
+}
+
+bool
+Lookahead::probe(int lit, double & score)
+{
+   size_t level = trailLim.size();
+   size_t from  = trail.size();
+
+   nProbes++;
+
+   newLevel();
+   enqueue(lit);
+
+   bool res = propagate();
+   score    = res ? reduction(from) : 0;
+
+   backtrack(level);
+
+   return res;
+}
+
+void
+Lookahead::preselect(vector<int> & candidates)
+{
+   vector<pair<double, int> > scores;
+
+   for (int var = 1; var <= nVars; var++) {
+      if (values[var] != 0)
+         continue;
+
+      double pos = occurs[litIndex(var)].size();
+      double neg = occurs[litIndex(-var)].size();
+
+      if (pos + neg > 0)
+         scores.push_back(make_pair(-(pos * neg + pos + neg), var));
+   }
+
+   size_t n = min(scores.size(), (size_t)nCandidates);
+
+   partial_sort(scores.begin(), scores.begin() + n, scores.end());
+
+   candidates.clear();
+   for (size_t i = 0; i < n; i++) {
+      candidates.push_back(scores[i].second);
+   }
+}
+
+int
+Lookahead::lookahead()
+{
+   implied.clear();
+
+   vector<int> candidates;
+
+   while (true) {
+      preselect(candidates);
+
+      if (candidates.empty())
+         return 0;
+
+      int best         = 0;
+      double bestScore = -1;
+
+      for (size_t i = 0; i < candidates.size(); i++) {
+         int var = candidates[i];
+
+         // May have been assigned by a failed literal
+         if (values[var] != 0)
+            continue;
+
+         double pos, neg;
+         bool posOk = probe(var, pos);
+         bool negOk = probe(-var, neg);
+
+         if (posOk == false && negOk == false)
+            return -1;
+
+         if (posOk == false || negOk == false) {
+            int lit = posOk ? var : -var;
+
+            nFailed++;
+            implied.push_back(lit);
+            enqueue(lit);
+
+            if (propagate() == false)
+               return -1;
+
+            continue;
+         }
+
+         // Product of the two reductions, as in march
+         double mix = 1024 * pos * neg + pos + neg;
+
+         if (mix > bestScore) {
+            best      = var;
+            bestScore = mix;
+         }
+      }
+
+      if (best != 0 && values[best] == 0)
+         return best;
+   }
+}
@@ -0,0 +1,139 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "../clauses/ClauseExchange.h"
+
+#include <stdlib.h>
+#include <vector>
+
+using namespace std;
+
+/// Lookahead engine in the style of march, used to split a formula in cubes.
+/// Each decision candidate is propagated in both polarities: a failed literal
+/// forces the other polarity, otherwise the candidate is scored by the
+/// weighted reduction of the clauses. An engine is not thread safe, each
+/// thread works on its own copy.
+class Lookahead
+{
+public:
+   /// Constructor.
+   Lookahead(int nCandidates);
+
+   /// Add the clauses of the formula, return false if the formula is UNSAT
+   /// by unit propagation.
+   bool addClauses(const vector<ClauseExchange *> & clauses);
+
+   /// Get the number of variables of the formula.
+   int getVariablesCount();
+
+   /// Go to the node of a cube, return false if the cube is refuted by unit
+   /// propagation.
+   bool assume(const vector<int> & cube);
+
+   /// Look ahead at the current node. Return the best branching variable,
+   /// 0 if the node has no free variable, and -1 if the node is refuted.
+   int lookahead();
+
+   /// Literals forced by failed literals during the last lookahead.
+   vector<int> implied;
+
+   /// Number of failed literals found.
+   unsigned long nFailed;
+
+   /// Number of literals propagated by a lookahead.
+   unsigned long nProbes;
+
+protected:
+   /// Index of a literal in the watch and occurrence lists.
+   inline int litIndex(int lit)
+   {
+      return lit > 0 ? 2 * lit : -2 * lit + 1;
+   }
+
+   /// Value of a literal: 1 true, -1 false, 0 unassigned.
+   inline int value(int lit)
+   {
+      int val = values[abs(lit)];
+      return lit > 0 ? val : -val;
+   }
+
+   /// Assign a literal.
+   void enqueue(int lit);
+
+   /// Propagate the assigned literals, return false on conflict.
+   bool propagate();
+
+   /// Open a new decision level.
+   void newLevel();
+
+   /// Undo the assignments down to a level.
+   void backtrack(size_t level);
+
+   /// Propagate a literal at a new level and compute its reduction score,
+   /// return false if the literal fails.
+   bool probe(int lit, double & score);
+
+   /// Weighted reduction of the clauses shortened by the assignments made
+   /// since the given position of the trail.
+   double reduction(size_t from);
+
+   /// Fill the candidates with the most promising free variables.
+   void preselect(vector<int> & candidates);
+
+   /// Number of variables.
+   int nVars;
+
+   /// Is the formula consistent at level 0.
+   bool ok;
+
+   /// Maximum number of variables looked ahead at each node.
+   int nCandidates;
+
+   /// Clauses of the formula, the two first literals are watched.
+   vector<vector<int> > clauses;
+
+   /// Clauses watching a literal, by literal index.
+   vector<vector<int> > watches;
+
+   /// Clauses containing a literal, by literal index.
+   vector<vector<int> > occurs;
+
+   /// Values of the variables.
+   vector<signed char> values;
+
+   /// Assigned literals in order.
+   vector<int> trail;
+
+   /// Position of the first literal of each level in the trail.
+   vector<size_t> trailLim;
+
+   /// Position of the next literal to propagate.
+   size_t qhead;
+
+   /// Stamp of the last reduction that visited a clause.
+   vector<unsigned> stamps;
+
+   /// Current reduction stamp.
+   unsigned stamp;
+
+   /// Weight of a reduced clause by number of free literals.
+   vector<double> weights;
+};
@@ -22,6 +22,9 @@
 #include "mapleCOMSPS/core/Dimacs.h"
 #include "mapleCOMSPS/simp/SimpSolver.h"
 
+#include <algorithm>
+
+#include "../painless.h"
 #include "../utils/Logger.h"
 #include "../utils/System.h"
 #include "../utils/Parameters.h"
@@ -44,23 +47,76 @@ static void makeMiniVec(ClauseExchange * cls, vec<Lit> & mcls)
 }
 
 
-void cbkMapleCOMSPSExportClause(void * issuer, int lbd, vec<Lit> & cls)
+bool cbkMapleCOMSPSExportClause(void * issuer, int lbd, vec<Lit> & cls)
 {
 	MapleCOMSPSSolver* mp = (MapleCOMSPSSolver*)issuer;
 
-	if (lbd > mp->lbdLimit)
-		return;
+	// Units and binaries go through the log, whatever their LBD, the ones
+	// the log refuses go through the sharers
+	if (unitLog != NULL && cls.size() <= 2) {
+		bool logged;
+
+		if (cls.size() == 1) {
+			logged = unitLog->addUnit(INT_LIT(cls[0]), mp->id);
+		} else {
+			logged = unitLog->addBinary(INT_LIT(cls[0]), INT_LIT(cls[1]),
+			                            mp->id);
+		}
+
+		if (logged) {
+			mp->nExported++;
+			return false;
+		}
+	}
+
+	// Clauses learnt by enough solvers go to the core tier of all of them,
+	// the solver making the count exports the clause
+	bool promote = false;
+	bool newly   = false;
+
+	if (duplicateTable != NULL && lbd <= duplicateTable->getMaxLbd()) {
+		mp->learntLits.clear();
+		for (int i = 0; i < cls.size(); i++) {
+			mp->learntLits.push_back(INT_LIT(cls[i]));
+		}
+
+		int count = duplicateTable->add(mp->learntLits.data(), cls.size(),
+		                                mp->id);
+
+		promote = count >= duplicateTable->getPromoteCount();
+		newly   = count == duplicateTable->getPromoteCount();
+
+		if (newly) {
+			duplicateTable->notifyPromotion();
+		}
+	}
+
+	if (lbd <= mp->lbdLimit || newly) {
+		mp->nExported++;
+
+		ClauseExchange * ncls = ClauseManager::allocClause(cls.size());
 
-	ClauseExchange * ncls = ClauseManager::allocClause(cls.size());
+		for (int i = 0; i < cls.size(); i++) {
+			ncls->lits[i] = INT_LIT(cls[i]);
+		}
 
-	for (int i = 0; i < cls.size(); i++) {
-		ncls->lits[i] = INT_LIT(cls[i]);
+		ncls->lbd  = lbd;
+		ncls->from = mp->id;
+
+		// In a deterministic search, the clauses wait for the next barrier
+		if (mp->barrier != NULL) {
+			mp->periodClauses.push_back(ncls);
+		} else {
+			mp->clausesToExport.addClause(ncls);
+		}
 	}
 
-   ncls->lbd  = lbd;
-   ncls->from = mp->id;
+	if (mp->barrier != NULL &&
+	    ++mp->periodConflicts >= mp->barrier->getPeriod()) {
+		mp->reachBarrier();
+	}
 
-   mp->clausesToExport.addClause(ncls);
+	return promote;
 }
 
 Lit cbkMapleCOMSPSImportUnit(void * issuer)
@@ -71,22 +127,46 @@ Lit cbkMapleCOMSPSImportUnit(void * issuer)
 
    ClauseExchange * cls = NULL;
 
-   if (mp->unitsToImport.getClause(&cls) == false)
+   if (mp->unitsToImport.getClause(&cls)) {
+      l = MINI_LIT(cls->lits[0]);
+
+      ClauseManager::releaseClause(cls);
+
+      return l;
+   }
+
+   if (unitLog == NULL)
       return l;
 
-   l = MINI_LIT(cls->lits[0]);
+   if (mp->logUnits.empty()) {
+      unitLog->read(mp->unitLogCursor, mp->id, mp->logUnits, mp->logBinaries);
+   }
 
-   ClauseManager::releaseClause(cls);
+   if (mp->logUnits.empty() == false) {
+      l = MINI_LIT(mp->logUnits.back());
+      mp->logUnits.pop_back();
+   }
 
    return l;
 }
 
-bool cbkMapleCOMSPSImportClause(void * issuer, int * lbd, vec<Lit> & mcls)
+bool cbkMapleCOMSPSImportClause(void * issuer, int * lbd, int * source,
+                                vec<Lit> & mcls)
 {
    MapleCOMSPSSolver* mp = (MapleCOMSPSSolver*)issuer;
 
    ClauseExchange * cls = NULL;
 
+   if (mp->logBinaries.empty() == false) {
+      mcls.push(MINI_LIT(mp->logBinaries.back().first));
+      mcls.push(MINI_LIT(mp->logBinaries.back().second));
+      mp->logBinaries.pop_back();
+
+      *lbd = 2;
+
+      return true;
+   }
+
    if (mp->clausesToImport.getClause(&cls) == false)
       return false;
 
@@ -94,11 +174,100 @@ bool cbkMapleCOMSPSImportClause(void * issuer, int * lbd, vec<Lit> & mcls)
 
    *lbd = cls->lbd;
 
+   // A LBD of 1 puts a clause learnt by enough solvers in the core tier
+   if (duplicateTable != NULL &&
+       duplicateTable->count(cls->lits, cls->size) >=
+       duplicateTable->getPromoteCount()) {
+      *lbd = 1;
+   }
+
+   if (mp->trackUsage) {
+      *source = mp->getSourceTag(cls);
+   }
+
    ClauseManager::releaseClause(cls);
 
    return true;
 }
 
+void cbkMapleCOMSPSRestart(void * issuer)
+{
+   MapleCOMSPSSolver * mp = (MapleCOMSPSSolver*)issuer;
+
+   unordered_map<int, int> bumps;
+
+   mp->activityLock.lock();
+   bumps.swap(mp->bumpsToApply);
+   int k = mp->activeVariablesRequest;
+   mp->activeVariablesRequest = 0;
+   mp->activityLock.unlock();
+
+   for (auto bump : bumps) {
+      mp->solver->bumpVariable(bump.first - 1, bump.second);
+   }
+
+   if (k > 0) {
+      vec<Var> vars;
+      mp->solver->getActiveVariables(k, vars);
+
+      vector<int> snapshot;
+      for (int i = 0; i < vars.size(); i++) {
+         snapshot.push_back(vars[i] + 1);
+      }
+
+      mp->activityLock.lock();
+      mp->activeVariables.swap(snapshot);
+      mp->activityLock.unlock();
+   }
+
+   // Phases
+   vector<int> toApply;
+
+   mp->phaseLock.lock();
+   toApply.swap(mp->phasesToApply);
+   int request = mp->phasesRequest;
+   mp->phasesRequest = 0;
+   mp->phaseLock.unlock();
+
+   if (toApply.empty() == false) {
+      vec<Lit> mlits;
+      for (size_t i = 0; i < toApply.size(); i++) {
+         mlits.push(MINI_LIT(toApply[i]));
+      }
+      mp->solver->setPhases(mlits);
+   }
+
+   if (request > 0) {
+      vec<Lit> mlits;
+      mp->solver->getPhases(request == 2, mlits);
+
+      vector<int> snapshot;
+      for (int i = 0; i < mlits.size(); i++) {
+         snapshot.push_back(INT_LIT(mlits[i]));
+      }
+
+      mp->phaseLock.lock();
+      mp->phases.swap(snapshot);
+      mp->phaseLock.unlock();
+   }
+
+   // Usage of the imported clauses
+   if (mp->trackUsage) {
+      int tags = 1 + mp->slotProducers.size() * USAGE_MAX_LBD;
+
+      mp->usageLock.lock();
+      mp->usageProducers = mp->slotProducers;
+      mp->usageImported.resize(tags);
+      mp->usageUsed.resize(tags);
+
+      for (int i = 0; i < tags; i++) {
+         mp->usageImported[i] = mp->solver->importedBySource[i];
+         mp->usageUsed[i]     = mp->solver->usedBySource[i];
+      }
+      mp->usageLock.unlock();
+   }
+}
+
 MapleCOMSPSSolver::MapleCOMSPSSolver(int id) : SolverInterface(id, MAPLE)
 {
 	lbdLimit = Parameters::getIntParam("lbd-limit", 2);
@@ -108,7 +277,17 @@ MapleCOMSPSSolver::MapleCOMSPSSolver(int id) : SolverInterface(id, MAPLE)
 	solver->cbkExportClause = cbkMapleCOMSPSExportClause;
 	solver->cbkImportClause = cbkMapleCOMSPSImportClause;
 	solver->cbkImportUnit   = cbkMapleCOMSPSImportUnit;
+	solver->cbkRestart      = cbkMapleCOMSPSRestart;
 	solver->issuer          = this;
+
+	activeVariablesRequest = 0;
+	phasesRequest          = 0;
+	unitLogCursor          = 0;
+	nExported              = 0;
+	barrier                = NULL;
+	barrierSlot            = 0;
+	periodConflicts        = 0;
+	trackUsage             = Parameters::getBoolParam("shr-feedback");
 }
 
 MapleCOMSPSSolver::MapleCOMSPSSolver(const MapleCOMSPSSolver & other, int id) :
@@ -121,11 +300,34 @@ MapleCOMSPSSolver::MapleCOMSPSSolver(const MapleCOMSPSSolver & other, int id) :
 	solver->cbkExportClause = cbkMapleCOMSPSExportClause;
 	solver->cbkImportClause = cbkMapleCOMSPSImportClause;
 	solver->cbkImportUnit   = cbkMapleCOMSPSImportUnit;
+	solver->cbkRestart      = cbkMapleCOMSPSRestart;
 	solver->issuer          = this;
+
+	activeVariablesRequest = 0;
+	phasesRequest          = 0;
+	unitLogCursor          = 0;
+	nExported              = 0;
+	barrier                = NULL;
+	barrierSlot            = 0;
+	periodConflicts        = 0;
+	trackUsage             = other.trackUsage;
+
+	// The tags of the copied clauses keep their meaning
+	producerSlots          = other.producerSlots;
+	slotProducers          = other.slotProducers;
 }
 
 MapleCOMSPSSolver::~MapleCOMSPSSolver()
 {
+	// The slot of the solver in the table of the learnt clauses is reused
+	if (duplicateTable != NULL) {
+		duplicateTable->removeSolver(id);
+	}
+
+	for (size_t i = 0; i < periodClauses.size(); i++) {
+		ClauseManager::releaseClause(periodClauses[i]);
+	}
+
 	delete solver;
 }
 
@@ -152,20 +354,54 @@ MapleCOMSPSSolver::getVariablesCount()
 int
 MapleCOMSPSSolver::getDivisionVariable()
 {
-   return (rand() % getVariablesCount()) + 1;
+   // Called between two solves: split on the most active free variable that
+   // is not part of the last cube
+   vec<Lit> cube;
+   vec<Var> vars;
+
+   solver->getAssumptions(cube);
+   solver->getActiveVariables(cube.size() + 1, vars);
+
+   for (int i = 0; i < vars.size(); i++) {
+      bool inCube = false;
+
+      for (int j = 0; j < cube.size(); j++) {
+         if (var(cube[j]) == vars[i])
+            inCube = true;
+      }
+
+      if (inCube == false && solver->isEliminated(vars[i]) == false)
+         return vars[i] + 1;
+   }
+
+   int var = (rand() % getVariablesCount()) + 1;
+
+   // Prefer a variable that is neither eliminated nor assigned at level 0
+   for (int tries = 0; tries < 100; tries++) {
+      if (solver->isEliminated(var - 1) == false &&
+          solver->value(var - 1) == l_Undef) {
+         break;
+      }
+      var = (rand() % getVariablesCount()) + 1;
+   }
+
+   return var;
 }
 
-// Set initial phase for a given variable
+// Set initial phase for a given variable, true for the positive literal
 void
 MapleCOMSPSSolver::setPhase(const int var, const bool phase)
 {
-	solver->setPolarity(var - 1, phase ? true : false);
+	solver->setPolarity(var - 1, phase ? false : true);
 }
 
-// Bump activity for a given variable
+// Bump activity for a given variable, applied at the next restart
 void
 MapleCOMSPSSolver::bumpVariableActivity(const int var, const int times)
 {
+   activityLock.lock();
+   bumpsToApply[var] += times;
+   activityLock.unlock();
 }
 
 // Interrupt the SAT solving, so it can be started again with new assumptions
@@ -213,6 +449,12 @@ MapleCOMSPSSolver::diversify(int id)
 SatResult
 MapleCOMSPSSolver::solve(const vector<int> & cube)
 {
+   // A deterministic search does not start again once it has ended
+   if (barrier != NULL && barrier->hasEnded()) {
+      waitGlobalEnding(-1);
+      return UNKNOWN;
+   }
+
    unsetSolverInterrupt();
 
    vector<ClauseExchange *> tmp;
@@ -224,21 +466,45 @@ MapleCOMSPSSolver::solve(const vector<int> & cube)
       vec<Lit> mcls;
       makeMiniVec(tmp[ind], mcls);
 
+      // Incremental clauses may introduce new variables
+      for (int i = 0; i < mcls.size(); i++) {
+         while (solver->nVars() <= var(mcls[i])) {
+            solver->newVar();
+         }
+      }
+
       ClauseManager::releaseClause(tmp[ind]);
 
       if (solver->addClause(mcls) == false) {
          printf("c unsat when adding cls\n");
+         solver->conflict.clear();
          return UNSAT;
       }
    }
 
+   // Assumptions on eliminated variables are dropped, solving a larger
+   // space keeps both answers correct
    vec<Lit> miniAssumptions;
    for (size_t ind = 0; ind < cube.size(); ind++) {
+      while (solver->nVars() < abs(cube[ind])) {
+         solver->newVar();
+      }
+
+      if (solver->isEliminated(abs(cube[ind]) - 1))
+         continue;
+
       miniAssumptions.push(MINI_LIT(cube[ind]));
    }
 
    lbool res = solver->solveLimited(miniAssumptions);
 
+   // In a deterministic search, only the winner of the barrier answers
+   if (barrier != NULL && res != l_Undef &&
+       barrier->finish(barrierSlot) == false) {
+      waitGlobalEnding(-1);
+      return UNKNOWN;
+   }
+
    if (res == l_True)
       return SAT;
 
@@ -335,6 +601,9 @@ MapleCOMSPSSolver::getStatistics()
    stats.restarts     = solver->starts;
    stats.decisions    = solver->decisions;
    stats.memPeak      = memUsedPeak();
+   stats.lbdSum       = solver->learnts_lbd;
+   stats.units        = solver->learnts_units;
+   stats.exported     = nExported;
 
    return stats;
 }
@@ -383,3 +652,146 @@ void
 MapleCOMSPSSolver::setStrengthening(bool b) {
    solver->setStrengthening(b);
 }
+
+void
+MapleCOMSPSSolver::setIncremental()
+{
+   solver->eliminate(true);
+}
+
+bool
+MapleCOMSPSSolver::vivifyClause(const vector<int> & cls, vector<int> & outCls)
+{
+   vec<Lit> mcls;
+   vec<Lit> mout;
+
+   for (size_t i = 0; i < cls.size(); i++) {
+      mcls.push(MINI_LIT(cls[i]));
+   }
+
+   if (solver->vivifyClause(mcls, mout) == false)
+      return false;
+
+   outCls.clear();
+   for (int i = 0; i < mout.size(); i++) {
+      outCls.push_back(INT_LIT(mout[i]));
+   }
+
+   return true;
+}
+
+void
+MapleCOMSPSSolver::getActiveVariables(int k, vector<int> & vars)
+{
+   activityLock.lock();
+   vars = activeVariables;
+   activeVariablesRequest = k;
+   activityLock.unlock();
+}
+
+void
+MapleCOMSPSSolver::getPhases(vector<int> & lits, bool best)
+{
+   phaseLock.lock();
+   lits = phases;
+   phasesRequest = best ? 2 : 1;
+   phaseLock.unlock();
+}
+
+void
+MapleCOMSPSSolver::setPhases(const vector<int> & lits)
+{
+   phaseLock.lock();
+   phasesToApply = lits;
+   phaseLock.unlock();
+}
+
+void
+MapleCOMSPSSolver::setBarrier(BarrierSharing * barrier, int slot)
+{
+   this->barrier = barrier;
+   barrierSlot   = slot;
+}
+
+void
+MapleCOMSPSSolver::reachBarrier()
+{
+   vector<ClauseExchange *> imported;
+
+   periodConflicts = 0;
+
+   if (barrier->exchange(barrierSlot, periodClauses, imported) == false) {
+      // The search has ended at this barrier
+      for (size_t i = 0; i < periodClauses.size(); i++) {
+         ClauseManager::releaseClause(periodClauses[i]);
+      }
+
+      periodClauses.clear();
+
+      setSolverInterrupt();
+      return;
+   }
+
+   addLearnedClauses(imported);
+}
+
+int
+MapleCOMSPSSolver::getSourceTag(ClauseExchange * cls)
+{
+   auto it = producerSlots.find(cls->from);
+
+   int slot;
+
+   if (it != producerSlots.end()) {
+      slot = it->second;
+
+      if (slot < 0)
+         return 0;
+   } else {
+      slot = slotProducers.size();
+
+      // The source tags have 8 bits in the clause header. Without usage, the
+      // sharing strategy keeps its defaults for the producers left out.
+      if (1 + (slot + 1) * USAGE_MAX_LBD > 256) {
+         if (producerSlots.size() == slotProducers.size()) {
+            log(1, "MapleCOMSPS %d tracks the usage of %d producers at most, "
+                "solver %d and the next ones are not tracked\n", id, slot,
+                cls->from);
+         }
+
+         producerSlots[cls->from] = -1;
+
+         return 0;
+      }
+
+      producerSlots[cls->from] = slot;
+      slotProducers.push_back(cls->from);
+   }
+
+   return slot * USAGE_MAX_LBD + max(1, min(cls->lbd, USAGE_MAX_LBD));
+}
+
+void
+MapleCOMSPSSolver::getImportUsage(vector<ClauseUsage> & usage)
+{
+   usageLock.lock();
+
+   for (size_t slot = 0; slot < usageProducers.size(); slot++) {
+      for (int lbd = 1; lbd <= USAGE_MAX_LBD; lbd++) {
+         int tag = slot * USAGE_MAX_LBD + lbd;
+
+         if (usageImported[tag] == 0)
+            continue;
+
+         ClauseUsage u;
+         u.producer = usageProducers[slot];
+         u.lbd      = lbd;
+         u.imported = usageImported[tag];
+         u.used     = usageUsed[tag];
+
+         usage.push_back(u);
+      }
+   }
+
+   usageLock.unlock();
+}
@@ -20,9 +20,14 @@
 #pragma once
 
 #include "../clauses/ClauseBuffer.h"
+#include "../sharing/BarrierSharing.h"
 #include "../solvers/SolverInterface.h"
 #include "../utils/Threading.h"
 
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
 using namespace std;
 
 // Some forward declatarations for MapleCOMSPS
@@ -109,6 +114,29 @@ public:
 
    void setStrengthening(bool b);
 
+   /// Turn off the variable elimination.
+   void setIncremental();
+
+   /// Get the k most active variables, computed at the next restart.
+   void getActiveVariables(int k, vector<int> & vars);
+
+   /// Get a snapshot of the phases, computed at the next restart.
+   void getPhases(vector<int> & lits, bool best);
+
+   /// Set the phases of the variables of a list of literals at the next
+   /// restart.
+   void setPhases(const vector<int> & lits);
+
+   /// Get the usage of the imported clauses, updated at each restart.
+   void getImportUsage(vector<ClauseUsage> & usage);
+
+   /// Try to shorten a clause using unit propagation only.
+   bool vivifyClause(const vector<int> & cls, vector<int> & outCls);
+
+   /// Share the clauses through the barriers of a deterministic search, in
+   /// a given slot, instead of the sharers.
+   void setBarrier(BarrierSharing * barrier, int slot);
+
 
 protected:
    /// Pointer to a MapleCOMSPS solver.
@@ -124,14 +152,94 @@ protected:
    /// Buffer used to add permanent clauses.
    ClauseBuffer clausesToAdd;
    
+   /// Position of the solver in the unit log.
+   size_t unitLogCursor;
+
+   /// Units read from the unit log, not yet imported.
+   vector<int> logUnits;
+
+   /// Binaries read from the unit log, not yet imported.
+   vector<pair<int, int> > logBinaries;
+
    /// Size limit used to share clauses.
    atomic<int> lbdLimit;
+
+   /// Number of clauses exported.
+   atomic<unsigned long> nExported;
+
+   /// Literals of the last learnt clause, for the duplicate table.
+   vector<int> learntLits;
    
    /// Used to stop or continue the resolution.
    atomic<bool> stopSolver;
+
+   /// Mutex protecting the activity bumps and snapshots.
+   Mutex activityLock;
+
+   /// Bumps to apply at the next restart, the times of each variable are
+   /// summed so that it holds at most one entry per variable.
+   unordered_map<int, int> bumpsToApply;
+
+   /// Last snapshot of the most active variables.
+   vector<int> activeVariables;
+
+   /// Size of the snapshot requested for the next restart, 0 if none.
+   int activeVariablesRequest;
+
+   /// Mutex protecting the phases to adopt and the phase snapshots.
+   Mutex phaseLock;
+
+   /// Phases to adopt at the next restart.
+   vector<int> phasesToApply;
+
+   /// Last snapshot of the phases.
+   vector<int> phases;
+
+   /// Snapshot requested for the next restart: 0 none, 1 saved phases, 2
+   /// longest trail.
+   int phasesRequest;
+
+   /// Source tag of an imported clause, from its producer and its LBD, 0 if
+   /// the usage is not tracked.
+   int getSourceTag(ClauseExchange * cls);
+
+   /// Is the usage of the imported clauses tracked.
+   bool trackUsage;
+
+   /// Slot of each producer in the source tags, -1 for the producers whose
+   /// usage cannot be tracked.
+   unordered_map<int, int> producerSlots;
+
+   /// Producer of each slot.
+   vector<int> slotProducers;
+
+   /// Mutex protecting the usage snapshot.
+   Mutex usageLock;
+
+   /// Producers, imported and used clauses per source tag, as of the last
+   /// restart.
+   vector<int> usageProducers;
+   vector<unsigned long> usageImported;
+   vector<unsigned long> usageUsed;
+
+   /// Exchange the clauses at a barrier, called every period conflicts.
+   void reachBarrier();
+
+   /// Barriers of the deterministic search, NULL if none.
+   BarrierSharing * barrier;
+
+   /// Slot of the solver in the barriers.
+   int barrierSlot;
+
+   /// Number of conflicts since the last barrier.
+   int periodConflicts;
+
+   /// Clauses exported since the last barrier.
+   vector<ClauseExchange *> periodClauses;
    
    /// Callback to export/import clauses.
    friend MapleCOMSPS::Lit cbkMapleCOMSPSImportUnit(void *);
-   friend bool cbkMapleCOMSPSImportClause(void *, int *, MapleCOMSPS::vec<MapleCOMSPS::Lit> &);
-   friend void cbkMapleCOMSPSExportClause(void *, int, MapleCOMSPS::vec<MapleCOMSPS::Lit> &);
+   friend bool cbkMapleCOMSPSImportClause(void *, int *, int *, MapleCOMSPS::vec<MapleCOMSPS::Lit> &);
+   friend bool cbkMapleCOMSPSExportClause(void *, int, MapleCOMSPS::vec<MapleCOMSPS::Lit> &);
+   friend void cbkMapleCOMSPSRestart(void *);
 };
@@ -22,12 +22,14 @@
 #include "mapleChronoBT/core/Dimacs.h"
 #include "mapleChronoBT/simp/SimpSolver.h"
 
+#include "../painless.h"
 #include "../utils/Logger.h"
 #include "../utils/System.h"
 #include "../utils/Parameters.h"
 #include "../clauses/ClauseManager.h"
 #include "../solvers/MapleChronoBTSolver.h"
 #include <algorithm>
+#include <unistd.h>
 
 using namespace MapleChronoBT;
 
@@ -36,6 +38,9 @@ using namespace MapleChronoBT;
 
 #define INT_LIT(lit) sign(lit) ? -(var(lit) + 1) : (var(lit) + 1)
 
+/// Time in useconds the vivification thread sleeps when it has no clause.
+#define VIVIFIER_SLEEP 10000
+
 
 static void makeMiniVec(ClauseExchange * cls, vec<Lit> & mcls)
 {
@@ -45,12 +50,54 @@ static void makeMiniVec(ClauseExchange * cls, vec<Lit> & mcls)
 }
 
 
-void cbkMapleChronoBTExportClause(void * issuer, int lbd, vec<Lit> & cls)
+bool cbkMapleChronoBTExportClause(void * issuer, int lbd, vec<Lit> & cls)
 {
 	MapleChronoBTSolver* mp = (MapleChronoBTSolver*)issuer;
 
-	if (lbd > mp->lbdLimit)
-		return;
+	// Units and binaries go through the log, whatever their LBD, the ones
+	// the log refuses go through the sharers
+	if (unitLog != NULL && cls.size() <= 2) {
+		bool logged;
+
+		if (cls.size() == 1) {
+			logged = unitLog->addUnit(INT_LIT(cls[0]), mp->id);
+		} else {
+			logged = unitLog->addBinary(INT_LIT(cls[0]), INT_LIT(cls[1]),
+			                            mp->id);
+		}
+
+		if (logged) {
+			mp->nExported++;
+			return false;
+		}
+	}
+
+	// Clauses learnt by enough solvers go to the core tier of all of them,
+	// the solver making the count exports the clause
+	bool promote = false;
+	bool newly   = false;
+
+	if (duplicateTable != NULL && lbd <= duplicateTable->getMaxLbd()) {
+		mp->learntLits.clear();
+		for (int i = 0; i < cls.size(); i++) {
+			mp->learntLits.push_back(INT_LIT(cls[i]));
+		}
+
+		int count = duplicateTable->add(mp->learntLits.data(), cls.size(),
+		                                mp->id);
+
+		promote = count >= duplicateTable->getPromoteCount();
+		newly   = count == duplicateTable->getPromoteCount();
+
+		if (newly) {
+			duplicateTable->notifyPromotion();
+		}
+	}
+
+	if (lbd > mp->lbdLimit && newly == false)
+		return promote;
+
+	mp->nExported++;
 
 	ClauseExchange * ncls = ClauseManager::allocClause(cls.size());
 
@@ -62,6 +109,8 @@ void cbkMapleChronoBTExportClause(void * issuer, int lbd, vec<Lit> & cls)
    ncls->from = mp->id;
 
    mp->clausesToExport.addClause(ncls);
+
+   return promote;
 }
 
 Lit cbkMapleChronoBTImportUnit(void * issuer)
@@ -72,12 +121,25 @@ Lit cbkMapleChronoBTImportUnit(void * issuer)
 
    ClauseExchange * cls = NULL;
 
-   if (mp->unitsToImport.getClause(&cls) == false)
+   if (mp->unitsToImport.getClause(&cls)) {
+      l = MINI_LIT(cls->lits[0]);
+
+      ClauseManager::releaseClause(cls);
+
       return l;
+   }
 
-   l = MINI_LIT(cls->lits[0]);
+   if (unitLog == NULL)
+      return l;
 
-   ClauseManager::releaseClause(cls);
+   if (mp->logUnits.empty()) {
+      unitLog->read(mp->unitLogCursor, mp->id, mp->logUnits, mp->logBinaries);
+   }
+
+   if (mp->logUnits.empty() == false) {
+      l = MINI_LIT(mp->logUnits.back());
+      mp->logUnits.pop_back();
+   }
 
    return l;
 }
@@ -88,6 +150,16 @@ bool cbkMapleChronoBTImportClause(void * issuer, int * lbd, vec<Lit> & mcls)
 
    ClauseExchange * cls = NULL;
 
+   if (mp->logBinaries.empty() == false) {
+      mcls.push(MINI_LIT(mp->logBinaries.back().first));
+      mcls.push(MINI_LIT(mp->logBinaries.back().second));
+      mp->logBinaries.pop_back();
+
+      *lbd = 2;
+
+      return true;
+   }
+
    if (mp->clausesToImport.getClause(&cls) == false)
       return false;
 
@@ -95,12 +167,128 @@ bool cbkMapleChronoBTImportClause(void * issuer, int * lbd, vec<Lit> & mcls)
 
    *lbd = cls->lbd;
 
+   // A LBD of 1 puts a clause learnt by enough solvers in the core tier
+   if (duplicateTable != NULL &&
+       duplicateTable->count(cls->lits, cls->size) >=
+       duplicateTable->getPromoteCount()) {
+      *lbd = 1;
+   }
+
    ClauseManager::releaseClause(cls);
 
    return true;
 }
 
-MapleChronoBTSolver::MapleChronoBTSolver(int id) : SolverInterface(id, MINISAT)
+void cbkMapleChronoBTRestart(void * issuer)
+{
+   MapleChronoBTSolver * mp = (MapleChronoBTSolver*)issuer;
+
+   // Phases, the polarities are only written by the solver thread
+   vector<int> toApply;
+
+   mp->phaseLock.lock();
+   toApply.swap(mp->phasesToApply);
+   bool request = mp->phasesRequest;
+   mp->phasesRequest = false;
+   mp->phaseLock.unlock();
+
+   if (toApply.empty() == false) {
+      vec<Lit> mlits;
+      for (size_t i = 0; i < toApply.size(); i++) {
+         mlits.push(MINI_LIT(toApply[i]));
+      }
+      mp->solver->setPhases(mlits);
+   }
+
+   if (request) {
+      vec<Lit> mlits;
+      mp->solver->getPhases(mlits);
+
+      vector<int> snapshot;
+      for (int i = 0; i < mlits.size(); i++) {
+         snapshot.push_back(INT_LIT(mlits[i]));
+      }
+
+      mp->phaseLock.lock();
+      mp->phases.swap(snapshot);
+      mp->phaseLock.unlock();
+   }
+
+   // A new snapshot once the vivification thread is done with the last one
+   if (mp->vivifier == NULL || mp->clausesToVivify.size() > 0)
+      return;
+
+   vec<Lit> lits;
+   vec<int> sizes, lbds;
+
+   mp->solver->getLearntsToVivify(Parameters::getIntParam("chrono-viv-batch",
+                                                          1000),
+                                  lits, sizes, lbds);
+
+   for (int i = 0, pos = 0; i < sizes.size(); pos += sizes[i], i++) {
+      ClauseExchange * cls = ClauseManager::allocClause(sizes[i]);
+
+      for (int j = 0; j < sizes[i]; j++) {
+         cls->lits[j] = INT_LIT(lits[pos + j]);
+      }
+
+      cls->lbd  = lbds[i];
+      cls->from = mp->id;
+
+      mp->clausesToVivify.addClause(cls);
+   }
+}
+
+// Main of the thread vivifying the learnt clauses of a solver, the shortened
+// clauses are imported as the shared ones
+void * mainMapleChronoBTVivifier(void * arg)
+{
+   MapleChronoBTSolver * mp = (MapleChronoBTSolver*)arg;
+
+   vec<Lit> mcls;
+   vec<Lit> mout;
+
+   while (mp->stopVivifier == false && globalEnding == false) {
+      ClauseExchange * cls = NULL;
+
+      if (mp->clausesToVivify.getClause(&cls) == false) {
+         usleep(VIVIFIER_SLEEP);
+         continue;
+      }
+
+      mcls.clear();
+      makeMiniVec(cls, mcls);
+
+      mp->nVivified++;
+
+      // An empty clause only means that the formula is UNSAT, the search
+      // finds it by itself
+      if (mp->vivifier->vivifyClause(mcls, mout) && mout.size() > 0 &&
+          mout.size() < mcls.size()) {
+         ClauseExchange * ncls = ClauseManager::allocClause(mout.size());
+
+         for (int i = 0; i < mout.size(); i++) {
+            ncls->lits[i] = INT_LIT(mout[i]);
+         }
+
+         ncls->lbd  = min(cls->lbd, (int)ncls->size);
+         ncls->from = mp->id;
+
+         mp->nShortened++;
+         mp->addLearnedClause(ncls);
+      }
+
+      ClauseManager::releaseClause(cls);
+   }
+
+   log(1, "MapleChronoBT %d vivified %lu learnt clauses, %lu shortened\n",
+       mp->id, mp->nVivified, mp->nShortened);
+
+   return NULL;
+}
+
+MapleChronoBTSolver::MapleChronoBTSolver(int id) :
+   SolverInterface(id, CHRONOBT)
 {
 	lbdLimit = Parameters::getIntParam("lbd-limit", 2);
 
@@ -109,11 +297,61 @@ MapleChronoBTSolver::MapleChronoBTSolver(int id) : SolverInterface(id, MINISAT)
 	solver->cbkExportClause = cbkMapleChronoBTExportClause;
 	solver->cbkImportClause = cbkMapleChronoBTImportClause;
 	solver->cbkImportUnit   = cbkMapleChronoBTImportUnit;
+	solver->cbkRestart      = cbkMapleChronoBTRestart;
+	solver->issuer          = this;
+
+	unitLogCursor = 0;
+	nExported     = 0;
+	phasesRequest = false;
+
+	vivify         = Parameters::getBoolParam("chrono-viv");
+	vivifier       = NULL;
+	vivifierThread = NULL;
+	stopVivifier   = false;
+	nVivified      = 0;
+	nShortened     = 0;
+}
+
+MapleChronoBTSolver::MapleChronoBTSolver(const MapleChronoBTSolver & other,
+                                         int id) :
+   SolverInterface(id, CHRONOBT)
+{
+	lbdLimit = Parameters::getIntParam("lbd-limit", 2);
+
+	solver = new SimpSolver(*(other.solver));
+
+	solver->cbkExportClause = cbkMapleChronoBTExportClause;
+	solver->cbkImportClause = cbkMapleChronoBTImportClause;
+	solver->cbkImportUnit   = cbkMapleChronoBTImportUnit;
+	solver->cbkRestart      = cbkMapleChronoBTRestart;
 	solver->issuer          = this;
+
+	unitLogCursor = 0;
+	nExported     = 0;
+	phasesRequest = false;
+
+	vivify         = Parameters::getBoolParam("chrono-viv");
+	vivifier       = NULL;
+	vivifierThread = NULL;
+	stopVivifier   = false;
+	nVivified      = 0;
+	nShortened     = 0;
 }
 
 MapleChronoBTSolver::~MapleChronoBTSolver()
 {
+	// The slot of the solver in the table of the learnt clauses is reused
+	if (duplicateTable != NULL) {
+		duplicateTable->removeSolver(id);
+	}
+
+	if (vivifierThread != NULL) {
+		stopVivifier = true;
+		vivifierThread->join();
+		delete vivifierThread;
+	}
+
+	delete vivifier;
 	delete solver;
 }
 
@@ -140,14 +378,25 @@ MapleChronoBTSolver::getVariablesCount()
 int
 MapleChronoBTSolver::getDivisionVariable()
 {
-   return (rand() % getVariablesCount()) + 1;
+   int var = (rand() % getVariablesCount()) + 1;
+
+   // Prefer a variable that is neither eliminated nor assigned at level 0
+   for (int tries = 0; tries < 100; tries++) {
+      if (solver->isEliminated(var - 1) == false &&
+          solver->value(var - 1) == l_Undef) {
+         break;
+      }
+      var = (rand() % getVariablesCount()) + 1;
+   }
+
+   return var;
 }
 
-// Set initial phase for a given variable
+// Set initial phase for a given variable, true for the positive literal
 void
 MapleChronoBTSolver::setPhase(const int var, const bool phase)
 {
-	solver->setPolarity(var - 1, phase ? true : false);
+	solver->setPolarity(var - 1, phase ? false : true);
 }
 
 // Bump activity for a given variable
@@ -191,6 +440,24 @@ MapleChronoBTSolver::diversify(int id)
    if (id % 8 < 4) {
       solver->chrono = -1;
    }
+
+   // The next knobs use coprime periods, so that the solvers get different
+   // combinations, the solver 0 keeps the default values
+   static const int conflToChrono[] = {4000, 1000, 20000, 0, 10000};
+   solver->confl_to_chrono = conflToChrono[id % 5];
+
+   // Conflicts searched with the distance heuristic before LRB/VSIDS
+   static const int distanceConfl[] = {50000, 10000, 200000};
+   solver->distance_confl = distanceConfl[id % 3];
+
+   // Learnt clauses promoted to the core after fewer duplicates
+   if (id % 7 >= 4) {
+      solver->min_number_of_learnts_copies = 2;
+      solver->max_lbd_dup                  = 8;
+   } else {
+      solver->min_number_of_learnts_copies = 3;
+      solver->max_lbd_dup                  = 12;
+   }
 }
 
 // Solve the formula with a given set of assumptions
@@ -217,6 +484,14 @@ MapleChronoBTSolver::solve(const vector<int> & cube)
       }
    }
 
+   // The vivification works on the clauses given before the first search
+   if (vivify && vivifier == NULL) {
+      vivifier = new Solver();
+      solver->copyIrredundant(*vivifier);
+
+      vivifierThread = new Thread(mainMapleChronoBTVivifier, this);
+   }
+
    vec<Lit> miniAssumptions;
    for (size_t ind = 0; ind < cube.size(); ind++) {
       miniAssumptions.push(MINI_LIT(cube[ind]));
@@ -320,6 +595,9 @@ MapleChronoBTSolver::getStatistics()
    stats.restarts     = solver->starts;
    stats.decisions    = solver->decisions;
    stats.memPeak      = memUsedPeak();
+   stats.lbdSum       = solver->learnts_lbd;
+   stats.units        = solver->learnts_units;
+   stats.exported     = nExported;
 
    return stats;
 }
@@ -358,3 +636,20 @@ MapleChronoBTSolver::getSatAssumptions()
    vector<int> outCls;
    return outCls;
 }
+
+void
+MapleChronoBTSolver::getPhases(vector<int> & lits, bool best)
+{
+   phaseLock.lock();
+   lits = phases;
+   phasesRequest = true;
+   phaseLock.unlock();
+}
+
+void
+MapleChronoBTSolver::setPhases(const vector<int> & lits)
+{
+   phaseLock.lock();
+   phasesToApply = lits;
+   phaseLock.unlock();
+}
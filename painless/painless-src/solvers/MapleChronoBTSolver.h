@@ -28,6 +28,7 @@ using namespace std;
 // Some forward declatarations for MapleChronoBT
 namespace MapleChronoBT
 {
+	class Solver;
 	class SimpSolver;
 	class Lit;
 	template<class T> class vec;
@@ -96,6 +97,9 @@ public:
 
    /// Constructor.
    MapleChronoBTSolver(int id);
+
+   /// Copy constructor.
+   MapleChronoBTSolver(const MapleChronoBTSolver & other, int id);
    
    /// Destructor.
    virtual ~MapleChronoBTSolver();
@@ -104,6 +108,14 @@ public:
 
    vector<int> getSatAssumptions();
 
+   /// Get a snapshot of the saved phases, computed at the next restart.
+   /// MapleChronoBT does not keep the longest trail, best is ignored.
+   void getPhases(vector<int> & lits, bool best);
+
+   /// Set the phases of the variables of a list of literals at the next
+   /// restart.
+   void setPhases(const vector<int> & lits);
+
 protected:
    /// Pointer to a MapleChronoBT solver.
    MapleChronoBT::SimpSolver * solver;
@@ -117,16 +129,65 @@ protected:
 
    /// Buffer used to add permanent clauses.
    ClauseBuffer clausesToAdd;
+
+   /// Position of the solver in the unit log.
+   size_t unitLogCursor;
+
+   /// Units read from the unit log, not yet imported.
+   vector<int> logUnits;
+
+   /// Binaries read from the unit log, not yet imported.
+   vector<pair<int, int> > logBinaries;
    
    /// Size limit used to share clauses.
    atomic<int> lbdLimit;
+
+   /// Number of clauses exported.
+   atomic<unsigned long> nExported;
+
+   /// Literals of the last learnt clause, for the duplicate table.
+   vector<int> learntLits;
    
+   /// Mutex protecting the phases to adopt and the phase snapshots.
+   Mutex phaseLock;
+
+   /// Phases to adopt at the next restart.
+   vector<int> phasesToApply;
+
+   /// Last snapshot of the phases.
+   vector<int> phases;
+
+   /// Is a snapshot of the phases requested for the next restart.
+   bool phasesRequest;
+
    /// Used to stop or continue the resolution.
    atomic<bool> stopSolver;
+
+   /// Is a snapshot of the learnt clauses vivified in a helper thread.
+   bool vivify;
+
+   /// Copy of the irredundant clauses used by the vivification, NULL if not
+   /// created yet.
+   MapleChronoBT::Solver * vivifier;
+
+   /// Thread vivifying the learnt clauses, NULL if not started yet.
+   Thread * vivifierThread;
+
+   /// Used to stop the vivification thread.
+   atomic<bool> stopVivifier;
+
+   /// Learnt clauses waiting for the vivification.
+   ClauseBuffer clausesToVivify;
+
+   /// Number of learnt clauses vivified, and shortened.
+   unsigned long nVivified;
+   unsigned long nShortened;
    
    /// Callback to export/import clauses.
    friend MapleChronoBT::Lit cbkMapleChronoBTImportUnit(void *);
    friend bool cbkMapleChronoBTImportClause(void *, int *, MapleChronoBT::vec<MapleChronoBT::Lit> &);
-   friend void cbkMapleChronoBTExportClause(void *, int, MapleChronoBT::vec<MapleChronoBT::Lit> &);
+   friend bool cbkMapleChronoBTExportClause(void *, int, MapleChronoBT::vec<MapleChronoBT::Lit> &);
    friend void cbkMapleChronoBTLogOrder(void*);
+   friend void cbkMapleChronoBTRestart(void *);
+   friend void * mainMapleChronoBTVivifier(void *);
 };
@@ -43,16 +43,64 @@ static void makeMiniVec(ClauseExchange * cls, vec<Lit> & mcls)
    }
 }
 
+// Main executed by the reducer threads
+void * mainReducer(void * arg)
+{
+   Reducer::ReducerWorker * worker = (Reducer::ReducerWorker *)arg;
+
+   worker->result = worker->reducer->reduce(worker->solver);
+
+   return NULL;
+}
+
 Reducer::Reducer(int id, SolverInterface *_solver) :
-   SolverInterface(id, MAPLE)
+   SolverInterface(id, MAPLE),
+   clausesToImport(Parameters::getIntParam("red-queue-size", 10000),
+                   Parameters::getIntParam("red-max-age", 10))
 {
-   solver = _solver;
-   solver->setStrengthening(true);
+   solvers.push_back(_solver);
+   _solver->setStrengthening(true);
+
+   strategy     = Parameters::getIntParam("red-strat", 0);
+   fullSolveLbd = Parameters::getIntParam("red-full-lbd", 4);
+
+   stopReducer          = false;
+   nClausesIn           = 0;
+   nClausesReduced      = 0;
+   nClausesStrengthened = 0;
+   nClausesVivified     = 0;
+   nLiteralsRemoved     = 0;
+   reduceTime           = 0;
+}
+
+Reducer::Reducer(int id, const vector<SolverInterface *> & _solvers) :
+   SolverInterface(id, MAPLE),
+   clausesToImport(Parameters::getIntParam("red-queue-size", 10000),
+                   Parameters::getIntParam("red-max-age", 10))
+{
+   solvers = _solvers;
+
+   for (size_t i = 0; i < solvers.size(); i++) {
+      solvers[i]->setStrengthening(true);
+   }
+
+   strategy     = Parameters::getIntParam("red-strat", 0);
+   fullSolveLbd = Parameters::getIntParam("red-full-lbd", 4);
+
+   stopReducer          = false;
+   nClausesIn           = 0;
+   nClausesReduced      = 0;
+   nClausesStrengthened = 0;
+   nClausesVivified     = 0;
+   nLiteralsRemoved     = 0;
+   reduceTime           = 0;
 }
 
 Reducer::~Reducer()
 {
-   delete solver;
+   for (size_t i = 0; i < solvers.size(); i++) {
+      delete solvers[i];
+   }
 }
 
 bool
@@ -65,48 +113,64 @@ Reducer::loadFormula(const char* filename)
 int
 Reducer::getVariablesCount()
 {
-   return solver->getVariablesCount();
+   return solvers[0]->getVariablesCount();
 }
 
 // Get a variable suitable for search splitting
 int
 Reducer::getDivisionVariable()
 {
-   return solver->getDivisionVariable();
+   return solvers[0]->getDivisionVariable();
 }
 
 // Set initial phase for a given variable
 void
 Reducer::setPhase(const int var, const bool phase)
 {
-   solver->setPhase(var, phase);
+   for (size_t i = 0; i < solvers.size(); i++) {
+      solvers[i]->setPhase(var, phase);
+   }
 }
 
 // Bump activity for a given variable
 void
 Reducer::bumpVariableActivity(const int var, const int times)
 {
-   solver->bumpVariableActivity(var, times);
+   for (size_t i = 0; i < solvers.size(); i++) {
+      solvers[i]->bumpVariableActivity(var, times);
+   }
 }
 
 // Interrupt the SAT solving, so it can be started again with new assumptions
 void
 Reducer::setSolverInterrupt()
 {
-   solver->setSolverInterrupt();
+   stopReducer = true;
+
+   for (size_t i = 0; i < solvers.size(); i++) {
+      solvers[i]->setSolverInterrupt();
+   }
+
+   clausesToImport.wakeUp();
 }
 
 void
 Reducer::unsetSolverInterrupt()
 {
-   solver->unsetSolverInterrupt();
+   stopReducer = false;
+
+   for (size_t i = 0; i < solvers.size(); i++) {
+      solvers[i]->unsetSolverInterrupt();
+   }
 }
 
 // Diversify the solver
 void
 Reducer::diversify(int id)
 {
-   solver->diversify(id);
+   for (size_t i = 0; i < solvers.size(); i++) {
+      solvers[i]->diversify(id);
+   }
 }
 
 // Solve the formula with a given set of assumptions
@@ -116,70 +180,161 @@ Reducer::solve(const vector<int> & cube)
 {
    unsetSolverInterrupt();
 
-   while (true) {
+   // The first inner solver is used by the calling thread
+   vector<ReducerWorker> workers(solvers.size());
+   vector<Thread *> threads;
+
+   for (size_t i = 1; i < solvers.size(); i++) {
+      workers[i].reducer = this;
+      workers[i].solver  = solvers[i];
+      workers[i].result  = UNKNOWN;
+
+      threads.push_back(new Thread(mainReducer, &workers[i]));
+   }
+
+   SatResult res = reduce(solvers[0]);
+
+   for (size_t i = 0; i < threads.size(); i++) {
+      threads[i]->join();
+      delete threads[i];
+
+      if (workers[i + 1].result == UNSAT) {
+         res = UNSAT;
+      }
+   }
+
+   return res;
+}
+
+SatResult
+Reducer::reduce(SolverInterface * solver)
+{
+   while (stopReducer == false) {
       ClauseExchange *cls;
       ClauseExchange *strengthenedCls;
-      if (clausesToImport.getClause(&cls) == false) {
+      if (clausesToImport.getClause(&cls, 100000) == false) {
          continue;
       }
-      if (strengthened(cls, &strengthenedCls))
-      {
+
+      double start = getAbsoluteTime();
+
+      bool isStrengthened = strengthened(solver, cls, &strengthenedCls);
+
+      reduceTime += (getAbsoluteTime() - start) * 1000000;
+      nClausesReduced++;
+
+      if (isStrengthened) {
+         nClausesStrengthened++;
+         nLiteralsRemoved += cls->size - strengthenedCls->size;
+
          if (strengthenedCls->size == 0) {
+            ClauseManager::releaseClause(strengthenedCls);
+            ClauseManager::releaseClause(cls);
+
+            // Stop the other workers
+            stopReducer = true;
+            clausesToImport.wakeUp();
+
             return UNSAT;
          }
-         ClauseManager::increaseClause(strengthenedCls);
          clausesToExport.addClause(strengthenedCls);
       }
+
+      ClauseManager::releaseClause(cls);
    }
    return UNKNOWN;
 }
 
 
 bool
-Reducer::strengthened(ClauseExchange * cls,
-                               ClauseExchange ** outCls)
+Reducer::strengthened(SolverInterface * solver, ClauseExchange * cls,
+                      ClauseExchange ** outCls)
 {
-   vector<int> assumps;
    vector<int> tmpNewClause;
-   for (size_t ind = 0; ind < cls->size; ind++) {
-      assumps.push_back(-cls->lits[ind]);
-   }
-   SatResult res = solver->solve(assumps);
-   if (res == UNSAT) {
-      tmpNewClause = solver->getFinalAnalysis();
-   } else if (res == SAT) {
-      tmpNewClause = solver->getSatAssumptions();
+   SatResult res = UNKNOWN;
+
+   if (strategy != 0) {
+      vector<int> lits(cls->lits, cls->lits + cls->size);
+
+      if (solver->vivifyClause(lits, tmpNewClause) &&
+          tmpNewClause.size() < cls->size) {
+         // Same as the final analysis of a full solve
+         nClausesVivified++;
+         res = UNSAT;
+      } else if (strategy == 1 || cls->lbd > fullSolveLbd) {
+         return false;
+      }
    }
 
-   if (tmpNewClause.size() < cls->size || res == SAT) {
-      *outCls = ClauseManager::allocClause(tmpNewClause.size());
-      for (int idLit = 0; idLit < tmpNewClause.size(); idLit++) {
-         (*outCls)->lits[idLit] = tmpNewClause[idLit];
+   if (res == UNKNOWN) {
+      vector<int> assumps;
+      for (size_t ind = 0; ind < cls->size; ind++) {
+         assumps.push_back(-cls->lits[ind]);
       }
-      (*outCls)->from = this->id;
-      (*outCls)->lbd  = cls->lbd;
-      if ((*outCls)->size < (*outCls)->lbd) {
-         (*outCls)->lbd = (*outCls)->size;
+
+      res = solver->solve(assumps);
+      if (res == UNSAT) {
+         tmpNewClause = solver->getFinalAnalysis();
+      } else if (res == SAT) {
+         tmpNewClause = solver->getSatAssumptions();
+      } else {
+         // Interrupted, nothing can be deduced
+         return false;
       }
-      if (res == SAT) {
-         solver->addClause(*outCls);
+   }
+
+   bool isStrengthened = tmpNewClause.size() < cls->size;
+
+   if (isStrengthened == false && res != SAT) {
+      return false;
+   }
+
+   ClauseExchange * newCls = ClauseManager::allocClause(tmpNewClause.size());
+   for (int idLit = 0; idLit < tmpNewClause.size(); idLit++) {
+      newCls->lits[idLit] = tmpNewClause[idLit];
+   }
+   newCls->from = this->id;
+   newCls->lbd  = cls->lbd;
+   if (newCls->size < newCls->lbd) {
+      newCls->lbd = newCls->size;
+   }
+
+   if (res == SAT) {
+      // The inner solver keeps the clause to strengthen the next ones
+      if (isStrengthened) {
+         ClauseManager::increaseClause(newCls);
       }
+      solver->addClause(newCls);
+   }
+
+   if (isStrengthened) {
+      *outCls = newCls;
    }
-   return tmpNewClause.size() < cls->size;
+
+   return isStrengthened;
 }
 
 void
 Reducer::addClause(ClauseExchange * clause)
 {
-   solver->addClause(clause);
+   ClauseManager::increaseClause(clause, solvers.size() - 1);
+
+   for (size_t i = 0; i < solvers.size(); i++) {
+      solvers[i]->addClause(clause);
+   }
 }
 
 void
 Reducer::addLearnedClause(ClauseExchange * clause)
 {
    if (clause->size == 1) {
-      solver->addLearnedClause(clause);
+      ClauseManager::increaseClause(clause, solvers.size() - 1);
+
+      for (size_t i = 0; i < solvers.size(); i++) {
+         solvers[i]->addLearnedClause(clause);
+      }
    } else {
+      nClausesIn++;
       clausesToImport.addClause(clause);
    }
 }
@@ -187,13 +342,17 @@ Reducer::addLearnedClause(ClauseExchange * clause)
 void
 Reducer::addClauses(const vector<ClauseExchange *> & clauses)
 {
-   solver->addClauses(clauses);
+   for (size_t i = 0; i < clauses.size(); i++) {
+      addClause(clauses[i]);
+   }
 }
 
 void
 Reducer::addInitialClauses(const vector<ClauseExchange *> & clauses)
 {
-   solver->addInitialClauses(clauses);
+   for (size_t i = 0; i < solvers.size(); i++) {
+      solvers[i]->addInitialClauses(clauses);
+   }
 }
 
 void
@@ -213,44 +372,74 @@ Reducer::getLearnedClauses(vector<ClauseExchange *> & clauses)
 void
 Reducer::increaseClauseProduction()
 {
-   solver->increaseClauseProduction();
+   for (size_t i = 0; i < solvers.size(); i++) {
+      solvers[i]->increaseClauseProduction();
+   }
 }
 
 void
 Reducer::decreaseClauseProduction()
 {
-   solver->decreaseClauseProduction();
+   for (size_t i = 0; i < solvers.size(); i++) {
+      solvers[i]->decreaseClauseProduction();
+   }
 }
 
 SolvingStatistics
 Reducer::getStatistics()
 {
-   return solver->getStatistics();
+   SolvingStatistics stats;
+
+   for (size_t i = 0; i < solvers.size(); i++) {
+      SolvingStatistics inner = solvers[i]->getStatistics();
+
+      stats.propagations += inner.propagations;
+      stats.decisions    += inner.decisions;
+      stats.conflicts    += inner.conflicts;
+      stats.restarts     += inner.restarts;
+      stats.lbdSum       += inner.lbdSum;
+      stats.units        += inner.units;
+      stats.exported     += inner.exported;
+      stats.memPeak       = inner.memPeak;
+   }
+
+   return stats;
 }
 
 void
 Reducer::printStatsStrengthening()
 {
-   // log(0, "count,min,max,average,stdDeviation,sum\n");
-   // log(0, "cls_in,%s\n", cls_in.valueString().c_str());
-   // log(0, "cls_out,%s\n", cls_out.valueString().c_str());
-   // log(0, "strengthened,%s\n", strengthened.valueString().c_str());
+   unsigned long reduced      = nClausesReduced;
+   unsigned long strengthened = nClausesStrengthened;
+
+   double litsPerCls = strengthened ? nLiteralsRemoved / (double)strengthened
+                                    : 0;
+   double timePerCls = reduced ? reduceTime / (double)reduced : 0;
+
+   printf("c Reducer %d (%zu workers) received cls %lu, handled cls %lu, " \
+          "strengthened cls %lu (%lu by propagation), removed lits/cls " \
+          "%.2f, time/cls %.1fus, " \
+          "dropped cls %lu duplicated, %lu overflow, %lu stale\n", id,
+          solvers.size(), (unsigned long)nClausesIn, reduced, strengthened,
+          (unsigned long)nClausesVivified, litsPerCls, timePerCls, (unsigned long)clausesToImport.duplicates,
+          (unsigned long)clausesToImport.overflows,
+          (unsigned long)clausesToImport.stales);
 }
 
 vector<int>
 Reducer::getModel()
 {
-   return solver->getModel();
+   return solvers[0]->getModel();
 }
 
 vector<int>
 Reducer::getFinalAnalysis()
 {
-   return solver->getFinalAnalysis();
+   return solvers[0]->getFinalAnalysis();
 }
 
 vector<int>
 Reducer::getSatAssumptions()
 {
-   return solver->getSatAssumptions();
+   return solvers[0]->getSatAssumptions();
 }
@@ -20,9 +20,12 @@
 #pragma once
 
 #include "../clauses/ClauseBuffer.h"
+#include "../clauses/ClausePriorityBuffer.h"
 #include "../solvers/SolverInterface.h"
 #include "../utils/Threading.h"
 
+#include <vector>
+
 using namespace std;
 
 // Some forward declatarations for MapleCOMSPS
@@ -33,7 +36,11 @@ namespace MapleCOMSPS
    template<class T> class vec;
 }
 
-/// Instance of a MapleCOMSPS solver
+// Main executed by the reducer threads
+static void * mainReducer(void * arg);
+
+/// Reducer service: a pool of inner solvers that strengthen the clauses they
+/// receive. The clauses are handled in a shared priority buffer.
 class Reducer : public SolverInterface
 {
 public:
@@ -99,26 +106,72 @@ public:
    /// Native diversification.
    void diversify(int id);
 
-   bool strengthened(ClauseExchange * cls, ClauseExchange ** outCls);
+   /// Try to strengthen a clause with a given inner solver.
+   bool strengthened(SolverInterface * solver, ClauseExchange * cls,
+                     ClauseExchange ** outCls);
 
+   /// Print the strengthening statistics.
    void printStatsStrengthening();
 
    vector<int> getSatAssumptions();
 
    /// Constructor.
-   Reducer(int id, SolverInterface* solver);
+   Reducer(int id, SolverInterface * solver);
+
+   /// Constructor of a reducer with several inner solvers.
+   Reducer(int id, const vector<SolverInterface *> & solvers);
    
    /// Destructor.
    virtual ~Reducer();
 
 protected:
-   /// Pointer to a MapleCOMSPS solver.
-   SolverInterface * solver;
+   friend void * mainReducer(void * arg);
+
+   /// Argument given to the reducer threads.
+   struct ReducerWorker
+   {
+      Reducer * reducer;
+      SolverInterface * solver;
+      SatResult result;
+   };
+
+   /// Strengthening loop of one inner solver.
+   SatResult reduce(SolverInterface * solver);
+
+   /// Strengthening strategy: 0 full solve, 1 propagation only, 2 propagation
+   /// then full solve for the clauses with a small LBD.
+   int strategy;
+
+   /// LBD limit of the clauses worth a full solve with strategy 2.
+   int fullSolveLbd;
 
-   /// Buffer used to import clauses (units included).
-   ClauseBuffer clausesToImport;
+   /// Pointers to the inner MapleCOMSPS solvers, one per worker.
+   vector<SolverInterface *> solvers;
+
+   /// Buffer used to import clauses (units are given to the inner solvers).
+   ClausePriorityBuffer clausesToImport;
 
    /// Buffer used to export clauses (units included).
    ClauseBuffer clausesToExport;
 
+   /// Used to stop or continue the strengthening.
+   atomic<bool> stopReducer;
+
+   /// Number of clauses received.
+   atomic<unsigned long> nClausesIn;
+
+   /// Number of clauses handled by the workers.
+   atomic<unsigned long> nClausesReduced;
+
+   /// Number of clauses strengthened.
+   atomic<unsigned long> nClausesStrengthened;
+
+   /// Number of clauses strengthened by unit propagation only.
+   atomic<unsigned long> nClausesVivified;
+
+   /// Number of literals removed from the strengthened clauses.
+   atomic<unsigned long> nLiteralsRemoved;
+
+   /// Time spent to handle the clauses, in microseconds.
+   atomic<unsigned long> reduceTime;
 };
@@ -17,6 +17,9 @@
 // this program.  If not, see <http://www.gnu.org/licenses/>.
 // -----------------------------------------------------------------------------
 
+#include "../sharing/MpiBridge.h"
+#include "../sharing/ShmBridge.h"
+#include "../solvers/LocalSearchSolver.h"
 #include "../solvers/MapleCOMSPSSolver.h"
 #include "../solvers/MapleChronoBTSolver.h"
 #include "../solvers/SolverFactory.h"
@@ -26,7 +29,7 @@
 
 void
 SolverFactory::sparseRandomDiversification(
-      const vector<SolverInterface *> & solvers)
+      const vector<SolverInterface *> & solvers, int seed)
 {
    if (solvers.size() == 0)
       return;
@@ -34,8 +37,8 @@ SolverFactory::sparseRandomDiversification(
    int vars = solvers[0]->getVariablesCount();
 
    // The first solver of the group (1 LRB/1 VSIDS) keeps polarity = false for all vars
-   for (int sid = 1; sid < solvers.size(); sid++) {
-      srand(sid);
+   for (int sid = seed > 0 ? 0 : 1; sid < solvers.size(); sid++) {
+      srand(seed * solvers.size() + sid);
       for (int var = 1; var <= vars; var++) {
          if (rand() % solvers.size() == 0) {
             solvers[sid]->setPhase(var, rand() % 2 == 1);
@@ -54,12 +57,30 @@ SolverFactory::nativeDiversification(const vector<SolverInterface *> & solvers)
 
 SolverInterface *
 SolverFactory::createMapleCOMSPSSolver()
+{
+   return createMapleCOMSPSSolver(Parameters::getFilename());
+}
+
+SolverInterface *
+SolverFactory::createMapleCOMSPSSolver(const char * filename)
 {
    int id = currentIdSolver.fetch_add(1);
 
    SolverInterface * solver = new MapleCOMSPSSolver(id);
 
-   solver->loadFormula(Parameters::getFilename());
+   solver->loadFormula(filename);
+
+   return solver;
+}
+
+SolverInterface *
+SolverFactory::createIncrementalMapleCOMSPSSolver()
+{
+   int id = currentIdSolver.fetch_add(1);
+
+   SolverInterface * solver = new MapleCOMSPSSolver(id);
+
+   solver->setIncremental();
 
    return solver;
 }
@@ -76,6 +97,18 @@ SolverFactory::createMapleChronoBTSolver()
    return solver;
 }
 
+SolverInterface *
+SolverFactory::createLocalSearchSolver()
+{
+   int id = currentIdSolver.fetch_add(1);
+
+   SolverInterface * solver = new LocalSearchSolver(id);
+
+   solver->loadFormula(Parameters::getFilename());
+
+   return solver;
+}
+
 SolverInterface *
 SolverFactory::createReducerSolver(SolverInterface* _solver)
 {
@@ -86,11 +119,29 @@ SolverFactory::createReducerSolver(SolverInterface* _solver)
    return solver;
 }
 
+SolverInterface *
+SolverFactory::createReducerSolver(const vector<SolverInterface *> & _solvers)
+{
+   int id = currentIdSolver.fetch_add(1);
+
+   SolverInterface * solver = new Reducer(id, _solvers);
+
+   return solver;
+}
+
 void
 SolverFactory::createMapleCOMSPSSolvers(int maxSolvers,
                                         vector<SolverInterface *> & solvers)
 {
-   solvers.push_back(createMapleCOMSPSSolver());
+   createMapleCOMSPSSolvers(maxSolvers, solvers, Parameters::getFilename());
+}
+
+void
+SolverFactory::createMapleCOMSPSSolvers(int maxSolvers,
+                                        vector<SolverInterface *> & solvers,
+                                        const char * filename)
+{
+   solvers.push_back(createMapleCOMSPSSolver(filename));
 
    double memoryUsed    = getMemoryUsed();
    int maxMemorySolvers = Parameters::getIntParam("max-memory", 240) * 1024 *
@@ -106,13 +157,45 @@ SolverFactory::createMapleCOMSPSSolvers(int maxSolvers,
 }
 
 void
-SolverFactory::createMapleChronoBTSolvers(int nbSolvers,
-                           vector<SolverInterface *> & solvers)
+SolverFactory::createMapleChronoBTSolvers(int maxSolvers,
+                                          vector<SolverInterface *> & solvers)
 {
-   for (size_t i = 0; i < nbSolvers; i++) {
-      MapleChronoBTSolver* maple = (MapleChronoBTSolver*) createMapleChronoBTSolver();
-      solvers.push_back(maple);
+   if (maxSolvers <= 0)
+      return;
+
+   // The formula is parsed once, the other solvers are copies
+   SolverInterface * first = createMapleChronoBTSolver();
+   solvers.push_back(first);
+
+   double memoryUsed    = getMemoryUsed();
+   int maxMemorySolvers = Parameters::getIntParam("max-memory", 240) * 1024 *
+                          1024 / memoryUsed;
+
+   if (maxSolvers > maxMemorySolvers) {
+      maxSolvers = maxMemorySolvers;
    }
+
+   for (int i = 1; i < maxSolvers; i++) {
+      solvers.push_back(cloneSolver(first));
+   }
+}
+
+#ifdef USE_MPI
+SolverInterface *
+SolverFactory::createMpiBridge()
+{
+   int id = currentIdSolver.fetch_add(1);
+
+   return new MpiBridge(id);
+}
+#endif
+
+SolverInterface *
+SolverFactory::createShmBridge(ProcessGroup * group)
+{
+   int id = currentIdSolver.fetch_add(1);
+
+   return new ShmBridge(id, group);
 }
 
 SolverInterface *
@@ -127,6 +210,10 @@ SolverFactory::cloneSolver(SolverInterface * other)
 	      solver = new MapleCOMSPSSolver((MapleCOMSPSSolver &) *other, id);
       	break;
 
+      case CHRONOBT :
+         solver = new MapleChronoBTSolver((MapleChronoBTSolver &) *other, id);
+         break;
+
       default :
          return NULL;
    }
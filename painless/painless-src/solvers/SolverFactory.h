@@ -20,6 +20,7 @@
 #pragma once
 
 #include "../solvers/SolverInterface.h"
+#include "../working/ProcessGroup.h"
 
 #include <vector>
 
@@ -34,26 +35,58 @@ public:
    /// Instantiate and return a MapleCOMSPS solver.
    static SolverInterface * createMapleCOMSPSSolver();
 
+   /// Instantiate and return a MapleCOMSPS solver of a given dimacs file.
+   static SolverInterface * createMapleCOMSPSSolver(const char * filename);
+
+   /// Instantiate and return an empty MapleCOMSPS solver for incremental
+   /// solving, its clauses are added with addClause.
+   static SolverInterface * createIncrementalMapleCOMSPSSolver();
+
+   /// Instantiate and return a MapleChronoBT solver.
    static SolverInterface * createMapleChronoBTSolver();
 
    /// Instantiate and return a group of MapleCOMSPS solvers.
    static void createMapleCOMSPSSolvers(int groupSize,
                                         vector<SolverInterface *> & solvers);
 
+   /// Instantiate and return a group of MapleCOMSPS solvers of a given dimacs
+   /// file, parsed once.
+   static void createMapleCOMSPSSolvers(int groupSize,
+                                        vector<SolverInterface *> & solvers,
+                                        const char * filename);
+
+   /// Instantiate and return a group of MapleChronoBT solvers.
    static void createMapleChronoBTSolvers(int groupSize,
-                                        vector<SolverInterface *> & solvers);
+                                          vector<SolverInterface *> & solvers);
+
+   /// Instantiate and return a local search solver.
+   static SolverInterface * createLocalSearchSolver();
 
    static SolverInterface * createReducerSolver(SolverInterface *solver);
 
+   /// Instantiate and return a reducer using several inner solvers.
+   static SolverInterface * createReducerSolver(
+                                 const vector<SolverInterface *> & solvers);
+
+#ifdef USE_MPI
+   /// Instantiate and return the bridge to the other processes of an MPI run.
+   static SolverInterface * createMpiBridge();
+#endif
+
+   /// Instantiate and return the bridge to the other processes of a group.
+   static SolverInterface * createShmBridge(ProcessGroup * group);
+
    /// Clone and return a new solver.
    static SolverInterface * cloneSolver(SolverInterface * other);
 
    /// Print stats of a groupe of solvers.
    static void printStats(const vector<SolverInterface *> & solvers);
 
-   /// Apply a sparse and random diversification on solvers.
+   /// Apply a sparse and random diversification on solvers. With a positive
+   /// seed, e.g. the rank of the process, the first solver is diversified too.
    static void sparseRandomDiversification(const
-                                           vector<SolverInterface *> & solvers);
+                                           vector<SolverInterface *> & solvers,
+                                           int seed = 0);
 
    /// Apply a native diversification on solvers.
    static void nativeDiversification(const vector<SolverInterface *> & solvers);
@@ -29,6 +29,10 @@
 #define ID_SYM 0
 #define ID_XOR 1
 
+/// The usage of the imported clauses is counted per LBD up to this value,
+/// the clauses with a larger LBD count at this value.
+#define USAGE_MAX_LBD 8
+
 
 using namespace std;
 
@@ -48,7 +52,20 @@ enum SolverType
 	GLUCOSE   = 0,
 	LINGELING = 1,
 	MAPLE     = 2,
-	MINISAT   = 3
+	MINISAT   = 3,
+	CHRONOBT  = 4,
+	LOCAL_SEARCH = 5,
+	REMOTE    = 6
+};
+
+
+/// Usage of the clauses imported from a producer with a given LBD.
+struct ClauseUsage
+{
+   int producer;           ///< Id of the producer.
+   int lbd;                ///< LBD at the export, at most USAGE_MAX_LBD.
+   unsigned long imported; ///< Number of imported clauses.
+   unsigned long used;     ///< Number of them used in a conflict analysis.
 };
 
 
@@ -63,6 +80,9 @@ struct SolvingStatistics
       conflicts    = 0;
       restarts     = 0;
       memPeak      = 0;
+      lbdSum       = 0;
+      units        = 0;
+      exported     = 0;
    }
 
 	unsigned long propagations; ///< Number of propagations.
@@ -70,6 +90,9 @@ struct SolvingStatistics
 	unsigned long conflicts;    ///< Number of reached conflicts.
 	unsigned long restarts;     ///< Number of restarts.
 	double        memPeak;      ///< Maximum memory used in Ko.
+	unsigned long lbdSum;       ///< Sum of the LBD of the learnt clauses.
+	unsigned long units;        ///< Number of learnt unit clauses.
+	unsigned long exported;     ///< Number of exported clauses.
 };
 
 
@@ -86,7 +109,7 @@ public:
    /// Get a variable suitable for search splitting.
    virtual int getDivisionVariable() = 0;
 
-   /// Set initial phase for a given variable.
+   /// Set initial phase for a given variable, true for the positive literal.
    virtual void setPhase(const int var, const bool phase) = 0;
 
    /// Bump activity of a given variable.
@@ -141,6 +164,39 @@ public:
 
    virtual void setStrengthening(bool b) {};
 
+   /// Keep every variable of the formula, so that clauses and assumptions
+   /// may use any variable between two solves. Called before adding clauses.
+   virtual void setIncremental() {};
+
+   /// Get the k most active variables, the most active first. The list can
+   /// be computed asynchronously, it may come from a previous request.
+   virtual void getActiveVariables(int k, vector<int> & vars) {};
+
+   /// Get a snapshot of the phases as literals: the saved phases, or the
+   /// longest trail if best is true. The snapshot can be computed
+   /// asynchronously, it may come from a previous request.
+   virtual void getPhases(vector<int> & lits, bool best) {};
+
+   /// Get the usage of the imported clauses since the beginning of the
+   /// search, appended to usage. Nothing if the solver does not track it.
+   virtual void getImportUsage(vector<ClauseUsage> & usage) {};
+
+   /// Set the phases of the variables of a list of literals.
+   virtual void setPhases(const vector<int> & lits)
+   {
+      for (size_t i = 0; i < lits.size(); i++) {
+         setPhase(abs(lits[i]), lits[i] > 0);
+      }
+   }
+
+   /// Try to shorten a clause using unit propagation only. Return true if a
+   /// clause implied by the formula has been found, outCls is then a subset
+   /// of cls (empty if the formula is UNSAT).
+   virtual bool vivifyClause(const vector<int> & cls, vector<int> & outCls)
+   {
+      return false;
+   }
+
 
    /// Constructor.
    SolverInterface(int solverId, SolverType solverType)
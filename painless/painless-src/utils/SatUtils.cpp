@@ -56,8 +56,7 @@ void printModel(vector<int> & model)
 }
 
 
-bool loadFormulaToSolvers(vector<SolverInterface*> solvers,
-                          const char* filename)
+bool parseFormula(const char* filename, vector<ClauseExchange *> & clauses)
 {
 	FILE* f = fopen(filename, "r");
 
@@ -67,8 +66,6 @@ bool loadFormulaToSolvers(vector<SolverInterface*> solvers,
 	int c    = 0;
 	bool neg = false;
 
-	vector<ClauseExchange *> clauses;
-
 	vector<int> cls;
 
 	while (c != EOF) {
@@ -119,8 +116,6 @@ bool loadFormulaToSolvers(vector<SolverInterface*> solvers,
 				   ncls->lits[i] = cls[i];
 				}
 
-				ClauseManager::increaseClause(ncls, solvers.size());
-
 				clauses.push_back(ncls);
 
 				cls.clear();
@@ -130,6 +125,22 @@ bool loadFormulaToSolvers(vector<SolverInterface*> solvers,
 
 	fclose(f);
 
+	return true;
+}
+
+
+bool loadFormulaToSolvers(vector<SolverInterface*> solvers,
+                          const char* filename)
+{
+	vector<ClauseExchange *> clauses;
+
+	if (parseFormula(filename, clauses) == false)
+		return false;
+
+	for (size_t i = 0; i < clauses.size(); i++) {
+		ClauseManager::increaseClause(clauses[i], solvers.size());
+	}
+
 	for (size_t i = 0; i < solvers.size(); i++) {
 		solvers[i]->addInitialClauses(clauses);
 	}
@@ -24,6 +24,9 @@
 /// Print the model correctly in stdout.
 void printModel(vector<int> & model);
 
+/// Parse the cnf contained in the file, the clauses have one reference.
+bool parseFormula(const char* filename, vector<ClauseExchange *> & clauses);
+
 /// Load the cnf contains in the file to the solver.
 bool loadFormulaToSolvers(vector<SolverInterface*> solvers,
                           const char* filename);
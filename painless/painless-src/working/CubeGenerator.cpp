@@ -0,0 +1,208 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#include "../clauses/ClauseManager.h"
+#include "../painless.h"
+#include "../utils/Logger.h"
+#include "../utils/Parameters.h"
+#include "../utils/SatUtils.h"
+#include "../working/CubeGenerator.h"
+
+using namespace std;
+
+// Main executed by the generator threads
+void * mainCubeGenerator(void * arg)
+{
+   CubeGenerator * gen = (CubeGenerator *)arg;
+
+   // Each thread works on its own copy of the formula
+   Lookahead engine = gen->formula;
+
+   CubeGenerator::Node node;
+
+   while (gen->getNode(node)) {
+      gen->expand(engine, node);
+      gen->doneNode();
+   }
+
+   gen->nFailed += engine.nFailed;
+
+   return NULL;
+}
+
+CubeGenerator::CubeGenerator(DivideAndConquer * target_, int nThreads_) :
+   formula(Parameters::getIntParam("cube-cands", 50))
+{
+   target     = target_;
+   nThreads   = nThreads_ > 0 ? nThreads_ : 1;
+   nBusy      = 0;
+   maxDepth   = Parameters::getIntParam("cube-depth", 10);
+   maxRefuted = Parameters::getIntParam("cube-refuted", 1000);
+   nCubes     = 0;
+   nRefuted   = 0;
+   nFailed    = 0;
+
+   pthread_mutex_init(&mutexNodes, NULL);
+   pthread_cond_init (&condNodes, NULL);
+}
+
+CubeGenerator::~CubeGenerator()
+{
+   for (size_t i = 0; i < threads.size(); i++) {
+      threads[i]->join();
+      delete threads[i];
+   }
+
+   pthread_mutex_destroy(&mutexNodes);
+   pthread_cond_destroy (&condNodes);
+}
+
+bool
+CubeGenerator::loadFormula(const char * filename)
+{
+   vector<ClauseExchange *> clauses;
+
+   if (parseFormula(filename, clauses) == false)
+      return false;
+
+   formula.addClauses(clauses);
+
+   for (size_t i = 0; i < clauses.size(); i++) {
+      ClauseManager::releaseClause(clauses[i]);
+   }
+
+   return true;
+}
+
+void
+CubeGenerator::start(const vector<int> & cube)
+{
+   Node root;
+   root.cube  = cube;
+   root.depth = 0;
+
+   pthread_mutex_lock(&mutexNodes);
+   nodes.push_back(root);
+   pthread_mutex_unlock(&mutexNodes);
+
+   for (int i = 0; i < nThreads; i++) {
+      threads.push_back(new Thread(mainCubeGenerator, this));
+   }
+}
+
+bool
+CubeGenerator::getNode(Node & node)
+{
+   pthread_mutex_lock(&mutexNodes);
+
+   // Other threads may still split their node
+   while (nodes.empty() && nBusy > 0 && globalEnding == false) {
+      pthread_cond_wait(&condNodes, &mutexNodes);
+   }
+
+   if (nodes.empty() || globalEnding) {
+      pthread_cond_broadcast(&condNodes);
+      pthread_mutex_unlock(&mutexNodes);
+      return false;
+   }
+
+   node = nodes.back();
+   nodes.pop_back();
+   nBusy++;
+
+   pthread_mutex_unlock(&mutexNodes);
+
+   return true;
+}
+
+void
+CubeGenerator::doneNode()
+{
+   pthread_mutex_lock(&mutexNodes);
+
+   nBusy--;
+
+   bool done = nodes.empty() && nBusy == 0;
+
+   pthread_cond_broadcast(&condNodes);
+   pthread_mutex_unlock(&mutexNodes);
+
+   // Exactly one thread sees the end of the generation
+   if (done) {
+      log(1, "CubeGenerator %lu cubes, %lu refuted nodes\n",
+          (unsigned long)nCubes, (unsigned long)nRefuted);
+      target->endCubes();
+   }
+}
+
+void
+CubeGenerator::expand(Lookahead & engine, const Node & node)
+{
+   if (engine.assume(node.cube) == false) {
+      nRefuted++;
+      return;
+   }
+
+   if (node.depth >= maxDepth || (maxRefuted > 0 && nRefuted >= maxRefuted)) {
+      nCubes++;
+      target->addCube(node.cube);
+      return;
+   }
+
+   int var = engine.lookahead();
+
+   if (var < 0) {
+      nRefuted++;
+      return;
+   }
+
+   // The failed literals are implied by the cube, they help the solvers
+   vector<int> cube = node.cube;
+   cube.insert(cube.end(), engine.implied.begin(), engine.implied.end());
+
+   if (var == 0) {
+      nCubes++;
+      target->addCube(cube);
+      return;
+   }
+
+   Node left, right;
+
+   left.cube   = cube;
+   left.depth  = node.depth + 1;
+   right.cube  = cube;
+   right.depth = node.depth + 1;
+
+   left.cube.push_back(-var);
+   right.cube.push_back(var);
+
+   pthread_mutex_lock(&mutexNodes);
+   nodes.push_back(left);
+   nodes.push_back(right);
+   pthread_cond_broadcast(&condNodes);
+   pthread_mutex_unlock(&mutexNodes);
+}
+
+void
+CubeGenerator::printStats()
+{
+   printf("c CubeGenerator cubes %lu, refuted nodes %lu, failed literals %lu\n",
+          (unsigned long)nCubes, (unsigned long)nRefuted,
+          (unsigned long)nFailed);
+}
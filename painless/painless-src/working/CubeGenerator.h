@@ -0,0 +1,115 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "../solvers/Lookahead.h"
+#include "../utils/Threading.h"
+#include "../working/DivideAndConquer.h"
+
+#include <atomic>
+#include <vector>
+
+using namespace std;
+
+// Main executed by the generator threads
+static void * mainCubeGenerator(void * arg);
+
+/// Front-end of cube and conquer: lookahead threads split the formula in
+/// cubes that are solved by the slaves of a divide and conquer strategy. A
+/// node is not split anymore when its depth reaches the cutoff, or when too
+/// many nodes have been refuted by the lookahead.
+class CubeGenerator
+{
+public:
+   /// Constructor.
+   CubeGenerator(DivideAndConquer * target, int nThreads);
+
+   /// Destructor.
+   ~CubeGenerator();
+
+   /// Load the formula of a cnf file, return false if it can not be read.
+   bool loadFormula(const char * filename);
+
+   /// Start generating the cubes of a root cube.
+   void start(const vector<int> & cube);
+
+   /// Print the statistics of the generator.
+   void printStats();
+
+protected:
+   friend void * mainCubeGenerator(void * arg);
+
+   /// Node of the search tree.
+   struct Node
+   {
+      /// Cube of the node.
+      vector<int> cube;
+
+      /// Number of decisions from the root.
+      int depth;
+   };
+
+   /// Get a node to expand, wait while other threads may create some.
+   /// Return false when the tree is fully expanded.
+   bool getNode(Node & node);
+
+   /// Expand a node with a lookahead engine.
+   void expand(Lookahead & engine, const Node & node);
+
+   /// The thread is done with its node.
+   void doneNode();
+
+   /// Strategy receiving the cubes.
+   DivideAndConquer * target;
+
+   /// Lookahead engine loaded with the formula, copied by each thread.
+   Lookahead formula;
+
+   /// Nodes to expand, the last one first.
+   vector<Node> nodes;
+
+   /// Number of threads expanding a node.
+   int nBusy;
+
+   /// Number of threads.
+   int nThreads;
+
+   /// Maximum depth of a cube.
+   int maxDepth;
+
+   /// Maximum number of refuted nodes before the splitting stops.
+   int maxRefuted;
+
+   /// Mutex and condition protecting the nodes.
+   pthread_mutex_t mutexNodes;
+   pthread_cond_t  condNodes;
+
+   /// Generator threads.
+   vector<Thread *> threads;
+
+   /// Number of cubes given to the target.
+   atomic<unsigned long> nCubes;
+
+   /// Number of nodes refuted by the lookahead.
+   atomic<unsigned long> nRefuted;
+
+   /// Number of failed literals.
+   atomic<unsigned long> nFailed;
+};
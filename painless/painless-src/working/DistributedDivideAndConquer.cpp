@@ -0,0 +1,432 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#ifdef USE_MPI
+
+#include "../utils/Logger.h"
+#include "../utils/Parameters.h"
+#include "../utils/System.h"
+#include "../working/DistributedDivideAndConquer.h"
+
+using namespace std;
+
+// Kinds of messages, the tag 0 is used to gather the result
+enum MessageTag
+{
+   STEAL_TAG   = 1,  // A process without job asks for one
+   CUBE_TAG    = 2,  // Answer to a steal: id and literals of a cube
+   NOCUBE_TAG  = 3,  // Answer to a steal: no cube to give
+   REFUTED_TAG = 4   // Id of a refuted cube, sent back to its owner
+};
+
+RemoteSlave::RemoteSlave(DistributedDivideAndConquer * owner, int rank)
+{
+   this->owner = owner;
+   this->rank  = rank;
+
+   lentId = -1;
+}
+
+void
+RemoteSlave::solve(const vector<int> & cube)
+{
+   owner->lend(rank, cube);
+}
+
+void
+RemoteSlave::join(WorkingStrategy * strat, SatResult res,
+                  const vector<int> & model)
+{
+}
+
+void
+RemoteSlave::refuted(int id)
+{
+   if (id != lentId)
+      return;
+
+   lentId = -1;
+
+   // The cube itself is a valid final analysis
+   parent->join(this, UNSAT, lentCube);
+}
+
+void
+RemoteSlave::setInterrupt()
+{
+}
+
+void
+RemoteSlave::unsetInterrupt()
+{
+}
+
+void
+RemoteSlave::waitInterrupt()
+{
+}
+
+int
+RemoteSlave::getDivisionVariable()
+{
+   return 0;
+}
+
+void
+RemoteSlave::setPhase(const int var, const bool value)
+{
+}
+
+void
+RemoteSlave::bumpVariableActivity(const int var, const int times)
+{
+}
+
+DistributedDivideAndConquer::DistributedDivideAndConquer(DivideAndConquer * dc,
+                                                         int rank, int nProcs)
+{
+   this->dc     = dc;
+   this->rank   = rank;
+   this->nProcs = nProcs;
+
+   addSlave(dc);
+
+   remotes.resize(nProcs, NULL);
+   requested.resize(nProcs, false);
+
+   for (int p = 0; p < nProcs; p++) {
+      if (p != rank) {
+         remotes[p] = new RemoteSlave(this, p);
+         dc->addRemoteSlave(remotes[p]);
+      }
+   }
+
+   started       = false;
+   working       = false;
+   jobDone       = false;
+   jobOwner      = -1;
+   jobId         = 0;
+   lastId        = 0;
+   waitingAnswer = false;
+   nextVictim    = rank;
+   nRefusals     = 0;
+   nextSteal     = 0;
+   nJobs         = 0;
+   nLent         = 0;
+   nSteals       = 0;
+   nRefused      = 0;
+}
+
+DistributedDivideAndConquer::~DistributedDivideAndConquer()
+{
+   // The remote slaves are deleted with the local divide and conquer
+   delete dc;
+}
+
+void
+DistributedDivideAndConquer::solve(const vector<int> & cube)
+{
+   // The process 0 owns the whole formula, the others steal from it
+   if (rank == 0) {
+      startJob(-1, 0, cube);
+   }
+
+   started = true;
+}
+
+void
+DistributedDivideAndConquer::join(WorkingStrategy * strat, SatResult res,
+                                  const vector<int> & model)
+{
+   if (globalEnding)
+      return;
+
+   // A model, an empty final analysis or the refutation of the whole
+   // formula ends the search
+   if (res == SAT || model.empty() || jobOwner < 0) {
+      parent->join(this, res, model);
+      return;
+   }
+
+   jobDone = true;
+}
+
+void
+DistributedDivideAndConquer::startJob(int owner, int id,
+                                      const vector<int> & cube)
+{
+   // The slaves may still be stopping from the last job
+   dc->waitInterrupt();
+
+   jobOwner = owner;
+   jobId    = id;
+   working  = true;
+
+   nJobs++;
+
+   log(2, "DistributedDivideAndConquer process %d starts a cube of size %zu "
+       "from %d\n", rank, cube.size(), owner);
+
+   dc->solve(cube);
+}
+
+void
+DistributedDivideAndConquer::endJob()
+{
+   working = false;
+
+   post(jobOwner, REFUTED_TAG, vector<int>(1, jobId));
+
+   // The pending requests cannot be served anymore
+   outLock.lock();
+
+   vector<int> refused;
+
+   for (int p = 0; p < nProcs; p++) {
+      if (requested[p]) {
+         requested[p] = false;
+         refused.push_back(p);
+      }
+   }
+
+   outLock.unlock();
+
+   for (size_t i = 0; i < refused.size(); i++) {
+      post(refused[i], NOCUBE_TAG, vector<int>());
+   }
+
+   nRefusals = 0;
+   nextSteal = 0;
+}
+
+void
+DistributedDivideAndConquer::lend(int rank, const vector<int> & cube)
+{
+   vector<int> data;
+
+   outLock.lock();
+
+   RemoteSlave * remote = remotes[rank];
+
+   remote->lentId   = ++lastId;
+   remote->lentCube = cube;
+   requested[rank]  = false;
+
+   data.push_back(remote->lentId);
+   data.insert(data.end(), cube.begin(), cube.end());
+
+   nLent++;
+
+   outLock.unlock();
+
+   post(rank, CUBE_TAG, data);
+}
+
+void
+DistributedDivideAndConquer::post(int dest, int tag, const vector<int> & data)
+{
+   Message msg;
+   msg.dest = dest;
+   msg.tag  = tag;
+   msg.data = data;
+
+   outLock.lock();
+   outbox.push_back(msg);
+   outLock.unlock();
+}
+
+void
+DistributedDivideAndConquer::communicate()
+{
+   if (started == false)
+      return;
+
+   if (jobDone.exchange(false)) {
+      endJob();
+   }
+
+   // The sends never block, a blocking one could wait for a process busy in
+   // a round of the bridge
+   vector<Message> toSend;
+
+   outLock.lock();
+   toSend.swap(outbox);
+   outLock.unlock();
+
+   for (size_t i = 0; i < toSend.size(); i++) {
+      sending.push_back(toSend[i]);
+
+      Message & msg = sending.back();
+
+      MPI_Isend(msg.data.data(), msg.data.size(), MPI_INT, msg.dest, msg.tag,
+                MPI_COMM_WORLD, &msg.request);
+   }
+
+   for (list<Message>::iterator it = sending.begin(); it != sending.end();) {
+      int done;
+
+      MPI_Test(&it->request, &done, MPI_STATUS_IGNORE);
+
+      if (done) {
+         it = sending.erase(it);
+      } else {
+         it++;
+      }
+   }
+
+   // Receive the messages of the work, the tag 0 is left to the result
+   vector<int> data;
+
+   while (true) {
+      int flag;
+      MPI_Status status;
+
+      MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, MPI_COMM_WORLD, &flag, &status);
+
+      if (flag == 0 || status.MPI_TAG == 0)
+         break;
+
+      int count;
+      MPI_Get_count(&status, MPI_INT, &count);
+
+      data.resize(count);
+
+      MPI_Recv(data.data(), count, MPI_INT, status.MPI_SOURCE, status.MPI_TAG,
+               MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+      handle(status.MPI_SOURCE, status.MPI_TAG, data);
+   }
+
+   // Without job, steal from the other processes in turn
+   if (working || waitingAnswer || nProcs < 2 || globalEnding ||
+       getRelativeTime() < nextSteal)
+      return;
+
+   nextVictim = (nextVictim + 1) % nProcs;
+   if (nextVictim == rank) {
+      nextVictim = (nextVictim + 1) % nProcs;
+   }
+
+   waitingAnswer = true;
+   nSteals++;
+
+   post(nextVictim, STEAL_TAG, vector<int>());
+}
+
+void
+DistributedDivideAndConquer::handle(int source, int tag,
+                                    const vector<int> & data)
+{
+   switch (tag) {
+   case STEAL_TAG:
+      if (working) {
+         outLock.lock();
+         requested[source] = true;
+         outLock.unlock();
+
+         dc->requestWork(remotes[source]);
+      } else {
+         post(source, NOCUBE_TAG, vector<int>());
+      }
+      break;
+   case CUBE_TAG:
+      waitingAnswer = false;
+
+      startJob(source, data[0], vector<int>(data.begin() + 1, data.end()));
+      break;
+   case NOCUBE_TAG:
+      waitingAnswer = false;
+
+      nRefused++;
+
+      // Every process has refused, wait before the next turn
+      if (++nRefusals >= nProcs - 1) {
+         nRefusals = 0;
+         nextSteal = getRelativeTime() +
+                     Parameters::getIntParam("dc-balance", 100000) / 1000000.0;
+      }
+      break;
+   case REFUTED_TAG:
+      remotes[source]->refuted(data[0]);
+      break;
+   default:
+      break;
+   }
+}
+
+void
+DistributedDivideAndConquer::finish()
+{
+   for (list<Message>::iterator it = sending.begin(); it != sending.end();
+        it++) {
+      MPI_Request_free(&it->request);
+   }
+
+   sending.clear();
+}
+
+void
+DistributedDivideAndConquer::setInterrupt()
+{
+   dc->setInterrupt();
+}
+
+void
+DistributedDivideAndConquer::unsetInterrupt()
+{
+   dc->unsetInterrupt();
+}
+
+void
+DistributedDivideAndConquer::waitInterrupt()
+{
+   dc->waitInterrupt();
+}
+
+int
+DistributedDivideAndConquer::getDivisionVariable()
+{
+   return dc->getDivisionVariable();
+}
+
+void
+DistributedDivideAndConquer::setPhase(const int var, const bool value)
+{
+   dc->setPhase(var, value);
+}
+
+void
+DistributedDivideAndConquer::bumpVariableActivity(const int var,
+                                                  const int times)
+{
+   dc->bumpVariableActivity(var, times);
+}
+
+void
+DistributedDivideAndConquer::printStats()
+{
+   printf("c DistributedDivideAndConquer process %d jobs %lu, lent cubes %lu, "
+          "steals %lu, refused steals %lu\n", rank, nJobs, nLent, nSteals,
+          nRefused);
+
+   dc->printStats();
+}
+
+#endif
@@ -0,0 +1,227 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#pragma once
+
+#ifdef USE_MPI
+
+#include "../utils/Threading.h"
+#include "../working/DivideAndConquer.h"
+#include "../working/WorkingStrategy.h"
+
+#include <list>
+#include <mpi.h>
+#include <vector>
+
+using namespace std;
+
+class DistributedDivideAndConquer;
+
+/// Slave of the local divide and conquer standing for another process. The
+/// cube it steals is sent to the process, the refutation sent back by the
+/// process is joined as the result of the cube.
+class RemoteSlave : public WorkingStrategy
+{
+public:
+   RemoteSlave(DistributedDivideAndConquer * owner, int rank);
+
+   /// Send the cube to the process.
+   void solve(const vector<int> & cube);
+
+   void join(WorkingStrategy * strat, SatResult res,
+             const vector<int> & model);
+
+   /// The process has refuted the cube of a given id.
+   void refuted(int id);
+
+   void setInterrupt();
+
+   void unsetInterrupt();
+
+   void waitInterrupt();
+
+   int getDivisionVariable();
+
+   void setPhase(const int var, const bool value);
+
+   void bumpVariableActivity(const int var, const int times);
+
+protected:
+   friend class DistributedDivideAndConquer;
+
+   /// Strategy owning the slave.
+   DistributedDivideAndConquer * owner;
+
+   /// Rank of the process.
+   int rank;
+
+   /// Id of the cube given to the process.
+   int lentId;
+
+   /// Cube given to the process.
+   vector<int> lentCube;
+};
+
+/// Divide and conquer split between the processes of an MPI run. Each
+/// process solves one job at a time, a cube, with its local divide and
+/// conquer. The process 0 starts with the whole formula. A process without
+/// job steals one from the others, in turn: the local divide and conquer of
+/// the victim splits one of its cubes for the remote slave of the thief.
+/// Once the job of a process is refuted, the process reports it to the owner
+/// of the cube and steals again. The refutation of the job of the process 0
+/// refutes the formula. The messages are handled by the thread of the
+/// bridge, between its rounds.
+class DistributedDivideAndConquer : public WorkingStrategy
+{
+public:
+   /// Constructor, the local divide and conquer gets a remote slave for
+   /// each other process.
+   DistributedDivideAndConquer(DivideAndConquer * dc, int rank, int nProcs);
+
+   ~DistributedDivideAndConquer();
+
+   void solve(const vector<int> & cube);
+
+   void join(WorkingStrategy * strat, SatResult res,
+             const vector<int> & model);
+
+   void setInterrupt();
+
+   void unsetInterrupt();
+
+   void waitInterrupt();
+
+   int getDivisionVariable();
+
+   void setPhase(const int var, const bool value);
+
+   void bumpVariableActivity(const int var, const int times);
+
+   /// Send and receive the messages, called by the thread of the bridge.
+   void communicate();
+
+   /// Free the messages not sent yet, at the end of the search.
+   void finish();
+
+   /// Print the statistics of the strategy.
+   void printStats();
+
+protected:
+   friend class RemoteSlave;
+
+   /// Message between the processes.
+   struct Message
+   {
+      /// Rank of the destination.
+      int dest;
+
+      /// Kind of message.
+      int tag;
+
+      /// Content of the message.
+      vector<int> data;
+
+      /// Request of the send.
+      MPI_Request request;
+   };
+
+   /// Queue a message, it is sent by the next communicate.
+   void post(int dest, int tag, const vector<int> & data);
+
+   /// Give a cube to a remote slave.
+   void lend(int rank, const vector<int> & cube);
+
+   /// Handle a received message.
+   void handle(int source, int tag, const vector<int> & data);
+
+   /// Start a job given by its owner, -1 for the whole formula.
+   void startJob(int owner, int id, const vector<int> & cube);
+
+   /// Report the refuted job to its owner.
+   void endJob();
+
+   /// Local divide and conquer.
+   DivideAndConquer * dc;
+
+   /// Rank of the process.
+   int rank;
+
+   /// Number of processes.
+   int nProcs;
+
+   /// Remote slave of each other process.
+   vector<RemoteSlave *> remotes;
+
+   /// Has the search started.
+   atomic<bool> started;
+
+   /// Is the process solving a job.
+   atomic<bool> working;
+
+   /// The job has been refuted, not reported yet.
+   atomic<bool> jobDone;
+
+   /// Owner of the job, -1 for the whole formula.
+   int jobOwner;
+
+   /// Id of the job given by its owner.
+   int jobId;
+
+   /// Id of the last cube given to a remote slave.
+   int lastId;
+
+   /// Processes whose request of work is pending.
+   vector<bool> requested;
+
+   /// Is the process waiting for the answer of a victim.
+   bool waitingAnswer;
+
+   /// Next victim of a steal.
+   int nextVictim;
+
+   /// Number of refusals since the last job.
+   int nRefusals;
+
+   /// Time before which the process does not steal.
+   double nextSteal;
+
+   /// Messages to send.
+   vector<Message> outbox;
+
+   /// Messages being sent.
+   list<Message> sending;
+
+   /// Mutex protecting the outbox and the requests.
+   Mutex outLock;
+
+   /// Number of jobs received.
+   unsigned long nJobs;
+
+   /// Number of cubes given to the other processes.
+   unsigned long nLent;
+
+   /// Number of steal requests sent.
+   unsigned long nSteals;
+
+   /// Number of steal requests refused.
+   unsigned long nRefused;
+};
+
+#endif
@@ -0,0 +1,505 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#include "../painless.h"
+#include "../utils/Logger.h"
+#include "../utils/Parameters.h"
+#include "../working/DivideAndConquer.h"
+
+#include <stdlib.h>
+#include <sys/time.h>
+
+using namespace std;
+
+// Main executed by the thread balancing the work
+void * mainDivideAndConquer(void * arg)
+{
+   DivideAndConquer * dc = (DivideAndConquer *)arg;
+
+   int period = Parameters::getIntParam("dc-balance", 100000);
+
+   while (dc->stopBalancer == false && globalEnding == false) {
+      pthread_mutex_lock(&dc->mutexBalance);
+
+      struct timeval now;
+      struct timespec deadline;
+
+      gettimeofday(&now, NULL);
+
+      long usec        = now.tv_usec + period;
+      deadline.tv_sec  = now.tv_sec + usec / 1000000;
+      deadline.tv_nsec = (usec % 1000000) * 1000;
+
+      pthread_cond_timedwait(&dc->condBalance, &dc->mutexBalance, &deadline);
+
+      pthread_mutex_unlock(&dc->mutexBalance);
+
+      if (dc->strategyEnding == false) {
+         dc->balance();
+      }
+   }
+
+   return NULL;
+}
+
+DivideAndConquer::DivideAndConquer()
+{
+   openCubes      = 0;
+   nSplits        = 0;
+   nRefuted       = 0;
+   nGenerated     = 0;
+   waitCubes      = false;
+   stopBalancer   = false;
+   strategyEnding = false;
+   balancer       = NULL;
+
+   pthread_mutex_init(&mutexBalance, NULL);
+   pthread_cond_init (&condBalance, NULL);
+}
+
+DivideAndConquer::~DivideAndConquer()
+{
+   if (balancer != NULL) {
+      pthread_mutex_lock  (&mutexBalance);
+      stopBalancer = true;
+      pthread_cond_signal (&condBalance);
+      pthread_mutex_unlock(&mutexBalance);
+
+      balancer->join();
+      delete balancer;
+   }
+
+   for (size_t i = 0; i < slaves.size(); i++) {
+      delete slaves[i];
+   }
+
+   pthread_mutex_destroy(&mutexBalance);
+   pthread_cond_destroy (&condBalance);
+}
+
+void
+DivideAndConquer::addSlave(WorkingStrategy * slave)
+{
+   SlaveState state;
+   state.busy   = false;
+   state.thief  = -1;
+   state.victim = -1;
+   state.remote = false;
+   state.wanted = false;
+
+   // Slaves may be added while the strategy is running
+   stateLock.lock();
+   WorkingStrategy::addSlave(slave);
+   states.push_back(state);
+   stateLock.unlock();
+
+   pthread_mutex_lock  (&mutexBalance);
+   pthread_cond_signal (&condBalance);
+   pthread_mutex_unlock(&mutexBalance);
+}
+
+void
+DivideAndConquer::addRemoteSlave(WorkingStrategy * slave)
+{
+   addSlave(slave);
+
+   stateLock.lock();
+   states.back().remote = true;
+   stateLock.unlock();
+}
+
+void
+DivideAndConquer::requestWork(WorkingStrategy * slave)
+{
+   stateLock.lock();
+
+   int id = slaveIndex(slave);
+   if (id >= 0) {
+      states[id].wanted = true;
+   }
+
+   stateLock.unlock();
+
+   pthread_mutex_lock  (&mutexBalance);
+   pthread_cond_signal (&condBalance);
+   pthread_mutex_unlock(&mutexBalance);
+}
+
+int
+DivideAndConquer::slaveIndex(WorkingStrategy * slave)
+{
+   for (size_t i = 0; i < slaves.size(); i++) {
+      if (slaves[i] == slave)
+         return i;
+   }
+
+   return -1;
+}
+
+void
+DivideAndConquer::solve(const vector<int> & cube)
+{
+   strategyEnding = false;
+
+   stateLock.lock();
+
+   if (slaves.empty()) {
+      stateLock.unlock();
+      return;
+   }
+
+   WorkingStrategy * first = slaves[0];
+
+   for (size_t i = 0; i < states.size(); i++) {
+      states[i].busy   = false;
+      states[i].thief  = -1;
+      states[i].victim = -1;
+      states[i].wanted = false;
+   }
+
+   rootCube = cube;
+   pendingCubes.clear();
+
+   // The generator holds the root cube until it has given all its cubes
+   openCubes = 1;
+
+   if (waitCubes == false) {
+      // The first slave starts with the whole cube, the others steal
+      states[0].cube  = cube;
+      states[0].busy  = true;
+   }
+
+   stateLock.unlock();
+
+   if (waitCubes == false) {
+      first->solve(cube);
+   }
+
+   if (balancer == NULL) {
+      balancer = new Thread(mainDivideAndConquer, this);
+   }
+}
+
+void
+DivideAndConquer::expectCubes()
+{
+   waitCubes = true;
+}
+
+void
+DivideAndConquer::addCube(const vector<int> & cube)
+{
+   stateLock.lock();
+   pendingCubes.push_back(cube);
+   openCubes++;
+   nGenerated++;
+   stateLock.unlock();
+
+   pthread_mutex_lock  (&mutexBalance);
+   pthread_cond_signal (&condBalance);
+   pthread_mutex_unlock(&mutexBalance);
+}
+
+void
+DivideAndConquer::endCubes()
+{
+   stateLock.lock();
+   int open = --openCubes;
+   stateLock.unlock();
+
+   log(1, "DivideAndConquer generator gave %lu cubes\n", nGenerated);
+
+   if (open == 0) {
+      end(UNSAT, rootCube);
+   }
+}
+
+void
+DivideAndConquer::join(WorkingStrategy * strat, SatResult res,
+                       const vector<int> & model)
+{
+   if (strategyEnding || globalEnding)
+      return;
+
+   if (res == SAT) {
+      end(SAT, model);
+      return;
+   }
+
+   stateLock.lock();
+
+   int id = slaveIndex(strat);
+   if (id < 0) {
+      stateLock.unlock();
+      return;
+   }
+
+   SlaveState & state = states[id];
+
+   // Result of a job given before the slave joined the strategy
+   if (state.busy == false) {
+      stateLock.unlock();
+
+      if (res == UNSAT && model.empty())
+         end(UNSAT, model);
+
+      return;
+   }
+
+   state.busy = false;
+
+   int thief   = state.thief;
+   state.thief = -1;
+
+   if (thief >= 0) {
+      states[thief].victim = -1;
+   }
+
+   if (res == UNSAT) {
+      openCubes--;
+      nRefuted++;
+
+      log(2, "DivideAndConquer cube of size %zu refuted, %d open cubes\n",
+          state.cube.size(), openCubes);
+
+      // An empty final analysis refutes the formula itself
+      if (model.empty() || openCubes == 0) {
+         stateLock.unlock();
+         end(UNSAT, model);
+         return;
+      }
+
+      stateLock.unlock();
+   } else {
+      // Interrupted to be split, or spuriously: the cube is still open
+      vector<int> cube = state.cube;
+      int var          = 0;
+
+      if (thief >= 0) {
+         for (int tries = 0; tries < 10; tries++) {
+            int candidate = strat->getDivisionVariable();
+            bool inCube   = false;
+
+            for (size_t i = 0; i < cube.size(); i++) {
+               if (abs(cube[i]) == candidate)
+                  inCube = true;
+            }
+
+            if (candidate > 0 && inCube == false) {
+               var = candidate;
+               break;
+            }
+         }
+      }
+
+      if (var == 0) {
+         state.busy = true;
+         stateLock.unlock();
+
+         strat->solve(cube);
+      } else {
+         vector<int> thiefCube = cube;
+
+         cube.push_back(var);
+         thiefCube.push_back(-var);
+
+         openCubes++;
+         nSplits++;
+
+         state.cube          = cube;
+         state.busy          = true;
+         states[thief].cube   = thiefCube;
+         states[thief].busy   = true;
+         states[thief].wanted = false;
+
+         WorkingStrategy * thiefSlave = slaves[thief];
+
+         stateLock.unlock();
+
+         log(2, "DivideAndConquer split on %d, %d open cubes\n", var,
+             openCubes);
+
+         strat->solve(cube);
+         thiefSlave->solve(thiefCube);
+      }
+   }
+
+   // Some slaves may be idle
+   pthread_mutex_lock  (&mutexBalance);
+   pthread_cond_signal (&condBalance);
+   pthread_mutex_unlock(&mutexBalance);
+}
+
+void
+DivideAndConquer::balance()
+{
+   vector<WorkingStrategy *> victims;
+   vector<WorkingStrategy *> startSlaves;
+   vector<vector<int> > startCubes;
+
+   stateLock.lock();
+
+   for (size_t i = 0; i < states.size(); i++) {
+      if (states[i].busy || states[i].victim >= 0)
+         continue;
+
+      if (states[i].remote && states[i].wanted == false)
+         continue;
+
+      // The cubes of the generator come first
+      if (pendingCubes.empty() == false) {
+         states[i].cube   = pendingCubes.front();
+         states[i].busy   = true;
+         states[i].wanted = false;
+         pendingCubes.pop_front();
+         startSlaves.push_back(slaves[i]);
+         startCubes.push_back(states[i].cube);
+         continue;
+      }
+
+      // Steal from the busy slave with the shortest cube, the largest space
+      int victim = -1;
+
+      for (size_t j = 0; j < states.size(); j++) {
+         if (states[j].busy == false || states[j].thief >= 0 ||
+             states[j].remote)
+            continue;
+
+         if (victim < 0 || states[j].cube.size() < states[victim].cube.size())
+            victim = j;
+      }
+
+      if (victim < 0)
+         break;
+
+      states[victim].thief = i;
+      states[i].victim     = victim;
+   }
+
+   // Interrupt again the victims that did not answer yet
+   for (size_t i = 0; i < states.size(); i++) {
+      if (states[i].busy && states[i].thief >= 0)
+         victims.push_back(slaves[i]);
+   }
+
+   stateLock.unlock();
+
+   for (size_t i = 0; i < startSlaves.size(); i++) {
+      startSlaves[i]->solve(startCubes[i]);
+   }
+
+   for (size_t i = 0; i < victims.size(); i++) {
+      victims[i]->setInterrupt();
+   }
+}
+
+void
+DivideAndConquer::end(SatResult res, const vector<int> & model)
+{
+   if (strategyEnding.exchange(true))
+      return;
+
+   setInterrupt();
+
+   if (parent == NULL) { // If it is the top strategy
+      setFinalResult(res, model);
+   } else { // Else forward the information to the parent strategy
+      parent->join(this, res, model);
+   }
+}
+
+void
+DivideAndConquer::setInterrupt()
+{
+   strategyEnding = true;
+
+   slavesLock.lock();
+
+   for (size_t i = 0; i < slaves.size(); i++) {
+      slaves[i]->setInterrupt();
+   }
+
+   slavesLock.unlock();
+}
+
+void
+DivideAndConquer::unsetInterrupt()
+{
+   slavesLock.lock();
+
+   for (size_t i = 0; i < slaves.size(); i++) {
+      slaves[i]->unsetInterrupt();
+   }
+
+   slavesLock.unlock();
+}
+
+void
+DivideAndConquer::waitInterrupt()
+{
+   slavesLock.lock();
+
+   for (size_t i = 0; i < slaves.size(); i++) {
+      slaves[i]->waitInterrupt();
+   }
+
+   slavesLock.unlock();
+}
+
+int
+DivideAndConquer::getDivisionVariable()
+{
+   slavesLock.lock();
+   int var = slaves.empty() ? 0 : slaves[0]->getDivisionVariable();
+   slavesLock.unlock();
+
+   return var;
+}
+
+void
+DivideAndConquer::setPhase(const int var, const bool value)
+{
+   slavesLock.lock();
+
+   for (size_t i = 0; i < slaves.size(); i++) {
+      slaves[i]->setPhase(var, value);
+   }
+
+   slavesLock.unlock();
+}
+
+void
+DivideAndConquer::bumpVariableActivity(const int var, const int times)
+{
+   slavesLock.lock();
+
+   for (size_t i = 0; i < slaves.size(); i++) {
+      slaves[i]->bumpVariableActivity(var, times);
+   }
+
+   slavesLock.unlock();
+}
+
+void
+DivideAndConquer::printStats()
+{
+   printf("c DivideAndConquer splits %lu, refuted cubes %lu, open cubes %d, "
+          "generated cubes %lu\n", nSplits, nRefuted, openCubes, nGenerated);
+}
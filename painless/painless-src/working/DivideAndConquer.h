@@ -0,0 +1,155 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "../utils/Threading.h"
+#include "../working/WorkingStrategy.h"
+
+#include <deque>
+#include <vector>
+
+using namespace std;
+
+// Main executed by the thread balancing the work
+static void * mainDivideAndConquer(void * arg);
+
+/// Divide and conquer strategy: each slave solves a cube, an idle slave
+/// steals work by splitting the cube of a busy slave on a division variable.
+/// The formula is UNSAT when all the cubes are refuted.
+class DivideAndConquer : public WorkingStrategy
+{
+public:
+   DivideAndConquer();
+
+   ~DivideAndConquer();
+
+   void solve(const vector<int> & cube);
+
+   void join(WorkingStrategy * strat, SatResult res,
+             const vector<int> & model);
+
+   void setInterrupt();
+
+   void unsetInterrupt();
+
+   void waitInterrupt();
+
+   int getDivisionVariable();
+
+   void setPhase(const int var, const bool value);
+
+   void bumpVariableActivity(const int var, const int times);
+
+   void addSlave(WorkingStrategy * slave);
+
+   /// Add a slave standing for work given away, e.g. to another process. It
+   /// only steals when it has requested work, and its cube is never split.
+   void addRemoteSlave(WorkingStrategy * slave);
+
+   /// A remote slave requests work, the request is dropped by the next solve.
+   void requestWork(WorkingStrategy * slave);
+
+   /// The next solve waits for cubes given by an external generator instead
+   /// of starting a slave on the whole cube.
+   void expectCubes();
+
+   /// Add a cube given by the generator.
+   void addCube(const vector<int> & cube);
+
+   /// The generator has given all its cubes.
+   void endCubes();
+
+   /// Print the statistics of the strategy.
+   void printStats();
+
+protected:
+   friend void * mainDivideAndConquer(void * arg);
+
+   /// State of a slave.
+   struct SlaveState
+   {
+      /// Cube given to the slave.
+      vector<int> cube;
+
+      /// Is the slave solving its cube.
+      bool busy;
+
+      /// Slave waiting for the split of this one, -1 if none.
+      int thief;
+
+      /// Slave whose split is awaited by this one, -1 if none.
+      int victim;
+
+      /// Is the slave a remote one.
+      bool remote;
+
+      /// Has the remote slave requested work.
+      bool wanted;
+   };
+
+   /// Give work to the idle slaves by interrupting busy ones.
+   void balance();
+
+   /// End the strategy with a given result.
+   void end(SatResult res, const vector<int> & model);
+
+   /// Get the index of a slave.
+   int slaveIndex(WorkingStrategy * slave);
+
+   /// State of the slaves, same order as slaves.
+   vector<SlaveState> states;
+
+   /// Number of cubes that are not refuted, the generator holds one while
+   /// it is running.
+   int openCubes;
+
+   /// Cubes of the generator waiting for an idle slave.
+   deque<vector<int> > pendingCubes;
+
+   /// Is the next solve fed by a generator.
+   bool waitCubes;
+
+   /// Cube given to the last solve.
+   vector<int> rootCube;
+
+   /// Number of cubes given by the generator.
+   unsigned long nGenerated;
+
+   /// Number of splits.
+   unsigned long nSplits;
+
+   /// Number of refuted cubes.
+   unsigned long nRefuted;
+
+   /// Mutex protecting the states.
+   Mutex stateLock;
+
+   /// Mutex and condition used to wake up the balancing thread.
+   pthread_mutex_t mutexBalance;
+   pthread_cond_t  condBalance;
+
+   /// Thread balancing the work.
+   Thread * balancer;
+
+   /// Used to stop the balancing thread.
+   atomic<bool> stopBalancer;
+
+   atomic<bool> strategyEnding;
+};
@@ -0,0 +1,231 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#include "../painless.h"
+#include "../sharing/Sharer.h"
+#include "../solvers/SolverFactory.h"
+#include "../utils/Logger.h"
+#include "../utils/Parameters.h"
+#include "../working/FitnessPortfolio.h"
+
+#include <algorithm>
+#include <unistd.h>
+#include <unordered_map>
+
+using namespace std;
+
+// Main executed by the thread scoring the members
+void * mainFitnessPortfolio(void * arg)
+{
+   FitnessPortfolio * fp = (FitnessPortfolio *)arg;
+
+   int period = Parameters::getIntParam("fit-period", 10000000);
+
+   while (fp->stopMonitor == false && globalEnding == false) {
+      if (waitGlobalEnding(period))
+         break;
+
+      if (fp->stopMonitor || globalEnding || fp->strategyEnding)
+         break;
+
+      fp->score(period / 1000000.0);
+      fp->replace();
+   }
+
+   return NULL;
+}
+
+FitnessPortfolio::FitnessPortfolio()
+{
+   nReplaced   = 0;
+   monitor     = NULL;
+   stopMonitor = false;
+}
+
+FitnessPortfolio::~FitnessPortfolio()
+{
+   if (monitor != NULL) {
+      stopMonitor = true;
+      monitor->join();
+      delete monitor;
+   }
+}
+
+void
+FitnessPortfolio::addWorker(SequentialWorker * worker)
+{
+   Member member;
+   member.worker  = worker;
+   member.fitness  = 0;
+   member.age      = 0;
+   member.lastUsed = 0;
+
+   addSlave(worker);
+   members.push_back(member);
+}
+
+void
+FitnessPortfolio::solve(const vector<int> & cube)
+{
+   rootCube = cube;
+
+   Portfolio::solve(cube);
+
+   if (monitor == NULL) {
+      monitor = new Thread(mainFitnessPortfolio, this);
+   }
+}
+
+void
+FitnessPortfolio::score(double elapsed)
+{
+   int n = members.size();
+
+   // Clauses of each producer used by the members, tracked with shr-feedback
+   vector<ClauseUsage> usage;
+   unordered_map<int, unsigned long> used;
+
+   for (int i = 0; i < n; i++) {
+      members[i].worker->solver->getImportUsage(usage);
+   }
+
+   for (size_t i = 0; i < usage.size(); i++) {
+      used[usage[i].producer] += usage[i].used;
+   }
+
+   // Criteria of each member, the higher the better
+   vector<vector<double> > criteria(5, vector<double>(n));
+
+   for (int i = 0; i < n; i++) {
+      Member & member         = members[i];
+      SolvingStatistics stats = member.worker->solver->getStatistics();
+
+      unsigned long c = stats.conflicts - member.last.conflicts;
+      unsigned long l = stats.lbdSum    - member.last.lbdSum;
+
+      criteria[0][i] = c / elapsed;
+      criteria[1][i] = c > 0 ? -(double)l / c : -1e9;
+      criteria[2][i] = stats.units    - member.last.units;
+      criteria[3][i] = stats.exported - member.last.exported;
+
+      // The counts of a replaced consumer are lost, they never decrease
+      unsigned long u = used[member.worker->solver->id];
+      criteria[4][i]  = u > member.lastUsed ? u - member.lastUsed : 0;
+
+      member.last     = stats;
+      member.lastUsed = u;
+      member.fitness = 0;
+      member.age++;
+   }
+
+   // The fitness is the sum of the ranks on each criterion
+   for (size_t k = 0; k < criteria.size(); k++) {
+      for (int i = 0; i < n; i++) {
+         for (int j = 0; j < n; j++) {
+            if (criteria[k][i] > criteria[k][j])
+               members[i].fitness++;
+         }
+      }
+   }
+}
+
+void
+FitnessPortfolio::replace()
+{
+   if (members.size() < 2)
+      return;
+
+   int best = 0, worst = -1;
+
+   for (size_t i = 0; i < members.size(); i++) {
+      if (members[i].fitness > members[best].fitness)
+         best = i;
+
+      // A new solver has at least two periods to prove itself
+      if (members[i].age >= 2 &&
+          (worst < 0 || members[i].fitness < members[worst].fitness))
+         worst = i;
+   }
+
+   if (worst < 0 || members[worst].fitness >= members[best].fitness)
+      return;
+
+   SequentialWorker * src = members[best].worker;
+   SequentialWorker * dst = members[worst].worker;
+
+   // Clone the best solver while it is stopped, it keeps its learnt clauses
+   src->setInterrupt();
+   src->waitInterrupt();
+
+   SolverInterface * clone = SolverFactory::cloneSolver(src->solver);
+
+   src->solve(rootCube);
+
+   if (clone == NULL || globalEnding)
+      return;
+
+   // Diversify the clone from its model
+   int perturb = Parameters::getIntParam("fit-perturb", 4);
+   int vars    = clone->getVariablesCount();
+
+   // A seed of its own, the global one is used by the other components
+   unsigned int seed = clone->id;
+
+   for (int var = 1; perturb > 0 && var <= vars; var++) {
+      if (rand_r(&seed) % perturb == 0) {
+         clone->setPhase(var, rand_r(&seed) % 2 == 1);
+      }
+   }
+
+   // The worker is idle once its last result has been joined
+   dst->setInterrupt();
+   dst->waitJoin();
+
+   SolverInterface * old = dst->solver;
+
+   // The sharers release the old solver after their current round
+   for (int i = 0; i < nSharers; i++) {
+      sharers[i]->replaceSolver(old, clone);
+   }
+
+   // The loops over the slaves reach the solver of the worker under this
+   // lock, the old solver is not reachable from the strategies anymore
+   slavesLock.lock();
+   dst->solver = clone;
+   slavesLock.unlock();
+
+   log(1, "FitnessPortfolio replaced solver %d by a clone of solver %d\n",
+       old->id, src->solver->id);
+
+   old->release();
+
+   members[worst].last     = clone->getStatistics();
+   members[worst].age      = 0;
+   members[worst].lastUsed = 0;
+
+   nReplaced++;
+
+   dst->solve(rootCube);
+}
+
+void
+FitnessPortfolio::printStats()
+{
+   printf("c FitnessPortfolio replaced solvers %d\n", nReplaced);
+}
@@ -0,0 +1,95 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "../utils/Threading.h"
+#include "../working/Portfolio.h"
+#include "../working/SequentialWorker.h"
+
+#include <vector>
+
+using namespace std;
+
+// Main executed by the thread scoring the members
+static void * mainFitnessPortfolio(void * arg);
+
+/// Portfolio replacing its weakest members. The members are periodically
+/// ranked on their conflict rate, the LBD of their learnt clauses, their
+/// learnt units, their exported clauses and, with shr-feedback, the number
+/// of their clauses used by the other members. The solver of the worst member
+/// is replaced by a clone of the best one, with its learnt clauses and
+/// perturbed phases.
+class FitnessPortfolio : public Portfolio
+{
+public:
+   FitnessPortfolio();
+
+   ~FitnessPortfolio();
+
+   void solve(const vector<int> & cube);
+
+   /// Add a worker to the portfolio.
+   void addWorker(SequentialWorker * worker);
+
+   /// Print the statistics of the strategy.
+   void printStats();
+
+protected:
+   friend void * mainFitnessPortfolio(void * arg);
+
+   /// Progress of a member.
+   struct Member
+   {
+      SequentialWorker * worker;
+
+      /// Statistics at the previous measure.
+      SolvingStatistics last;
+
+      /// Clauses of the member used by the members, at the previous measure.
+      unsigned long lastUsed;
+
+      /// Fitness computed at the last measure, the higher the better.
+      double fitness;
+
+      /// Number of measures since the solver has been created.
+      int age;
+   };
+
+   /// Compute the fitness of the members on the last period.
+   void score(double elapsed);
+
+   /// Replace the solver of the worst member by a clone of the best one.
+   void replace();
+
+   /// Members of the portfolio.
+   vector<Member> members;
+
+   /// Cube given to the last solve.
+   vector<int> rootCube;
+
+   /// Number of replaced solvers.
+   int nReplaced;
+
+   /// Thread scoring the members.
+   Thread * monitor;
+
+   /// Used to stop the scoring thread.
+   atomic<bool> stopMonitor;
+};
@@ -0,0 +1,208 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#include "../painless.h"
+#include "../utils/Logger.h"
+#include "../utils/Parameters.h"
+#include "../working/Hybrid.h"
+
+#include <algorithm>
+#include <unistd.h>
+
+using namespace std;
+
+// Main executed by the thread monitoring the portfolio
+void * mainHybrid(void * arg)
+{
+   Hybrid * hyb = (Hybrid *)arg;
+
+   int period   = Parameters::getIntParam("hyb-period", 2000000);
+   int patience = Parameters::getIntParam("hyb-patience", 3);
+   int step     = Parameters::getIntParam("hyb-step", 2);
+
+   while (hyb->stopMonitor == false && globalEnding == false) {
+      if (waitGlobalEnding(period))
+         break;
+
+      if (hyb->stopMonitor || globalEnding || hyb->strategyEnding)
+         break;
+
+      if (hyb->stagnates(period / 1000000.0)) {
+         hyb->nStagnating++;
+      } else {
+         hyb->nStagnating = 0;
+      }
+
+      if (hyb->nStagnating >= patience) {
+         hyb->moveWorkers(step);
+         hyb->nStagnating = 0;
+      }
+   }
+
+   return NULL;
+}
+
+Hybrid::Hybrid()
+{
+   dc          = NULL;
+   lastLbd     = 0;
+   nStagnating = 0;
+   nMoves      = 0;
+   nMoved      = 0;
+   nWorkers    = 0;
+   monitor     = NULL;
+   stopMonitor = false;
+}
+
+Hybrid::~Hybrid()
+{
+   if (monitor != NULL) {
+      stopMonitor = true;
+      monitor->join();
+      delete monitor;
+   }
+}
+
+void
+Hybrid::addWorker(SequentialWorker * worker)
+{
+   Member member;
+   member.worker = worker;
+   member.lbd    = 0;
+
+   addSlave(worker);
+   members.push_back(member);
+   nWorkers++;
+}
+
+void
+Hybrid::solve(const vector<int> & cube)
+{
+   rootCube = cube;
+
+   Portfolio::solve(cube);
+
+   if (monitor == NULL) {
+      monitor = new Thread(mainHybrid, this);
+   }
+}
+
+bool
+Hybrid::stagnates(double elapsed)
+{
+   unsigned long conflicts = 0, lbdSum = 0, units = 0;
+
+   for (size_t i = 0; i < members.size(); i++) {
+      SolvingStatistics stats = members[i].worker->solver->getStatistics();
+      SolvingStatistics & last = members[i].last;
+
+      unsigned long c = stats.conflicts - last.conflicts;
+      unsigned long l = stats.lbdSum    - last.lbdSum;
+
+      members[i].lbd = c > 0 ? (double)l / c : 0;
+
+      conflicts += c;
+      lbdSum    += l;
+      units     += stats.units - last.units;
+
+      last = stats;
+   }
+
+   if (conflicts == 0)
+      return false;
+
+   double lbd      = (double)lbdSum / conflicts;
+   double unitRate = units * 10000.0 / conflicts;
+
+   log(1, "Hybrid %.0f conflicts/s, average LBD %.2f, %.2f units per 10k "
+       "conflicts\n", conflicts / elapsed, lbd, unitRate);
+
+   // The quality of the learnt clauses does not improve, and the level 0
+   // trail does not grow anymore
+   bool stagnating = lastLbd > 0 && lbd >= lastLbd &&
+                     unitRate < Parameters::getIntParam("hyb-units", 1);
+
+   lastLbd = lbd;
+
+   return stagnating;
+}
+
+void
+Hybrid::moveWorkers(int count)
+{
+   int maxMoved = nWorkers * Parameters::getIntParam("hyb-max", 50) / 100;
+
+   count = min(count, maxMoved - nMoved);
+   count = min(count, (int)members.size() - 1);
+
+   if (count <= 0)
+      return;
+
+   // The members learning the worst clauses move first
+   sort(members.begin(), members.end(),
+        [](const Member & a, const Member & b) { return a.lbd > b.lbd; });
+
+   vector<SequentialWorker *> moved;
+
+   for (int i = 0; i < count; i++) {
+      SequentialWorker * worker = members[i].worker;
+
+      // A result found before the move still reaches the portfolio, the
+      // parent changes once it has been joined
+      removeSlave(worker);
+      worker->setInterrupt();
+      worker->waitJoin();
+
+      moved.push_back(worker);
+   }
+
+   members.erase(members.begin(), members.begin() + count);
+
+   bool first = dc == NULL;
+
+   if (first) {
+      dc = new DivideAndConquer();
+      addSlave(dc);
+   }
+
+   for (size_t i = 0; i < moved.size(); i++) {
+      dc->addSlave(moved[i]);
+   }
+
+   if (first) {
+      dc->solve(rootCube);
+   }
+
+   nMoves++;
+   nMoved += count;
+
+   log(1, "Hybrid moved %d workers to divide and conquer, %d left in the "
+       "portfolio\n", count, (int)members.size());
+}
+
+void
+Hybrid::printStats()
+{
+   printf("c Hybrid moves %d, workers in divide and conquer %d/%d\n", nMoves,
+          nMoved, nWorkers);
+
+   if (dc != NULL) {
+      dc->printStats();
+   }
+}
@@ -0,0 +1,103 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "../utils/Threading.h"
+#include "../working/DivideAndConquer.h"
+#include "../working/Portfolio.h"
+#include "../working/SequentialWorker.h"
+
+#include <vector>
+
+using namespace std;
+
+// Main executed by the thread monitoring the portfolio
+static void * mainHybrid(void * arg);
+
+/// Hybrid strategy: the workers start as a portfolio. When the portfolio
+/// stagnates, i.e. the LBD of the learnt clauses does not decrease and almost
+/// no unit is learnt, some workers are moved to a divide and conquer strategy
+/// working on the same cube.
+class Hybrid : public Portfolio
+{
+public:
+   Hybrid();
+
+   ~Hybrid();
+
+   void solve(const vector<int> & cube);
+
+   /// Add a worker to the portfolio.
+   void addWorker(SequentialWorker * worker);
+
+   /// Print the statistics of the strategy.
+   void printStats();
+
+protected:
+   friend void * mainHybrid(void * arg);
+
+   /// Progress of a portfolio member.
+   struct Member
+   {
+      SequentialWorker * worker;
+
+      /// Statistics at the previous measure.
+      SolvingStatistics last;
+
+      /// Average LBD during the last period.
+      double lbd;
+   };
+
+   /// Measure the progress of the portfolio, return true if it stagnates.
+   bool stagnates(double elapsed);
+
+   /// Move workers from the portfolio to divide and conquer.
+   void moveWorkers(int count);
+
+   /// Members still in the portfolio.
+   vector<Member> members;
+
+   /// Divide and conquer part, NULL until the first move.
+   DivideAndConquer * dc;
+
+   /// Cube given to the last solve.
+   vector<int> rootCube;
+
+   /// Average LBD of the portfolio during the previous period.
+   double lastLbd;
+
+   /// Number of consecutive stagnating periods.
+   int nStagnating;
+
+   /// Number of moves.
+   int nMoves;
+
+   /// Number of workers moved to divide and conquer.
+   int nMoved;
+
+   /// Total number of workers.
+   int nWorkers;
+
+   /// Thread monitoring the portfolio.
+   Thread * monitor;
+
+   /// Used to stop the monitoring thread.
+   atomic<bool> stopMonitor;
+};
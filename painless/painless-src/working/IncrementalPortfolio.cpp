@@ -0,0 +1,108 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#include "../working/IncrementalPortfolio.h"
+
+#include <errno.h>
+#include <time.h>
+
+using namespace std;
+
+IncrementalPortfolio::IncrementalPortfolio()
+{
+   nJoined = 0;
+   result  = UNKNOWN;
+
+   pthread_mutex_init(&mutexResult, NULL);
+   pthread_cond_init (&condResult, NULL);
+}
+
+IncrementalPortfolio::~IncrementalPortfolio()
+{
+   pthread_mutex_destroy(&mutexResult);
+   pthread_cond_destroy (&condResult);
+}
+
+void
+IncrementalPortfolio::solve(const vector<int> & cube)
+{
+   pthread_mutex_lock(&mutexResult);
+   nJoined = 0;
+   result  = UNKNOWN;
+   resultModel.clear();
+   pthread_mutex_unlock(&mutexResult);
+
+   Portfolio::solve(cube);
+}
+
+void
+IncrementalPortfolio::join(WorkingStrategy * strat, SatResult res,
+                           const vector<int> & model)
+{
+   pthread_mutex_lock(&mutexResult);
+
+   // Each worker gives exactly one result per cube, waiting for all of them
+   // ensures that no late result leaks into the next cube
+   nJoined++;
+
+   if (res != UNKNOWN && result == UNKNOWN) {
+      result         = res;
+      resultModel    = model;
+      strategyEnding = true;
+
+      setInterrupt();
+   }
+
+   pthread_cond_signal(&condResult);
+   pthread_mutex_unlock(&mutexResult);
+}
+
+SatResult
+IncrementalPortfolio::waitResult(vector<int> & model, double timeout)
+{
+   struct timespec deadline;
+
+   clock_gettime(CLOCK_REALTIME, &deadline);
+
+   long nsec = deadline.tv_nsec + (long)((timeout - (long)timeout) * 1e9);
+
+   deadline.tv_sec += (long)timeout + nsec / 1000000000;
+   deadline.tv_nsec = nsec % 1000000000;
+
+   pthread_mutex_lock(&mutexResult);
+
+   while (nJoined < slaves.size()) {
+      if (timeout <= 0) {
+         pthread_cond_wait(&condResult, &mutexResult);
+      } else if (pthread_cond_timedwait(&condResult, &mutexResult,
+                                        &deadline) == ETIMEDOUT) {
+         // The workers answer UNKNOWN once interrupted
+         setInterrupt();
+         timeout = 0;
+      }
+   }
+
+   model = resultModel;
+
+   SatResult res = result;
+
+   pthread_mutex_unlock(&mutexResult);
+
+   return res;
+}
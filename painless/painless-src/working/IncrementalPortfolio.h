@@ -0,0 +1,64 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+#pragma once
+
+#include "../working/Portfolio.h"
+
+#include <pthread.h>
+#include <vector>
+
+using namespace std;
+
+/// Portfolio used as the top strategy of an incremental solving. A result
+/// does not end the search globally: the workers are stopped and wait for
+/// the next cube, their solvers keep their learnt clauses.
+class IncrementalPortfolio : public Portfolio
+{
+public:
+   IncrementalPortfolio();
+
+   ~IncrementalPortfolio();
+
+   void solve(const vector<int> & cube);
+
+   void join(WorkingStrategy * strat, SatResult res,
+             const vector<int> & model);
+
+   /// Wait until every worker has given its result for the last cube, return
+   /// the first SAT or UNSAT result, UNKNOWN if interrupted. The workers are
+   /// interrupted after timeout seconds if it is positive.
+   SatResult waitResult(vector<int> & model, double timeout = 0);
+
+protected:
+   /// Protect the result.
+   pthread_mutex_t mutexResult;
+
+   /// Signaled when a worker gives its result.
+   pthread_cond_t condResult;
+
+   /// Number of workers that gave their result for the last cube.
+   size_t nJoined;
+
+   /// First SAT or UNSAT result for the last cube.
+   SatResult result;
+
+   /// Model or final analysis of the result.
+   vector<int> resultModel;
+};
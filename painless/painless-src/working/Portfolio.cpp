@@ -17,6 +17,7 @@
 // this program.  If not, see <http://www.gnu.org/licenses/>.
 // -----------------------------------------------------------------------------
 
+#include "../painless.h"
 #include "../utils/Parameters.h"
 #include "../utils/Logger.h"
 #include "../working/Portfolio.h"
@@ -40,9 +41,13 @@ Portfolio::solve(const vector<int> & cube)
 {
    strategyEnding = false;
 
+   slavesLock.lock();
+
    for (size_t i = 0; i < slaves.size(); i++) {
       slaves[i]->solve(cube);
    }
+
+   slavesLock.unlock();
 }
 
 void
@@ -57,12 +62,7 @@ Portfolio::join(WorkingStrategy * strat, SatResult res,
    setInterrupt();         
 
    if (parent == NULL) { // If it is the top strategy
-      globalEnding = true;
-      finalResult  = res;
-
-      if (res == SAT) {
-         finalModel = model;
-      }
+      setFinalResult(res, model);
       SequentialWorker *winner = (SequentialWorker*)strat;
       // log(0, "The winner is thread %d \\o/ !!!\n", winner->solver->id);
    } else { // Else forward the information to the parent strategy
@@ -73,25 +73,37 @@ Portfolio::join(WorkingStrategy * strat, SatResult res,
 void
 Portfolio::setInterrupt()
 {
+   slavesLock.lock();
+
    for (size_t i = 0; i < slaves.size(); i++) {
       slaves[i]->setInterrupt();
    }
+
+   slavesLock.unlock();
 }
 
 void
 Portfolio::unsetInterrupt()
 {
+   slavesLock.lock();
+
    for (size_t i = 0; i < slaves.size(); i++) {
       slaves[i]->unsetInterrupt();
    }
+
+   slavesLock.unlock();
 }
 
 void
 Portfolio::waitInterrupt()
 {
+   slavesLock.lock();
+
    for (size_t i = 0; i < slaves.size(); i++) {
       slaves[i]->waitInterrupt();
    }
+
+   slavesLock.unlock();
 }
 
 int
@@ -103,9 +115,23 @@ Portfolio::getDivisionVariable()
 void
 Portfolio::setPhase(int var, bool value)
 {
+   slavesLock.lock();
+
+   for (size_t i = 0; i < slaves.size(); i++) {
+      slaves[i]->setPhase(var, value);
+   }
+
+   slavesLock.unlock();
 }
 
 void
 Portfolio::bumpVariableActivity(int var, int times)
 {
+   slavesLock.lock();
+
+   for (size_t i = 0; i < slaves.size(); i++) {
+      slaves[i]->bumpVariableActivity(var, times);
+   }
+
+   slavesLock.unlock();
 }
@@ -0,0 +1,374 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#include "../painless.h"
+#include "../utils/Logger.h"
+#include "../utils/System.h"
+#include "../working/ProcessGroup.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <new>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+// Time in useconds between two checks of the end by a child
+#define WATCH_PERIOD 10000
+
+// Time in useconds given to the children to stop before they are killed
+#define STOP_DELAY 2000000
+
+// Write a whole buffer, return false if failed
+static bool writeAll(int fd, const void * buf, size_t size)
+{
+   const char * p = (const char *)buf;
+
+   while (size > 0) {
+      ssize_t n = write(fd, p, size);
+
+      if (n < 0 && errno == EINTR)
+         continue;
+
+      if (n <= 0)
+         return false;
+
+      p    += n;
+      size -= n;
+   }
+
+   return true;
+}
+
+// Read a whole buffer, return false if the end is reached before
+static bool readAll(int fd, void * buf, size_t size)
+{
+   char * p = (char *)buf;
+
+   while (size > 0) {
+      ssize_t n = read(fd, p, size);
+
+      if (n < 0 && errno == EINTR)
+         continue;
+
+      if (n <= 0)
+         return false;
+
+      p    += n;
+      size -= n;
+   }
+
+   return true;
+}
+
+// Size rounded to a cache line
+static size_t alignSize(size_t size)
+{
+   return (size + 63) / 64 * 64;
+}
+
+// Main executed by the thread of a child watching the end of the group
+void * mainProcessGroup(void * arg)
+{
+   ProcessGroup * group = (ProcessGroup *)arg;
+
+   pid_t parent = getppid();
+
+   // The child also stops if its parent has died
+   while (waitGlobalEnding(WATCH_PERIOD) == false) {
+      if (group->shared->ending || getppid() != parent)
+         break;
+   }
+
+   setGlobalEnding();
+
+   return NULL;
+}
+
+ProcessGroup::ProcessGroup(int nProcesses, size_t ringSize)
+{
+   this->nProcesses = nProcesses;
+
+   index   = -1;
+   shared  = NULL;
+   watcher = NULL;
+
+   // The memory is unlinked at once, the children inherit the mapping
+   size_t ringBytes = alignSize(ClauseRing::memorySize(ringSize));
+   size_t size      = alignSize(sizeof(Shared)) + nProcesses * ringBytes;
+
+   char name[64];
+   snprintf(name, sizeof(name), "/painless-%d", (int)getpid());
+
+   int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+
+   if (fd < 0)
+      return;
+
+   void * memory = MAP_FAILED;
+
+   if (ftruncate(fd, size) == 0) {
+      memory = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   }
+
+   shm_unlink(name);
+   close(fd);
+
+   if (memory == MAP_FAILED)
+      return;
+
+   shared         = new (memory) Shared();
+   shared->ending = false;
+
+   char * p = (char *)memory + alignSize(sizeof(Shared));
+
+   for (int i = 0; i < nProcesses; i++) {
+      rings.push_back(ClauseRing::init(p + i * ringBytes, ringSize));
+   }
+}
+
+bool
+ProcessGroup::start()
+{
+   if (shared == NULL)
+      return false;
+
+   fflush(stdout);
+
+   for (int i = 0; i < nProcesses; i++) {
+      int fds[2];
+
+      if (pipe(fds) != 0)
+         break;
+
+      pid_t pid = fork();
+
+      if (pid < 0) {
+         close(fds[0]);
+         close(fds[1]);
+         break;
+      }
+
+      if (pid == 0) {
+         // The child only keeps the write end of its pipe
+         for (size_t j = 0; j < pipes.size(); j++) {
+            close(pipes[j]);
+         }
+
+         close(fds[0]);
+
+         pipes.assign(1, fds[1]);
+         pids.clear();
+
+         index = i;
+
+         // The parent may close the pipe once it has a result
+         signal(SIGPIPE, SIG_IGN);
+
+         watcher = new Thread(mainProcessGroup, this);
+
+         return true;
+      }
+
+      close(fds[1]);
+
+      pipes.push_back(fds[0]);
+      pids.push_back(pid);
+   }
+
+   if (pids.empty())
+      return false;
+
+   log(1, "ProcessGroup started %d processes\n", (int)pids.size());
+
+   return true;
+}
+
+void
+ProcessGroup::supervise(double timeout)
+{
+   vector<pollfd> fds;
+   vector<int> children;
+
+   while (finalResult == UNKNOWN) {
+      fds.clear();
+      children.clear();
+
+      for (size_t i = 0; i < pipes.size(); i++) {
+         if (pipes[i] < 0)
+            continue;
+
+         pollfd pfd;
+         pfd.fd     = pipes[i];
+         pfd.events = POLLIN;
+
+         fds.push_back(pfd);
+         children.push_back(i);
+      }
+
+      // Every child has ended
+      if (fds.empty())
+         break;
+
+      int wait = -1;
+
+      if (timeout > 0) {
+         double left = timeout - getRelativeTime();
+
+         if (left <= 0)
+            break;
+
+         wait = left * 1000 + 1;
+      }
+
+      if (poll(fds.data(), fds.size(), wait) <= 0)
+         continue;
+
+      for (size_t i = 0; i < fds.size(); i++) {
+         if (fds[i].revents == 0)
+            continue;
+
+         int child = children[i];
+
+         if (readResult(child) == false) {
+            int status = 0;
+
+            waitpid(pids[child], &status, 0);
+            pids[child] = -1;
+
+            if (WIFSIGNALED(status)) {
+               log(0, "ProcessGroup process %d killed by signal %d, the "
+                   "others go on\n", child, WTERMSIG(status));
+            } else {
+               log(0, "ProcessGroup process %d exited with status %d "
+                   "without result\n", child, WEXITSTATUS(status));
+            }
+         }
+
+         close(pipes[child]);
+         pipes[child] = -1;
+
+         if (finalResult != UNKNOWN)
+            break;
+      }
+   }
+
+   stopChildren();
+}
+
+bool
+ProcessGroup::readResult(int child)
+{
+   int header[2];
+
+   if (readAll(pipes[child], header, sizeof(header)) == false)
+      return false;
+
+   SatResult res = (SatResult)header[0];
+
+   if (res == SAT) {
+      vector<int> model(header[1]);
+
+      if (readAll(pipes[child], model.data(), sizeof(int) * model.size()) ==
+          false)
+         return false;
+
+      finalModel = model;
+   }
+
+   if (res == SAT || res == UNSAT) {
+      finalResult = res;
+
+      log(1, "ProcessGroup process %d has the result\n", child);
+   }
+
+   return true;
+}
+
+void
+ProcessGroup::stopChildren()
+{
+   shared->ending = true;
+
+   for (int waited = 0; waited < STOP_DELAY; waited += WATCH_PERIOD) {
+      bool running = false;
+
+      for (size_t i = 0; i < pids.size(); i++) {
+         if (pids[i] > 0 && waitpid(pids[i], NULL, WNOHANG) == pids[i])
+            pids[i] = -1;
+
+         running = running || pids[i] > 0;
+      }
+
+      if (running == false)
+         break;
+
+      usleep(WATCH_PERIOD);
+   }
+
+   for (size_t i = 0; i < pids.size(); i++) {
+      if (pids[i] > 0) {
+         kill(pids[i], SIGKILL);
+         waitpid(pids[i], NULL, 0);
+         pids[i] = -1;
+      }
+
+      if (pipes[i] >= 0) {
+         close(pipes[i]);
+         pipes[i] = -1;
+      }
+   }
+}
+
+void
+ProcessGroup::sendResult()
+{
+   int header[2] = { finalResult, (int)finalModel.size() };
+
+   if (writeAll(pipes[0], header, sizeof(header)) && finalResult == SAT) {
+      writeAll(pipes[0], finalModel.data(), sizeof(int) * finalModel.size());
+   }
+
+   close(pipes[0]);
+   pipes[0] = -1;
+}
+
+int
+ProcessGroup::getCount()
+{
+   return nProcesses;
+}
+
+int
+ProcessGroup::getIndex()
+{
+   return index;
+}
+
+ClauseRing *
+ProcessGroup::getRing(int index)
+{
+   return rings[index];
+}
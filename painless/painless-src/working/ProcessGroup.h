@@ -0,0 +1,105 @@
+// -----------------------------------------------------------------------------
+// Copyright (C) 2017  Ludovic LE FRIOUX
+//
+// This file is part of PaInleSS.
+//
+// PaInleSS is free software: you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation, either version 3 of the License, or (at your option) any later
+// version.
+//
+// This program is distributed in the hope that it will be useful, but WITHOUT
+// ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License along with
+// this program.  If not, see <http://www.gnu.org/licenses/>.
+// -----------------------------------------------------------------------------
+
+
+#pragma once
+
+#include "../clauses/ClauseRing.h"
+#include "../utils/Threading.h"
+
+#include <atomic>
+#include <sys/types.h>
+#include <vector>
+
+using namespace std;
+
+// Main executed by the thread of a child watching the end of the group
+static void * mainProcessGroup(void * arg);
+
+/// Group of processes running the solvers, each one with its own address
+/// space and allocator. The parent forks the children and supervises them:
+/// it collects the first result, survives the crash of a child, and stops
+/// the others. Each child writes the clauses it shares in its own ring of a
+/// POSIX shared memory and reads the rings of the others.
+class ProcessGroup
+{
+public:
+   /// Constructor, ringSize is the number of ints of the ring of a child.
+   ProcessGroup(int nProcesses, size_t ringSize);
+
+   /// Fork the children, before any thread is created. The index of the
+   /// process is then given by getIndex. Return false if failed.
+   bool start();
+
+   /// In the parent, wait for the first result, the end of every child or
+   /// the timeout, then stop the children. The result is in finalResult
+   /// and finalModel.
+   void supervise(double timeout);
+
+   /// In a child, give the result of the search to the parent.
+   void sendResult();
+
+   /// Number of children.
+   int getCount();
+
+   /// Index of the process, -1 in the parent.
+   int getIndex();
+
+   /// Ring of a child.
+   ClauseRing * getRing(int index);
+
+protected:
+   friend void * mainProcessGroup(void * arg);
+
+   /// Header of the shared memory, followed by the rings.
+   struct Shared
+   {
+      /// Set by the parent to stop the children.
+      atomic<bool> ending;
+   };
+
+   /// Read the result of a child, return false if the child has ended
+   /// without giving one.
+   bool readResult(int child);
+
+   /// Stop the children, kill the ones still running after a delay.
+   void stopChildren();
+
+   /// Number of children.
+   int nProcesses;
+
+   /// Index of the process, -1 in the parent.
+   int index;
+
+   /// Shared memory.
+   Shared * shared;
+
+   /// Rings of the children in the shared memory.
+   vector<ClauseRing *> rings;
+
+   /// Pid of each child.
+   vector<pid_t> pids;
+
+   /// Read end of the pipe of each child in the parent, write end of its
+   /// own pipe in a child, -1 once closed.
+   vector<int> pipes;
+
+   /// Thread of a child watching the end of the group.
+   Thread * watcher;
+};
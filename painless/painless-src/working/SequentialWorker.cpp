@@ -17,6 +17,7 @@
 // this program.  If not, see <http://www.gnu.org/licenses/>.
 // -----------------------------------------------------------------------------
 
+#include "../painless.h"
 #include "../utils/Logger.h"
 #include "../working/SequentialWorker.h"
 
@@ -32,33 +33,50 @@ void * mainWorker(void *arg)
    SatResult res = UNKNOWN;
 
    vector<int> model;
+   vector<int> cube;
 
-   while (globalEnding == false && sq->force == false) {
+   while (globalEnding == false) {
       pthread_mutex_lock(&sq->mutexStart);
 
-      if (sq->waitJob == true) {
+      while (sq->waitJob == true && sq->stopWorker == false &&
+             globalEnding == false) {
          pthread_cond_wait(&sq->mutexCondStart, &sq->mutexStart);
       }
 
+      // Each job is consumed once and gives exactly one result
+      sq->waitJob = true;
+      cube        = sq->actualCube;
+
+      // The job is pending until its result has been joined
+      sq->joinLock.lock();
+
       pthread_mutex_unlock(&sq->mutexStart);
 
+      if (sq->stopWorker || globalEnding) {
+         sq->joinLock.unlock();
+         break;
+      }
+
       sq->waitInterruptLock.lock();
 
       do {
-         res = sq->solver->solve(sq->actualCube);
+         res = sq->solver->solve(cube);
       } while (sq->force == false && res == UNKNOWN);
 
-      sq->waitInterruptLock.unlock();
-
+      // The solver may be replaced once the lock is released
       if (res == SAT) {
          model = sq->solver->getModel();
+      } else if (res == UNSAT) {
+         model = sq->solver->getFinalAnalysis();
       }
 
+      sq->waitInterruptLock.unlock();
+
       sq->join(NULL, res, model);
 
-      model.clear();
+      sq->joinLock.unlock();
 
-      sq->waitJob = true;
+      model.clear();
    }
 
    return NULL;
@@ -67,9 +85,10 @@ void * mainWorker(void *arg)
 // Constructor
 SequentialWorker::SequentialWorker(SolverInterface * solver_)
 {
-   solver  = solver_;
-   force   = false;
-   waitJob = true;
+   solver     = solver_;
+   force      = false;
+   waitJob    = true;
+   stopWorker = false;
 
    pthread_mutex_init(&mutexStart, NULL);
    pthread_cond_init (&mutexCondStart, NULL);
@@ -82,6 +101,11 @@ SequentialWorker::~SequentialWorker()
 {
    setInterrupt();
 
+   pthread_mutex_lock  (&mutexStart);
+   stopWorker = true;
+   pthread_cond_signal (&mutexCondStart);
+   pthread_mutex_unlock(&mutexStart);
+
    worker->join();
    delete worker;
 
@@ -94,13 +118,11 @@ SequentialWorker::~SequentialWorker()
 void
 SequentialWorker::solve(const vector<int> & cube)
 {
-   actualCube = cube;
-   
    unsetInterrupt();
 
-   waitJob = false;
-
    pthread_mutex_lock  (&mutexStart);
+   actualCube = cube;
+   waitJob    = false;
    pthread_cond_signal (&mutexCondStart);
    pthread_mutex_unlock(&mutexStart);
 }
@@ -115,12 +137,7 @@ SequentialWorker::join(WorkingStrategy * winner, SatResult res,
       return;
 
    if (parent == NULL) {
-      globalEnding = true;
-      finalResult  = res;
-
-      if (res == SAT) {
-         finalModel = model;
-      }
+      setFinalResult(res, model);
    } else {
       parent->join(this, res, model);
    }
@@ -133,6 +150,18 @@ SequentialWorker::waitInterrupt()
    waitInterruptLock.unlock();
 }
 
+void
+SequentialWorker::waitJoin()
+{
+   // A job that is not started yet is dropped
+   pthread_mutex_lock  (&mutexStart);
+   waitJob = true;
+   pthread_mutex_unlock(&mutexStart);
+
+   joinLock.lock();
+   joinLock.unlock();
+}
+
 void
 SequentialWorker::setInterrupt()
 {
@@ -47,6 +47,10 @@ public:
    void unsetInterrupt();
 
    void waitInterrupt();
+
+   /// Drop the job not started yet, and wait until the result of the running
+   /// one has been joined. The parent can then be changed safely.
+   void waitJoin();
    
    int getDivisionVariable();
 
@@ -67,8 +71,13 @@ protected:
    
    atomic<bool> waitJob;
 
+   atomic<bool> stopWorker;
+
    Mutex waitInterruptLock;
 
+   /// Held from the start of a job until its result has been joined.
+   Mutex joinLock;
+
    pthread_mutex_t mutexStart;
    pthread_cond_t  mutexCondStart;
 };
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "../solvers/SolverInterface.h"
+#include "../utils/Threading.h"
 
 #include <vector>
 
@@ -40,6 +41,11 @@ public:
       parent = NULL;
    }
 
+   /// Deleting a strategy through its parent deletes the actual strategy.
+   virtual ~WorkingStrategy()
+   {
+   }
+
    virtual void solve (const vector<int> & cube) = 0;
 
    virtual void join(WorkingStrategy * winner, SatResult res,
@@ -59,12 +65,32 @@ public:
 
    virtual void addSlave(WorkingStrategy * slave)
    {
-     slaves.push_back(slave);
-     slave->parent = this;
+      slavesLock.lock();
+      slaves.push_back(slave);
+      slave->parent = this;
+      slavesLock.unlock();
+   }
+
+   /// Remove a slave, its parent is kept until it is added elsewhere.
+   virtual void removeSlave(WorkingStrategy * slave)
+   {
+      slavesLock.lock();
+
+      for (size_t i = 0; i < slaves.size(); i++) {
+         if (slaves[i] == slave) {
+            slaves.erase(slaves.begin() + i);
+            break;
+         }
+      }
+
+      slavesLock.unlock();
    }
 
 protected:
    WorkingStrategy * parent;
 
    vector<WorkingStrategy *> slaves;
+
+   /// Slaves may be added or removed while the other threads iterate them.
+   Mutex slavesLock;
 };